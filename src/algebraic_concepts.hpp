@@ -87,11 +87,21 @@ namespace eop
     template <typename T, typename Op, T identity>
     concept commutative_monoid = monoid<T, Op, identity> && commutative_operation<Op>;
 
+    // The identity is not passed as template argument, so types that can't be non type template 
+    // parameters (like BigInteger) can model additive and multiplicative monoids.
     template <typename T>
-    concept additive_monoid = commutative_monoid<T, plus<T>, T{0}>;
+    concept additive_monoid = additive_semigroup<T> && requires (T a, plus<T> op)
+    {
+        {op(a, T{0})}; // returns a
+        {op(T{0}, a)}; // returns a
+    };
 
     template <typename T>
-    concept multiplicative_monoid = monoid<T, multiply<T>, T{1}>;
+    concept multiplicative_monoid = multiplicative_semigroup<T> && requires (T a, multiply<T> op)
+    {
+        {op(a, T{1})}; // returns a
+        {op(T{1}, a)}; // returns a
+    };
 
 
     template <typename T, typename Op, typename InverseOp, T identity>
@@ -185,9 +195,9 @@ namespace eop
     template <typename T>
     concept archimedean_monoid = cancellable_monoid<T> && requires (T a, T b)
     {
-        // Has quotient type = int
+        // Has an integral quotient type (T itself for the integers)
         typename quotient_type_t<T>;
-        requires std::signed_integral<quotient_type_t<T>>;
+        requires std::integral<quotient_type_t<T>>;
         
         // for every a >= 0 and b > 0 requires slow_remainder(a, b) to terminate. 
     };
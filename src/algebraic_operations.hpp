@@ -23,7 +23,7 @@ namespace eop
     template <regular T>
     struct plus
     {
-        T operator+(const T& a, const T& b)
+        T operator()(const T& a, const T& b)
         {
             return a + b;
         }
@@ -34,7 +34,7 @@ namespace eop
     template <regular T>
     struct multiply
     {
-        T operator*(const T& a, const T& b)
+        T operator()(const T& a, const T& b)
         {
             return a * b;
         }
@@ -44,19 +44,19 @@ namespace eop
     template <regular T>
     struct minus
     {
-        T operator-(const T& a, const T& b)
+        T operator()(const T& a, const T& b)
         {
             return a - b;
         }
 
-        T operator-(const T& a)
+        T operator()(const T& a)
         {
             return -a;
         }
 
         T inverse(const T& a)
         {
-            return operator-(a);
+            return -a;
         }
     };
 
@@ -64,7 +64,7 @@ namespace eop
     template <regular T>
     struct divide
     {
-        T operator/(const T& a, const T& b)
+        T operator()(const T& a, const T& b)
         {
             return a / b;
         }
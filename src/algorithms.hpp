@@ -341,7 +341,7 @@ namespace eop
 
 
     // Precondition: readable_bounded_range(f, l)
-    template <readable_iterator I, unary_predicate P, iterator J>
+    template <readable_iterator I, unary_predicate P, std::weakly_incrementable J>
         requires std::same_as<domain_t<P>, value_type_t<I>>
     constexpr
     J count_if(I f, I l, P p, J j)
@@ -369,7 +369,7 @@ namespace eop
 
 
     // Precondition: readable_weak_range(f, n)
-    template <readable_iterator I, unary_predicate P, iterator J>
+    template <readable_iterator I, unary_predicate P, std::weakly_incrementable J>
         requires std::same_as<domain_t<P>, value_type_t<I>>
     constexpr
     Pair<I, J> count_if_n(I f, distance_type_t<I> n, P p, J j)
@@ -398,7 +398,7 @@ namespace eop
 
 
     // Precondition: readable_bounded_range(f, l)
-    template <readable_iterator I, unary_predicate P, iterator J>
+    template <readable_iterator I, unary_predicate P, std::weakly_incrementable J>
         requires std::same_as<domain_t<P>, value_type_t<I>>
     constexpr
     J count_if_not(I f, I l, P p, J j)
@@ -416,7 +416,7 @@ namespace eop
 
 
     // Precondition: readable_weak_range(f, n)
-    template <readable_iterator I, unary_predicate P, iterator J>
+    template <readable_iterator I, unary_predicate P, std::weakly_incrementable J>
         requires std::same_as<domain_t<P>, value_type_t<I>>
     constexpr
     Pair<I, J> count_if_not_n(I f, distance_type_t<I> n, P p, J j)
@@ -427,7 +427,7 @@ namespace eop
             {
                 ++j;
             }
-            --n
+            --n;
             ++f;
         }
         return Pair<I, J>{f, j};
@@ -435,66 +435,62 @@ namespace eop
 
 
     // Precondition: readable_bounded_range(f, l)
-    template <readable_iterator I, unary_predicate P>
-        requires std::same_as<domain_t<P>, value_type_t<I>>
+    template <readable_iterator I>
     constexpr
     distance_type_t<I> count(I f, I l, const value_type_t<I>& x)
     {
         return count_if(f, l, 
-            [&x](const value_type_t<I>& i) { return i == x }, 
+            [&x](const value_type_t<I>& i) { return i == x; }, 
             distance_type_t<I>{0});
     }
 
 
     // Precondition: readable_weak_range(f, n)
-    template <readable_iterator I, unary_predicate P>
-        requires std::same_as<domain_t<P>, value_type_t<I>>
+    template <readable_iterator I>
     constexpr
     Pair<I, distance_type_t<I>> count_n(I f, distance_type_t<I> n, const value_type_t<I>& x)
     {
         return count_if_n(f, n, 
-            [&x](const value_type_t<I>& i) { return i == x }, 
+            [&x](const value_type_t<I>& i) { return i == x; }, 
             distance_type_t<I>{0});
     }
 
 
     // Precondition: readable_bounded_range(f, l)
-    template <readable_iterator I, unary_predicate P>
-        requires std::same_as<domain_t<P>, value_type_t<I>>
+    template <readable_iterator I>
     constexpr
     distance_type_t<I> count_not(I f, I l, const value_type_t<I>& x)
     {
         return count_if_not(f, l, 
-            [&x](const value_type_t<I>& i) { return i == x }, 
+            [&x](const value_type_t<I>& i) { return i == x; }, 
             distance_type_t<I>{0});
     }
 
 
     // Precondition: readable_weak_range(f, n)
-    template <readable_iterator I, unary_predicate P>
-        requires std::same_as<domain_t<P>, value_type_t<I>>
+    template <readable_iterator I>
     constexpr
-    Pair<I, distance_type_t<I>> count_not_n(I f, distance_type_t<I> n)
+    Pair<I, distance_type_t<I>> count_not_n(I f, distance_type_t<I> n, const value_type_t<I>& x)
     {
         return count_if_not_n(f, n, 
-            [&x](const value_type_t<I>& i) { return i == x }, 
+            [&x](const value_type_t<I>& i) { return i == x; }, 
             distance_type_t<I>{0});
     }
 
 
     // Precondition: bounded_range(f, l)
     // Precondition: partially_associative(op)
-    // Precondition: for every i £ [f, l), fun(i) is defined
-    template <iterator I, binary_operation Op, unary_procedure F>
+    // Precondition: for every i £ [f, l), fun(*i) is defined
+    template <readable_iterator I, binary_operation Op, unary_procedure F>
         requires std::same_as<value_type_t<I>, domain_t<F>> && std::same_as<domain_t<Op>, codomain_t<F>>
     constexpr
     domain_t<Op> reduce_nonempty(I f, I l, Op op, F fun)
     {
-        domain_t<Op> r = fun(f);
+        domain_t<Op> r = fun(*f);
         ++f;
         while (f != l)
         {
-            r = op(r, fun(f));
+            r = op(r, fun(*f));
             ++f;
         }
         return r;
@@ -503,18 +499,18 @@ namespace eop
 
     // Precondition: weak_range(f, n)
     // Precondition: partially_associative(op)
-    // Precondition: for every 0 <= i <= n, fun(successor^i(f)) is defined
-    template <iterator I, binary_operation Op, unary_procedure F>
+    // Precondition: for every 0 <= i < n, fun(*successor^i(f)) is defined
+    template <readable_iterator I, binary_operation Op, unary_procedure F>
         requires std::same_as<value_type_t<I>, domain_t<F>> && std::same_as<domain_t<Op>, codomain_t<F>>
     constexpr
     Pair<I, domain_t<Op>> reduce_nonempty_n(I f, distance_type_t<I> n, Op op, F fun)
     {
-        domain_t<Op> r = fun(f);
-        --n
+        domain_t<Op> r = fun(*f);
+        --n;
         ++f;
         while (!Integer::is_zero(n))
         {
-            r = op(r, fun(f));
+            r = op(r, fun(*f));
             --n;
             ++f;
         }
@@ -524,9 +520,9 @@ namespace eop
 
     // Precondition: bounded_range(f, l)
     // Precondition: partially_associative(op)
-    // Precondition: for every i £ [f, l), fun(i) is defined
+    // Precondition: for every i £ [f, l), fun(*i) is defined
     // Precondition: z is the identity element returned in case of f == l.
-    template <iterator I, binary_operation Op, unary_procedure F>
+    template <readable_iterator I, binary_operation Op, unary_procedure F>
         requires std::same_as<value_type_t<I>, domain_t<F>> && std::same_as<domain_t<Op>, codomain_t<F>>
     constexpr
     domain_t<Op> reduce(I f, I l, Op op, F fun, const domain_t<Op>& z)
@@ -542,9 +538,9 @@ namespace eop
 
     // Precondition: weak_range(f, n)
     // Precondition: partially_associative(op)
-    // Precondition: for every 0 <= i <= n, fun(successor^i(f)) is defined
+    // Precondition: for every 0 <= i < n, fun(*successor^i(f)) is defined
     // Precondition: z is the identity element returned in case of f == l.
-    template <iterator I, binary_operation Op, unary_procedure F>
+    template <readable_iterator I, binary_operation Op, unary_procedure F>
         requires std::same_as<value_type_t<I>, domain_t<F>> && std::same_as<domain_t<Op>, codomain_t<F>>
     constexpr
     Pair<I, domain_t<Op>> reduce_n(I f, distance_type_t<I> n, Op op, F fun, const domain_t<Op>& z)
@@ -560,9 +556,9 @@ namespace eop
 
     // Precondition: bounded_range(f, l)
     // Precondition: partially_associative(op)
-    // Precondition: for every i £ [f, l), fun(i) is defined
+    // Precondition: for every i £ [f, l), fun(*i) is defined
     // Precondition: z is the identity element.
-    template <iterator I, binary_operation Op, unary_procedure F>
+    template <readable_iterator I, binary_operation Op, unary_procedure F>
         requires std::same_as<value_type_t<I>, domain_t<F>> && std::same_as<domain_t<Op>, codomain_t<F>>
     constexpr
     domain_t<Op> reduce_nonzeros(I f, I l, Op op, F fun, const domain_t<Op>& z)
@@ -575,14 +571,14 @@ namespace eop
                 return z;
             }
 
-            x = fun(x);
+            x = fun(*f);
             ++f;
         } while (x == z);
 
 
         while (f != l)
         {
-            domain_t<Op> y = fun(f);
+            domain_t<Op> y = fun(*f);
             if (y != z)
             {
                 x = op(x, y);
@@ -596,9 +592,9 @@ namespace eop
 
     // Precondition: weak_range(f, n)
     // Precondition: partially_associative(op)
-    // Precondition: for every 0 <= i <= n, fun(successor^i(f)) is defined
+    // Precondition: for every 0 <= i < n, fun(*successor^i(f)) is defined
     // Precondition: z is the identity element.
-    template <iterator I, binary_operation Op, unary_procedure F>
+    template <readable_iterator I, binary_operation Op, unary_procedure F>
         requires std::same_as<value_type_t<I>, domain_t<F>> && std::same_as<domain_t<Op>, codomain_t<F>>
     constexpr
     Pair<I, domain_t<Op>> reduce_nonzeros_n(I f, distance_type_t<I> n, Op op, F fun, const domain_t<Op>& z)
@@ -611,15 +607,15 @@ namespace eop
                 return Pair<I, domain_t<Op>>{f, z};
             }
 
-            x = fun(x);
+            x = fun(*f);
             --n;
             ++f;
         } while (x == z);
 
 
-        while (Integer::is_zero(n))
+        while (!Integer::is_zero(n))
         {
-            domain_t<Op> y = fun(f);
+            domain_t<Op> y = fun(*f);
             if (y != z)
             {
                 x = op(x, y);
@@ -661,7 +657,7 @@ namespace eop
         requires std::same_as<value_type_t<I0>, value_type_t<I1>> && 
                 std::same_as<value_type_t<I0>, domain_t<R>>
     constexpr 
-    Pair<I0, I1> find_mismatch_n0(I0 f0, distance_type_t<I0>, I1 f1, I1 l1, R r)
+    Pair<I0, I1> find_mismatch_n0(I0 f0, distance_type_t<I0> n, I1 f1, I1 l1, R r)
     {
         while (!Integer::is_zero(n) && f1 != l1 && r(*f0, *f1))
         {
@@ -871,7 +867,7 @@ namespace eop
     template <readable_iterator I, unary_predicate P> 
         requires std::same_as<value_type_t<I>, domain_t<P>>
     constexpr
-    bool partitioned(I f, I l, P r)
+    bool partitioned(I f, I l, P p)
     {
         return l == find_if_not(find_if(f, l, p), l, p);
     }
@@ -880,7 +876,7 @@ namespace eop
     template <readable_iterator I, unary_predicate P> 
         requires std::same_as<value_type_t<I>, domain_t<P>>
     constexpr
-    bool partitioned_n(I f, distance_type_t<I> n, P r)
+    bool partitioned_n(I f, distance_type_t<I> n, P p)
     {
         auto res_f = find_if_n(f, n, p);
 
@@ -925,11 +921,11 @@ namespace eop
     }
 
 
-    // Precondition: readable_bounded_range(f, n) && partitioned_n(f, n, p)
+    // Precondition: readable_bounded_range(f, l) && partitioned(f, l, p)
     template <forward_iterator I, unary_predicate P>
         requires std::same_as<value_type_t<I>, domain_t<P>>
     constexpr
-    I partition_point(I f, distance_type_t<I> n, P p)
+    I partition_point(I f, I l, P p)
     {
         return partition_point_n(f, l - f, p);
     }
@@ -5,13 +5,31 @@
 /*
 associative_operations.hpp
 
-PURPOSE:
-
-
+PURPOSE: power of an element under an associative operation.
+
+CLASSES:
+    AdditionChain: sequence 1 = e0 < ... < en = n where each ei is the sum of 2 previous elements.
+    AssociativeOp: power algorithms.
+
+DESCRIPTION:
+The binary power algorithm does floor(log2(n)) + popcount(n) - 1 operations. When op is expensive 
+(bignum or matrix multiply) it is worth to spend time to find a shorter addition chain for n:
+each element of the chain is one application of op.
+    - power<N>: N known at compile time, the chain is computed by constexpr code (optimal for 
+      N < 128, sliding window otherwise) and the evaluation is unrolled.
+    - power_chain: the chain is computed once at runtime and reused for many bases.
+    - power_sliding_window: left to right sliding window with a table of the odd powers.
+    - power_many: power of many bases with the same exponent.
 
 */
 
+#include <array>
+#include <bit>
 #include <concepts> 
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 
 #include "utility_concepts.hpp"
 #include "function_concepts.hpp"
@@ -20,6 +38,263 @@ PURPOSE:
 
 namespace eop
 {
+    // Addition chain for n with the slots needed to evaluate it.
+    // Step k computes e[k] = e[lhs[k]] + e[rhs[k]], that is a^e[k] = op(a^e[lhs[k]], a^e[rhs[k]]).
+    // The value of a^e[k] is stored in slot[k]; slots are reused when a value is not needed anymore,
+    // so the evaluation needs only registers values of the domain.
+    struct AdditionChain
+    {
+        static constexpr std::size_t max_length = 192;
+
+        std::array<std::uint64_t, max_length> e{1};
+        std::array<std::uint8_t, max_length> lhs{};
+        std::array<std::uint8_t, max_length> rhs{};
+        std::array<std::uint8_t, max_length> slot{};
+        std::size_t length = 1;
+        std::size_t registers = 1;
+
+
+        // Number of applications of op.
+        constexpr
+        std::size_t operations() const
+        {
+            return length - 1;
+        }
+
+        constexpr
+        std::uint64_t back() const
+        {
+            return e[length - 1];
+        }
+
+        constexpr
+        void push(std::size_t i, std::size_t j)
+        {
+            e[length] = e[i] + e[j];
+            lhs[length] = static_cast<std::uint8_t>(i);
+            rhs[length] = static_cast<std::uint8_t>(j);
+            ++length;
+        }
+
+        constexpr
+        void pop()
+        {
+            --length;
+        }
+
+
+        // Precondition: n > 0.
+        // Shortest star chain (e[k] = e[k - 1] + e[j]) by iterative deepening.
+        // Star chains are optimal for every n < 12509.
+        [[nodiscard]]
+        static constexpr
+        AdditionChain optimal(std::uint64_t n)
+        {
+            AdditionChain c;
+            std::size_t limit = std::bit_width(n);
+            while (!c.search_star(n, limit))
+            {
+                ++limit;
+            }
+            c.allocate_slots();
+            return c;
+        }
+
+
+        // Precondition: n > 0 && 1 <= k <= 6.
+        // Left to right sliding window of k bits. The table contains a^2 and the odd powers up to a^(2^k - 1).
+        [[nodiscard]]
+        static constexpr
+        AdditionChain sliding_window(std::uint64_t n, int k)
+        {
+            AdditionChain c;
+            // odd[w / 2] is the index of e = w for odd w.
+            std::array<std::uint8_t, 32> odd{0};
+            if (k > 1)
+            {
+                c.push(0, 0);
+                std::size_t square = c.length - 1;
+                for (std::size_t w = 1; w < (std::size_t{1} << (k - 1)); ++w)
+                {
+                    c.push(odd[w - 1], square);
+                    odd[w] = static_cast<std::uint8_t>(c.length - 1);
+                }
+            }
+
+            int i = std::bit_width(n) - 1;
+            std::size_t acc = 0;
+            bool first = true;
+            while (i >= 0)
+            {
+                if (((n >> i) & 1) == 0)
+                {
+                    c.push(acc, acc);
+                    acc = c.length - 1;
+                    --i;
+                    continue;
+                }
+
+                // Longest window [i, j] with at most k bits that ends with a 1.
+                int j = i - k + 1 < 0 ? 0 : i - k + 1;
+                while (((n >> j) & 1) == 0)
+                {
+                    ++j;
+                }
+                std::uint64_t w = (n >> j) & ((std::uint64_t{1} << (i - j + 1)) - 1);
+
+                if (first)
+                {
+                    acc = odd[w / 2];
+                    first = false;
+                }
+                else
+                {
+                    for (int s = j; s <= i; ++s)
+                    {
+                        c.push(acc, acc);
+                        acc = c.length - 1;
+                    }
+                    c.push(acc, odd[w / 2]);
+                    acc = c.length - 1;
+                }
+                i = j - 1;
+            }
+            c.length = acc + 1;
+            c.remove_unused();
+            c.allocate_slots();
+            return c;
+        }
+
+
+        // Window size that minimizes the expected number of operations for an exponent of b bits:
+        // b - 1 squarings, 2^(k - 1) operations for the table and one operation each k + 1 bits.
+        // The costs are scaled by 420 = lcm(2, ..., 7) to stay on integers.
+        [[nodiscard]]
+        static constexpr
+        int window_size(int b)
+        {
+            int best = 1;
+            int best_cost = 420 * (b - 1) + 420 * b / 2;
+            for (int k = 2; k <= 6; ++k)
+            {
+                int cost = 420 * (b - 1) + 420 * (1 << (k - 1)) + 420 * b / (k + 1);
+                if (cost < best_cost)
+                {
+                    best = k;
+                    best_cost = cost;
+                }
+            }
+            return best;
+        }
+
+
+        // Precondition: n > 0.
+        // The search of the optimal chain is exponential, it is used only for small n.
+        [[nodiscard]]
+        static constexpr
+        AdditionChain make(std::uint64_t n)
+        {
+            if (n < 128)
+            {
+                return optimal(n);
+            }
+            AdditionChain best = sliding_window(n, 1);
+            for (int k = 2; k <= 6; ++k)
+            {
+                AdditionChain c = sliding_window(n, k);
+                if (c.length < best.length) best = c;
+            }
+            return best;
+        }
+
+    private:
+        constexpr
+        bool search_star(std::uint64_t n, std::size_t limit)
+        {
+            std::uint64_t last = back();
+            if (last == n) return true;
+            if (length == limit) return false;
+
+            // Even doubling every time, the chain can't reach n.
+            if ((last << (limit - length)) < n) return false;
+
+            for (std::size_t j = length; j-- > 0; )
+            {
+                std::uint64_t x = last + e[j];
+                if (x > n) continue;
+                push(length - 1, j);
+                if (search_star(n, limit)) return true;
+                pop();
+            }
+            return false;
+        }
+
+
+        // Remove the elements of the table that are not used to compute n.
+        constexpr
+        void remove_unused()
+        {
+            std::array<bool, max_length> live{};
+            live[length - 1] = true;
+            for (std::size_t k = length; k-- > 1; )
+            {
+                if (live[k])
+                {
+                    live[lhs[k]] = true;
+                    live[rhs[k]] = true;
+                }
+            }
+
+            std::array<std::uint8_t, max_length> index{};
+            std::size_t m = 1;
+            for (std::size_t k = 1; k < length; ++k)
+            {
+                if (!live[k]) continue;
+                e[m] = e[k];
+                lhs[m] = index[lhs[k]];
+                rhs[m] = index[rhs[k]];
+                index[k] = static_cast<std::uint8_t>(m);
+                ++m;
+            }
+            length = m;
+        }
+
+
+        // Assign to each element the first free slot. A slot is free after the last use of its value.
+        constexpr
+        void allocate_slots()
+        {
+            std::array<std::size_t, max_length> last_use{};
+            for (std::size_t k = 1; k < length; ++k)
+            {
+                last_use[lhs[k]] = k;
+                last_use[rhs[k]] = k;
+            }
+            last_use[length - 1] = length;
+
+            std::array<bool, max_length> busy{};
+            busy[0] = true;
+            slot[0] = 0;
+            registers = 1;
+            for (std::size_t k = 1; k < length; ++k)
+            {
+                if (last_use[lhs[k]] == k) busy[slot[lhs[k]]] = false;
+                if (last_use[rhs[k]] == k) busy[slot[rhs[k]]] = false;
+
+                std::size_t r = 0;
+                while (busy[r])
+                {
+                    ++r;
+                }
+                busy[r] = true;
+                slot[k] = static_cast<std::uint8_t>(r);
+                if (r + 1 > registers) registers = r + 1;
+            }
+        }
+    };
+
+
+
     struct AssociativeOp
     {
 
@@ -74,7 +349,7 @@ namespace eop
         {
             if (n == I(1)) return a;
 
-            domain_t<Op> r = return power_1(op(a, a), n / I(2), op);
+            domain_t<Op> r = power_1(op(a, a), n / I(2), op);
             if (!Integer::is_even(n))
             {
                 r = op(r, a);
@@ -310,6 +585,145 @@ namespace eop
             return power(a, n, op);
         }
 
+
+        // Precondition: c.registers <= R.
+        template <std::size_t R, associative_operation Op>
+        static constexpr
+        domain_t<Op> power_chain(domain_t<Op> a, const AdditionChain& c, Op op)
+        {
+            std::array<domain_t<Op>, R> v{};
+            v[0] = a;
+            for (std::size_t k = 1; k < c.length; ++k)
+            {
+                v[c.slot[k]] = op(v[c.slot[c.lhs[k]]], v[c.slot[c.rhs[k]]]);
+            }
+            return v[c.slot[c.length - 1]];
+        }
+
+
+        // Precondition: c.registers <= AdditionChain::max_length.
+        // The chain is computed once (AdditionChain::make(n)) and reused for every base.
+        template <associative_operation Op>
+        static constexpr
+        domain_t<Op> power_chain(domain_t<Op> a, const AdditionChain& c, Op op)
+        {
+            if (c.registers <= 8) return power_chain<8>(a, c, op);
+            if (c.registers <= 24) return power_chain<24>(a, c, op);
+            return power_chain<AdditionChain::max_length>(a, c, op);
+        }
+
+
+        // Precondition: N > 0.
+        // The chain is computed at compile time and the loop is unrolled.
+        template <std::uint64_t N, associative_operation Op>
+        static constexpr
+        domain_t<Op> power(domain_t<Op> a, Op op)
+        {
+            constexpr AdditionChain c = AdditionChain::make(N);
+            std::array<domain_t<Op>, c.registers> v{};
+            v[0] = a;
+            [&]<std::size_t ...K>(std::index_sequence<K...>)
+            {
+                ((v[c.slot[K + 1]] = op(v[c.slot[c.lhs[K + 1]]], v[c.slot[c.rhs[K + 1]]])), ...);
+            }(std::make_index_sequence<c.length - 1>{});
+            return v[c.slot[c.length - 1]];
+        }
+
+
+        // Precondition: positive(n) && 1 <= k <= 6.
+        // Left to right sliding window: table of a, a^3, ..., a^(2^k - 1), then each window
+        // of at most k bits ending with a 1 costs one operation instead of one for each 1 bit.
+        template <int k, integer I, associative_operation Op>
+        static constexpr
+        domain_t<Op> power_sliding_window(domain_t<Op> a, I n, Op op)
+        {
+            using U = std::make_unsigned_t<I>;
+            U u = static_cast<U>(n);
+
+            std::array<domain_t<Op>, (std::size_t{1} << (k - 1))> table{};
+            table[0] = a;
+            if constexpr (k > 1)
+            {
+                domain_t<Op> a2 = op(a, a);
+                for (std::size_t w = 1; w < table.size(); ++w)
+                {
+                    table[w] = op(table[w - 1], a2);
+                }
+            }
+
+            int i = std::bit_width(u) - 1;
+            int j = i - k + 1 < 0 ? 0 : i - k + 1;
+            while (((u >> j) & U{1}) == U{0}) ++j;
+            domain_t<Op> r = table[((u >> j) & ((U{1} << (i - j + 1)) - U{1})) >> 1];
+            i = j - 1;
+
+            while (i >= 0)
+            {
+                if (((u >> i) & U{1}) == U{0})
+                {
+                    r = op(r, r);
+                    --i;
+                    continue;
+                }
+                j = i - k + 1 < 0 ? 0 : i - k + 1;
+                while (((u >> j) & U{1}) == U{0}) ++j;
+                for (int s = j; s <= i; ++s)
+                {
+                    r = op(r, r);
+                }
+                r = op(r, table[((u >> j) & ((U{1} << (i - j + 1)) - U{1})) >> 1]);
+                i = j - 1;
+            }
+            return r;
+        }
+
+
+        // Precondition: positive(n).
+        // Same as power for L bases and the same exponent. The exponent is scanned once and
+        // the L independent applications of op in each step can be executed in parallel by the cpu.
+        template <std::size_t L, integer I, associative_operation Op>
+        static constexpr
+        std::array<domain_t<Op>, L> power_many(std::array<domain_t<Op>, L> a, I n, Op op)
+        {
+            while (Integer::is_even(n))
+            {
+                for (std::size_t i = 0; i < L; ++i) a[i] = op(a[i], a[i]);
+                n = Integer::half_nonnegative(n);
+            }
+            n = Integer::half_nonnegative(n);
+            if (Integer::is_zero(n)) return a;
+
+            std::array<domain_t<Op>, L> r = a;
+            for (std::size_t i = 0; i < L; ++i) a[i] = op(a[i], a[i]);
+            while (true)
+            {
+                if (Integer::is_odd(n))
+                {
+                    for (std::size_t i = 0; i < L; ++i) r[i] = op(r[i], a[i]);
+                    if (Integer::is_one(n)) return r;
+                }
+                for (std::size_t i = 0; i < L; ++i) a[i] = op(a[i], a[i]);
+                n = Integer::half_nonnegative(n);
+            }
+        }
+
+
+        // Precondition: positive(n).
+        template <integer I, associative_operation Op>
+        static constexpr
+        domain_t<Op> power_sliding_window(domain_t<Op> a, I n, Op op)
+        {
+            using U = std::make_unsigned_t<I>;
+            switch (AdditionChain::window_size(std::bit_width(static_cast<U>(n))))
+            {
+            case 1: return power(a, n, op);
+            case 2: return power_sliding_window<2>(a, n, op);
+            case 3: return power_sliding_window<3>(a, n, op);
+            case 4: return power_sliding_window<4>(a, n, op);
+            case 5: return power_sliding_window<5>(a, n, op);
+            default: return power_sliding_window<6>(a, n, op);
+            }
+        }
     };
 
 
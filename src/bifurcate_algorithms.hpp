@@ -4,34 +4,264 @@
 /*
 bifurcate_algorithms.hpp
 
-PURPOSE:
+PURPOSE: algorithms on the values and the shapes of trees of bidirectional bifurcate coordinates.
 
 FUNCTIONS:
+    for_each:                           calls a procedure on the values of a tree in pre order.
+
+    bifurcate_isomorphic:               same shape.
+    bifurcate_equivalent:               same shape and equivalent values at the same positions.
+    bifurcate_compare:                  lexicographical comparison of the pre order visits.
+
+    bifurcate_fingerprint:              hashes of the shape and of the values of a tree.
 
 
 DESCRIPTION:
+The comparisons traverse the two trees in lockstep with traverse_step, in constant space, and
+return at the first difference: a different visit (one tree has a successor where the other has
+none) or, at a pre visit, different values.
 
+A tree is usually compared with other trees more than once (the versions of a configuration
+for example): its fingerprint, computed in one traversal, is kept with it. Different fingerprints
+prove that the trees differ, the overloads with the fingerprints then return without a traversal.
+Equal fingerprints don't prove the equality (the hashes collide), the trees are traversed.
 
 */
 
 
+#include <cstdint>
+
 #include "bifurcate_coordinate_concepts.hpp"
 #include "bifurcate_coordinates.hpp"
 #include "function_concepts.hpp"
+#include "ordering_concepts.hpp"
 #include "type_traits.hpp"
 
 namespace eop
 {
+    // Precondition: tree(c)
     template <bidirectional_bifurcate C, unary_procedure Proc>
         requires std::same_as<domain_t<Proc>, value_type_t<C>>
-    void for_each(C c, Proc p)
+    Proc for_each(C c, Proc proc)
+    {
+        if (c.empty())
+        {
+            return proc;
+        }
+        C root = c;
+        visit v = visit::pre;
+        proc(*c);
+        do
+        {
+            traverse_step(v, c);
+            if (v == visit::pre)
+            {
+                proc(*c);
+            }
+        } while (c != root || v != visit::post);
+        return proc;
+    }
+
+
+
+    // Precondition: tree(c0) && tree(c1)
+    template <bidirectional_bifurcate C0, bidirectional_bifurcate C1>
+    [[nodiscard]]
+    constexpr
+    bool bifurcate_isomorphic(C0 c0, C1 c1)
+    {
+        if (c0.empty())
+        {
+            return c1.empty();
+        }
+        if (c1.empty())
+        {
+            return false;
+        }
+        C0 root0 = c0;
+        visit v0 = visit::pre;
+        visit v1 = visit::pre;
+        while (true)
+        {
+            traverse_step(v0, c0);
+            traverse_step(v1, c1);
+            if (v0 != v1)
+            {
+                return false;
+            }
+            if (c0 == root0 && v0 == visit::post)
+            {
+                return true;
+            }
+        }
+    }
+
+
+    // Property: r is an equivalence
+    // Precondition: tree(c0) && tree(c1)
+    template <bidirectional_bifurcate C0, bidirectional_bifurcate C1, relation R>
+        requires std::same_as<value_type_t<C0>, value_type_t<C1>> && std::same_as<domain_t<R>, value_type_t<C0>>
+    [[nodiscard]]
+    constexpr
+    bool bifurcate_equivalent(C0 c0, C1 c1, R r)
+    {
+        if (c0.empty())
+        {
+            return c1.empty();
+        }
+        if (c1.empty())
+        {
+            return false;
+        }
+        C0 root0 = c0;
+        visit v0 = visit::pre;
+        visit v1 = visit::pre;
+        while (true)
+        {
+            if (v0 == visit::pre && !r(*c0, *c1))
+            {
+                return false;
+            }
+            traverse_step(v0, c0);
+            traverse_step(v1, c1);
+            if (v0 != v1)
+            {
+                return false;
+            }
+            if (c0 == root0 && v0 == visit::post)
+            {
+                return true;
+            }
+        }
+    }
+
+
+    // Lexicographical comparison of the sequences of pre visits, a missing successor is less than
+    // a present one: returns true if the tree of c0 is less than the tree of c1.
+    // Precondition: tree(c0) && tree(c1)
+    template <bidirectional_bifurcate C0, bidirectional_bifurcate C1, weak_ordering_relation R>
+        requires std::same_as<value_type_t<C0>, value_type_t<C1>> && std::same_as<domain_t<R>, value_type_t<C0>>
+    [[nodiscard]]
+    constexpr
+    bool bifurcate_compare(C0 c0, C1 c1, R r)
     {
-        visit v;
-        auto root = c;
+        if (c1.empty())
+        {
+            return false;
+        }
+        if (c0.empty())
+        {
+            return true;
+        }
+        C0 root0 = c0;
+        visit v0 = visit::pre;
+        visit v1 = visit::pre;
+        while (true)
+        {
+            if (v0 == visit::pre)
+            {
+                if (r(*c0, *c1))
+                {
+                    return true;
+                }
+                if (r(*c1, *c0))
+                {
+                    return false;
+                }
+            }
+            traverse_step(v0, c0);
+            traverse_step(v1, c1);
+            if (v0 != v1)
+            {
+                // The tree with the successor (pre visit) is greater.
+                return v0 > v1;
+            }
+            if (c0 == root0 && v0 == visit::post)
+            {
+                return false;
+            }
+        }
+    }
+
+
 
+    template <typename N>
+    struct BifurcateFingerprint
+    {
+        N weight{0};
+        std::uint64_t shape = 0;
+        std::uint64_t values = 0;
+
+        friend
+        bool operator==(const BifurcateFingerprint&, const BifurcateFingerprint&) = default;
+    };
+
+
+    // The sequence of the visits (the shape) and the sequence of the hashes of the values in pre
+    // order are hashed, one multiplication per step.
+    // Precondition: tree(c)
+    template <bidirectional_bifurcate C, unary_procedure H>
+        requires std::same_as<domain_t<H>, value_type_t<C>> && std::convertible_to<codomain_t<H>, std::uint64_t>
+    [[nodiscard]]
+    BifurcateFingerprint<weight_type_t<C>> bifurcate_fingerprint(C c, H hash)
+    {
+        auto mix = [](std::uint64_t h, std::uint64_t x)
+        {
+            h = (h ^ x) * 0xff51afd7ed558ccdull;
+            return h ^ (h >> 32);
+        };
+
+        BifurcateFingerprint<weight_type_t<C>> f;
+        if (c.empty())
+        {
+            return f;
+        }
+        C root = c;
+        visit v = visit::pre;
+        f.weight = 1;
+        f.values = mix(f.values, static_cast<std::uint64_t>(hash(*c)));
         do
         {
+            traverse_step(v, c);
+            f.shape = mix(f.shape, static_cast<std::uint64_t>(v) + 1);
+            if (v == visit::pre)
+            {
+                ++f.weight;
+                f.values = mix(f.values, static_cast<std::uint64_t>(hash(*c)));
+            }
+        } while (c != root || v != visit::post);
+        return f;
+    }
+
+
+    // Precondition: tree(c0) && tree(c1) && f0 and f1 are their fingerprints
+    template <bidirectional_bifurcate C0, bidirectional_bifurcate C1>
+    [[nodiscard]]
+    constexpr
+    bool bifurcate_isomorphic(C0 c0, const BifurcateFingerprint<weight_type_t<C0>>& f0,
+                              C1 c1, const BifurcateFingerprint<weight_type_t<C1>>& f1)
+    {
+        if (f0.weight != f1.weight || f0.shape != f1.shape)
+        {
+            return false;
+        }
+        return bifurcate_isomorphic(c0, c1);
+    }
+
 
-        } 
-    } 
+    // Precondition: tree(c0) && tree(c1) && f0 and f1 are their fingerprints with a hash such that
+    // r(x, y) implies hash(x) == hash(y)
+    template <bidirectional_bifurcate C0, bidirectional_bifurcate C1, relation R>
+        requires std::same_as<value_type_t<C0>, value_type_t<C1>> && std::same_as<domain_t<R>, value_type_t<C0>>
+    [[nodiscard]]
+    constexpr
+    bool bifurcate_equivalent(C0 c0, const BifurcateFingerprint<weight_type_t<C0>>& f0,
+                              C1 c1, const BifurcateFingerprint<weight_type_t<C1>>& f1, R r)
+    {
+        if (f0.weight != f1.weight || f0.shape != f1.shape || f0.values != f1.values)
+        {
+            return false;
+        }
+        return bifurcate_equivalent(c0, c1, r);
+    }
 } // namespace eop
@@ -36,4 +36,14 @@ namespace eop
 
         // The regularity implies that a.predecessor().left_successor() == a if a is a left child.
     };
+
+
+    // The successor links can be rewritten, an empty coordinate removes the successor.
+    template <typename T>
+    concept linked_bifurcate_coordinate = bifurcate_coordinate<T> &&
+        requires (T a, T b)
+    {
+        a.set_left_successor(b);
+        a.set_right_successor(b);
+    };
 } // namespace eop
@@ -9,11 +9,13 @@ PURPOSE: define basic operations of bifurcate coordinates.
 #include "type_traits.hpp"
 #include "bifurcate_coordinate_concepts.hpp"
 #include "function_concepts.hpp"
+#include "iterator.hpp"
 #include "number.hpp"
 #include "orbit_transformations.hpp"
 #include "utility_types.hpp"
 
 #include <concepts>
+#include <exception>
 
 namespace eop
 {
@@ -89,11 +91,11 @@ namespace eop
 
         if (c.has_left_successor())
         {
-            l = weight_recursive(c.left_successor());
+            l = height_recursive(c.left_successor());
         }
         if (c.has_right_successor())
         {
-            r = weight_recursive(c.right_successor());
+            r = height_recursive(c.right_successor());
         }
         return Integer::max(l, r) + 1;
     }
@@ -127,8 +129,11 @@ namespace eop
 
 
 
+    // One step of the traversal of traverse_nonempty: from the visit v of c to the next visit.
+    // The predecessor links replace the stack of the recursion, the traversal needs constant space
+    // whatever the height of the tree.
     // The value returned is the change in height.
-    // Precondition: c.has_predecessor() && v != post
+    // Precondition: c.has_predecessor() || v != visit::post
     template <bidirectional_bifurcate C>
     constexpr
     int traverse_step(visit& v, C& c)
@@ -148,19 +153,24 @@ namespace eop
             if (c.has_right_successor())
             {
                 c = c.right_successor();
+                v = visit::pre;
                 return 1;
             }
             v = visit::post;
             return 0;
 
         case visit::post:
-            if (is_left_successor(c))
+        {
+            C p = c.predecessor();
+            if (p.has_left_successor() && p.left_successor() == c)
             {
                 v = visit::in;
             }
-            c = c.predecessor();
+            c = p;
             return -1;
         }
+        }
+        return 0;
     }
 
 
@@ -170,7 +180,7 @@ namespace eop
     constexpr
     bool reachable(C x, C y)
     {
-        if (c.empty())
+        if (x.empty())
         {
             return false;
         }
@@ -185,11 +195,14 @@ namespace eop
             }
             traverse_step(v, x);
         } while (x != root || v != visit::post);
+        return false;
     }
 
 
     // Precondition: tree(c)
     template <bidirectional_bifurcate C>
+    [[nodiscard]]
+    constexpr
     weight_type_t<C> weight(C c)
     {
         using N = weight_type_t<C>;
@@ -209,12 +222,15 @@ namespace eop
             {
                 ++n;
             }
-        } while (c != root || v != post);
+        } while (c != root || v != visit::post);
         return n;
     }
 
+
     // Precondition: tree(c)
     template <bidirectional_bifurcate C>
+    [[nodiscard]]
+    constexpr
     weight_type_t<C> height(C c)
     {
         using N = weight_type_t<C>;
@@ -225,22 +241,24 @@ namespace eop
         }
 
         C root = c;
-         visit v = visit::pre;
+        visit v = visit::pre;
         N n{1}; // Invariant: n is max of height of pre visits so far.
         N m{1}; // Invariant: m is height of current pre visit.
         do
         {
-            m = m - N{1} + N{traverse_step(v, c) + 1};
+            m = (m - N{1}) + static_cast<N>(traverse_step(v, c) + 1);
             n = Integer::max(n, m); 
-        } while (c != root || v != post);
+        } while (c != root || v != visit::post);
         return n;
     }
 
 
-    // Precondition: tree 
+    // Same visits as traverse_nonempty, in constant space.
+    // Precondition: tree(c)
     template <bidirectional_bifurcate C, binary_procedure Proc>
         requires std::same_as<input_type_t<Proc, 0>, visit> && 
             std::same_as<input_type_t<Proc, 1>, C>
+    constexpr
     Proc traverse(C c, Proc proc)
     {
         if (c.empty())
@@ -249,32 +267,231 @@ namespace eop
         }
         C root = c;
         visit v = visit::pre;
-        proc(pre, c);
+        proc(visit::pre, c);
         do
         {
             traverse_step(v, c);
             proc(v, c);
-        } while (c != root || v != post);
+        } while (c != root || v != visit::post);
+        return proc;
     }
 
 
-
-    // Exercise 7.3
-    template <bidirectional_bifurcate C>
-    bool is_dag(C c)
+    // Same visits as traverse_nonempty, in constant space and without predecessor links (Morris).
+    // Before the left subtree of c, the right successor of the last node of the left subtree in
+    // order is set to c: a thread back to c, removed when it's followed. The nodes are visited post
+    // bottom up along the right spines, whose links are reversed then restored. Every link is
+    // followed about 4 times and written twice: 3x the time of traverse_nonempty on a balanced tree,
+    // for the trees too high for the recursion and without predecessor links for traverse.
+    // Every link is restored on return. If proc throws, the traversal completes without calling
+    // proc to restore the links, then the exception is rethrown.
+    // Precondition: tree(c) && proc neither follows nor modifies the successor links
+    template <linked_bifurcate_coordinate C, binary_procedure Proc>
+        requires std::same_as<input_type_t<Proc, 0>, visit> &&
+            std::same_as<input_type_t<Proc, 1>, C>
+    Proc traverse_morris(C c, Proc proc)
     {
-           
+        if (c.empty())
+        {
+            return proc;
+        }
+
+        std::exception_ptr error;
+        auto call = [&](visit v, C x)
+        {
+            if (error) return;
+            try
+            {
+                proc(v, x);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        };
+
+        // Reverses the right spine from x, visit is called on the nodes in the new order.
+        auto reverse_right_spine = [](C x, auto f)
+        {
+            C previous;
+            while (true)
+            {
+                f(x);
+                C next = x.has_right_successor() ? x.right_successor() : C{};
+                x.set_right_successor(previous);
+                if (next.empty()) return x;
+                previous = x;
+                x = next;
+            }
+        };
+
+        auto post_right_spine = [&](C x)
+        {
+            C last = reverse_right_spine(x, [](C) {});
+            reverse_right_spine(last, [&](C y) { call(visit::post, y); });
+        };
+
+        C root = c;
+        while (true)
+        {
+            if (c.has_left_successor())
+            {
+                C p = c.left_successor();
+                while (p.has_right_successor() && p.right_successor() != c)
+                {
+                    p = p.right_successor();
+                }
+                if (!p.has_right_successor())
+                {
+                    call(visit::pre, c);
+                    p.set_right_successor(c);
+                    c = c.left_successor();
+                    continue;
+                }
+                // Back from the left subtree.
+                p.set_right_successor(C{});
+                post_right_spine(c.left_successor());
+            }
+            else
+            {
+                call(visit::pre, c);
+            }
+            call(visit::in, c);
+            if (!c.has_right_successor())
+            {
+                break;
+            }
+            c = c.right_successor();
+        }
+        post_right_spine(root);
+
+        if (error) std::rethrow_exception(error);
+        return proc;
     }
 
 
+
+    // In order iterator on the tree of a root: ++ goes to the next in visit with traverse_step
+    // (amortized O(1): each link is followed twice in a whole traversal), -- to the previous one.
+    // The end of the range is the empty coordinate.
     template <bidirectional_bifurcate C>
     class BidirectionalBifurcateIterator
     {
     public:
-           
+        using value_type = value_type_t<C>;
+        using distance_type = weight_type_t<C>;
+        using iterator_tag = bidirectional_iterator_tag;
+
+        BidirectionalBifurcateIterator() = default;
+
+        // The iterator at the first node in order of the tree of root.
+        // Precondition: tree(root)
+        explicit BidirectionalBifurcateIterator(C root) : c(root), root(root)
+        {
+            if (c.empty())
+            {
+                // The empty coordinates are not necessarily equal.
+                c = C{};
+                return;
+            }
+            while (c.has_left_successor())
+            {
+                c = c.left_successor();
+            }
+        }
+
+        // The end of the range of the tree of root.
+        [[nodiscard]]
+        static BidirectionalBifurcateIterator end(C root)
+        {
+            BidirectionalBifurcateIterator i;
+            i.root = root;
+            return i;
+        }
+
+
+        // Precondition: !coordinate().empty()
+        [[nodiscard]]
+        value_type operator*() const
+        {
+            return *c;
+        }
+
+        [[nodiscard]]
+        C coordinate() const
+        {
+            return c;
+        }
+
+
+        // Precondition: !coordinate().empty()
+        BidirectionalBifurcateIterator& operator++()
+        {
+            visit v = visit::in;
+            do
+            {
+                if (c == root && (v == visit::post || (v == visit::in && !c.has_right_successor())))
+                {
+                    c = C{};
+                    return *this;
+                }
+                traverse_step(v, c);
+            } while (v != visit::in);
+            return *this;
+        }
+
+        BidirectionalBifurcateIterator operator++(int)
+        {
+            BidirectionalBifurcateIterator i = *this;
+            ++*this;
+            return i;
+        }
+
+
+        // Precondition: the iterator isn't at the first node
+        BidirectionalBifurcateIterator& operator--()
+        {
+            if (c.empty())
+            {
+                c = root;
+                while (c.has_right_successor())
+                {
+                    c = c.right_successor();
+                }
+            }
+            else if (c.has_left_successor())
+            {
+                c = c.left_successor();
+                while (c.has_right_successor())
+                {
+                    c = c.right_successor();
+                }
+            }
+            else
+            {
+                while (is_left_successor(c))
+                {
+                    c = c.predecessor();
+                }
+                c = c.predecessor();
+            }
+            return *this;
+        }
+
+        BidirectionalBifurcateIterator operator--(int)
+        {
+            BidirectionalBifurcateIterator i = *this;
+            --*this;
+            return i;
+        }
+
+
+        friend
+        bool operator==(const BidirectionalBifurcateIterator&, const BidirectionalBifurcateIterator&) = default;
 
     private:
-        non_owned_ptr<C> p = nullptr;
+        C c;
+        C root;
     };
 
 } // namespace eop
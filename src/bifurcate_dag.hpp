@@ -0,0 +1,445 @@
+#ifndef BIFURCATE_DAG_HPP
+#define BIFURCATE_DAG_HPP
+
+/*
+bifurcate_dag.hpp
+
+PURPOSE: share the equal subtrees of binary trees (hash-consing): the trees become a directed acyclic graph.
+
+FUNCTIONS:
+    traverse_distinct:      post order visit of the distinct coordinates reachable from a coordinate.
+    is_dag:                 no coordinate reachable from c is its own descendant.
+    weight_memoized:        weight of the tree unfolded from a dag, computed once per distinct coordinate.
+    height_memoized:        height of the tree unfolded from a dag, computed once per distinct coordinate.
+
+CLASSES:
+    DagCoordinate:          bifurcate coordinate of a BifurcateDag.
+    BifurcateDag:           the unique nodes of a set of trees.
+
+DESCRIPTION:
+The coordinates of bifurcate_coordinates.hpp are trees, every node is reachable from the root by
+a single path. In a dag a node is the successor of several nodes: the traversals of
+bifurcate_coordinates.hpp visit it once per path, as the node of the unfolded tree, and weight
+and height take a time proportional to the unfolded tree. The functions of this file visit each
+distinct coordinate once and keep the values of the visited coordinates in a hash table:
+O(number of distinct coordinates) expected time and space. They need a hash of the coordinates.
+A dag has no predecessor: the coordinates are bifurcate, not bidirectional.
+
+BifurcateDag makes each node once: make(x, l, r) returns the existing node of value x and
+successors l and r if there's one, else a new node. The successors are unique, so two subtrees are
+equal if and only if they are the same node, compared in O(1). A node stores the weight and the
+height of its unfolded tree, computed from its successors when it is made: weight and height
+are O(1). intern copies a tree in the dag.
+
+The nodes are in a vector, the table of the nodes is open addressing on 64 bits slots: the index of
+the node and 32 bits of its hash, a probe reads a node only if the 32 bits match.
+
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "bifurcate_coordinate_concepts.hpp"
+#include "bifurcate_coordinates.hpp"
+#include "number.hpp"
+#include "type_concepts.hpp"
+#include "type_traits.hpp"
+#include "vector.hpp"
+
+namespace eop
+{
+    // Calls post(x) once for each distinct coordinate x reachable from c, after its successors.
+    // Returns false, before the end, if a coordinate is its own descendant.
+    // The stack of the depth first search is explicit, the depth is not limited by the call stack.
+    template <bifurcate_coordinate C, typename H, typename Post>
+    bool traverse_distinct(C c, H hash, Post post)
+    {
+        if (c.empty())
+        {
+            return true;
+        }
+
+        struct frame
+        {
+            C c;
+            int next = 0; // 0: left successor, 1: right successor, 2: post
+        };
+
+        // false while on the path from c, true once visited post.
+        std::unordered_map<C, bool, H> seen(16, hash);
+        Vector<frame> stack;
+        seen.emplace(c, false);
+        stack.emplace_back(frame{c, 0});
+        while (stack.size() != 0)
+        {
+            frame& f = stack[stack.size() - 1];
+            C x = f.c;
+            C s;
+            if (f.next == 0)
+            {
+                f.next = 1;
+                if (!x.has_left_successor()) continue;
+                s = x.left_successor();
+            }
+            else if (f.next == 1)
+            {
+                f.next = 2;
+                if (!x.has_right_successor()) continue;
+                s = x.right_successor();
+            }
+            else
+            {
+                seen[x] = true;
+                post(x);
+                stack.pop_back();
+                continue;
+            }
+
+            auto [it, inserted] = seen.try_emplace(s, false);
+            if (inserted)
+            {
+                stack.emplace_back(frame{s, 0});
+            }
+            else if (!it->second)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    // Exercise 7.3
+    template <bifurcate_coordinate C, typename H = std::hash<C>>
+    [[nodiscard]]
+    bool is_dag(C c, H hash = H{})
+    {
+        return traverse_distinct(c, hash, [](C) {});
+    }
+
+
+    // The weight of the unfolded tree must fit in weight_type_t<C>.
+    // Precondition: is_dag(c)
+    template <bifurcate_coordinate C, typename H = std::hash<C>>
+    [[nodiscard]]
+    weight_type_t<C> weight_memoized(C c, H hash = H{})
+    {
+        using N = weight_type_t<C>;
+
+        if (c.empty())
+        {
+            return N{0};
+        }
+        std::unordered_map<C, N, H> weights(16, hash);
+        traverse_distinct(c, hash, [&weights](C x)
+        {
+            N w{1};
+            if (x.has_left_successor()) w = w + weights[x.left_successor()];
+            if (x.has_right_successor()) w = w + weights[x.right_successor()];
+            weights[x] = w;
+        });
+        return weights[c];
+    }
+
+
+    // Precondition: is_dag(c)
+    template <bifurcate_coordinate C, typename H = std::hash<C>>
+    [[nodiscard]]
+    weight_type_t<C> height_memoized(C c, H hash = H{})
+    {
+        using N = weight_type_t<C>;
+
+        if (c.empty())
+        {
+            return N{0};
+        }
+        std::unordered_map<C, N, H> heights(16, hash);
+        traverse_distinct(c, hash, [&heights](C x)
+        {
+            N h{0};
+            if (x.has_left_successor()) h = heights[x.left_successor()];
+            if (x.has_right_successor()) h = Integer::max(h, heights[x.right_successor()]);
+            heights[x] = h + N{1};
+        });
+        return heights[c];
+    }
+
+
+
+    template <typename T>
+    struct DagNode
+    {
+        using index_type = std::uint32_t;
+
+        static constexpr index_type null = std::numeric_limits<index_type>::max();
+
+        T value{};
+        index_type left = null;
+        index_type right = null;
+        std::size_t weight = 0;
+        std::size_t height = 0;
+    };
+
+
+
+    template <typename T, typename H>
+        requires regular<T>
+    class BifurcateDag;
+
+
+    template <typename T>
+    class DagCoordinate
+    {
+    public:
+        using value_type = T;
+        using weight_type = std::size_t;
+        using index_type = typename DagNode<T>::index_type;
+
+        DagCoordinate() = default;
+
+
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+            return i == DagNode<T>::null;
+        }
+
+        [[nodiscard]]
+        bool has_left_successor() const noexcept
+        {
+            return (*nodes)[i].left != DagNode<T>::null;
+        }
+
+        [[nodiscard]]
+        bool has_right_successor() const noexcept
+        {
+            return (*nodes)[i].right != DagNode<T>::null;
+        }
+
+        [[nodiscard]]
+        DagCoordinate left_successor() const noexcept
+        {
+            return {nodes, (*nodes)[i].left};
+        }
+
+        [[nodiscard]]
+        DagCoordinate right_successor() const noexcept
+        {
+            return {nodes, (*nodes)[i].right};
+        }
+
+        [[nodiscard]]
+        index_type index() const noexcept
+        {
+            return i;
+        }
+
+        // Precondition: !empty()
+        [[nodiscard]]
+        const T& operator*() const noexcept
+        {
+            return (*nodes)[i].value;
+        }
+
+        friend
+        bool operator==(const DagCoordinate&, const DagCoordinate&) = default;
+
+    private:
+        template <typename U, typename H>
+            requires regular<U>
+        friend class BifurcateDag;
+
+        DagCoordinate(const Vector<DagNode<T>>* nodes, index_type i) : nodes(nodes), i(i) {}
+
+        const Vector<DagNode<T>>* nodes = nullptr;
+        index_type i = DagNode<T>::null;
+    };
+
+
+
+    // The dag owns its nodes: it's movable, not copyable. The coordinates stay valid while the dag lives.
+    template <typename T, typename H = std::hash<T>>
+        requires regular<T>
+    class BifurcateDag
+    {
+    public:
+        using coordinate = DagCoordinate<T>;
+        using index_type = typename DagNode<T>::index_type;
+
+        explicit BifurcateDag(H hash = H{}) : hash(hash)
+        {
+            reset();
+        }
+
+        // The moved-from dag gets new nodes and slots: it is empty and usable.
+        BifurcateDag(BifurcateDag&& x) : nodes(std::move(x.nodes)), slots(std::move(x.slots)), hash(x.hash)
+        {
+            x.reset();
+        }
+
+        BifurcateDag& operator=(BifurcateDag&& x)
+        {
+            if (this != &x)
+            {
+                nodes = std::move(x.nodes);
+                slots = std::move(x.slots);
+                hash = x.hash;
+                x.reset();
+            }
+            return *this;
+        }
+
+
+        // The node of value x and successors l and r.
+        // Precondition: l and r are empty or coordinates of this dag && fewer than 2^32 - 1 nodes
+        coordinate make(const T& x, coordinate l = coordinate{}, coordinate r = coordinate{})
+        {
+            std::uint64_t h = node_hash(x, l.i, r.i);
+            std::size_t mask = slots.size() - 1;
+            std::uint64_t tag = h >> 32;
+            std::size_t k = static_cast<std::size_t>(h) & mask;
+            while (slots[k] != empty_slot)
+            {
+                if ((slots[k] >> 32) == tag)
+                {
+                    index_type j = static_cast<index_type>(slots[k]);
+                    const DagNode<T>& n = (*nodes)[j];
+                    if (n.left == l.i && n.right == r.i && n.value == x) return {nodes.get(), j};
+                }
+                k = (k + 1) & mask;
+            }
+
+            index_type j = static_cast<index_type>(nodes->size());
+            DagNode<T> n;
+            n.value = x;
+            n.left = l.i;
+            n.right = r.i;
+            n.weight = 1 + weight(l) + weight(r);
+            n.height = 1 + Integer::max(height(l), height(r));
+            nodes->emplace_back(std::move(n));
+            slots[k] = (tag << 32) | j;
+            if (2 * nodes->size() > slots.size()) grow();
+            return {nodes.get(), j};
+        }
+
+
+        // The node of the tree of c: the subtrees of c equal to existing nodes are shared.
+        // Precondition: tree(c)
+        template <bidirectional_bifurcate C>
+            requires std::same_as<value_type_t<C>, T>
+        coordinate intern(C c)
+        {
+            if (c.empty())
+            {
+                return coordinate{};
+            }
+            // The nodes of the successors visited post and not yet used by their predecessor.
+            Vector<coordinate> made;
+            C root = c;
+            visit v = visit::pre;
+            while (true)
+            {
+                if (v == visit::post)
+                {
+                    coordinate r = c.has_right_successor() ? pop(made) : coordinate{};
+                    coordinate l = c.has_left_successor() ? pop(made) : coordinate{};
+                    made.emplace_back(make(*c, l, r));
+                    if (c == root) break;
+                }
+                traverse_step(v, c);
+            }
+            return made[0];
+        }
+
+
+        // Weight of the unfolded tree of c, O(1).
+        [[nodiscard]]
+        std::size_t weight(coordinate c) const noexcept
+        {
+            return c.empty() ? 0 : (*nodes)[c.i].weight;
+        }
+
+        // Height of the unfolded tree of c, O(1).
+        [[nodiscard]]
+        std::size_t height(coordinate c) const noexcept
+        {
+            return c.empty() ? 0 : (*nodes)[c.i].height;
+        }
+
+        // Number of distinct nodes.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return nodes->size();
+        }
+
+    private:
+        static constexpr std::uint64_t empty_slot = std::numeric_limits<std::uint64_t>::max();
+
+
+        [[nodiscard]]
+        std::uint64_t node_hash(const T& x, index_type l, index_type r) const
+        {
+            std::uint64_t h = static_cast<std::uint64_t>(hash(x));
+            h = (h ^ l) * 0xff51afd7ed558ccdull;
+            h = (h ^ (h >> 32) ^ (std::uint64_t{r} << 16)) * 0xc4ceb9fe1a85ec53ull;
+            return h ^ (h >> 29);
+        }
+
+        // No node and 16 empty slots.
+        void reset()
+        {
+            nodes = std::make_unique<Vector<DagNode<T>>>();
+            slots = Vector<std::uint64_t>{};
+            slots.resize(16);
+            for (std::size_t k = 0; k < slots.size(); ++k) slots[k] = empty_slot;
+        }
+
+        void grow()
+        {
+            Vector<std::uint64_t> s;
+            s.resize(2 * slots.size());
+            std::size_t mask = s.size() - 1;
+            for (std::size_t k = 0; k < s.size(); ++k) s[k] = empty_slot;
+            for (std::size_t j = 0; j < nodes->size(); ++j)
+            {
+                const DagNode<T>& n = (*nodes)[j];
+                std::uint64_t h = node_hash(n.value, n.left, n.right);
+                std::size_t k = static_cast<std::size_t>(h) & mask;
+                while (s[k] != empty_slot) k = (k + 1) & mask;
+                s[k] = ((h >> 32) << 32) | j;
+            }
+            slots = std::move(s);
+        }
+
+        static coordinate pop(Vector<coordinate>& v)
+        {
+            coordinate c = v[v.size() - 1];
+            v.pop_back();
+            return c;
+        }
+
+
+        std::unique_ptr<Vector<DagNode<T>>> nodes;
+        Vector<std::uint64_t> slots;
+        H hash;
+    };
+} // namespace eop
+
+
+template <typename T>
+struct std::hash<eop::DagCoordinate<T>>
+{
+    std::size_t operator()(const eop::DagCoordinate<T>& c) const noexcept
+    {
+        return std::hash<std::uint32_t>{}(c.index());
+    }
+};
+
+
+#endif
@@ -0,0 +1,789 @@
+#ifndef BIG_INTEGER_HPP
+#define BIG_INTEGER_HPP
+
+/*
+big_integer.hpp
+
+PURPOSE: arbitrary precision integer.
+
+CLASSES:
+    BigInteger: signed integer of any size, sign and magnitude representation.
+
+DESCRIPTION:
+The magnitude is a sequence of 64 bits limbs, least significant first, without leading zero limbs
+(zero has no limbs). Values of up to inline_capacity limbs are stored inline, bigger values in a Vector.
+
+The multiplication is selected by the size of the smaller operand:
+    - schoolbook:   O(n^2), for less than karatsuba_threshold limbs.
+    - Karatsuba:    O(n^1.58), 3 products of half size.
+    - Toom-3:       O(n^1.46), 5 products of a third of the size, from toom3_threshold limbs.
+Unbalanced operands are multiplied by slices of the size of the smaller one.
+A product of an object with itself (op(a, a) in power) is computed as a square, that needs about
+half of the limb products in the schoolbook case and only squares in the recursive cases.
+
+BigInteger models integer and euclidean_monoid, so AssociativeOp::power, Fib::fibonacci, Remainder
+and GCD work on it.
+
+*/
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "pair.hpp"
+#include "vector.hpp"
+
+namespace eop
+{
+    class BigInteger
+    {
+    public:
+        using limb = std::uint64_t;
+        using size_type = std::size_t;
+
+        static constexpr size_type inline_capacity = 2;
+        static constexpr size_type karatsuba_threshold = 32;
+        static constexpr size_type toom3_threshold = 160;
+
+
+        BigInteger() = default;
+
+        template <std::integral I>
+        BigInteger(I x)
+        {
+            if constexpr (std::is_signed_v<I>)
+            {
+                negative = x < 0;
+                // Unsigned negation avoids the overflow of -min.
+                assign_limb(negative ? limb{0} - static_cast<limb>(x) : static_cast<limb>(x));
+            }
+            else
+            {
+                assign_limb(static_cast<limb>(x));
+            }
+        }
+
+
+        [[nodiscard]]
+        size_type size() const noexcept
+        {
+            return length;
+        }
+
+        [[nodiscard]]
+        bool is_negative() const noexcept
+        {
+            return negative;
+        }
+
+        [[nodiscard]]
+        bool is_zero() const noexcept
+        {
+            return length == 0;
+        }
+
+        // Precondition: i < size().
+        [[nodiscard]]
+        limb operator[](size_type i) const
+        {
+            return limbs()[i];
+        }
+
+
+        // Number of bits of the magnitude.
+        [[nodiscard]]
+        size_type bit_width() const noexcept
+        {
+            if (length == 0) return 0;
+            return 64 * (length - 1) + std::bit_width(limbs()[length - 1]);
+        }
+
+
+        //******************************** COMPARISON ************************************
+
+        friend
+        bool operator==(const BigInteger& a, const BigInteger& b)
+        {
+            return a.negative == b.negative && compare_magnitude(a, b) == 0;
+        }
+
+        friend
+        std::strong_ordering operator<=>(const BigInteger& a, const BigInteger& b)
+        {
+            if (a.negative != b.negative)
+            {
+                return a.negative ? std::strong_ordering::less : std::strong_ordering::greater;
+            }
+            int c = compare_magnitude(a, b);
+            if (a.negative) c = -c;
+            return c <=> 0;
+        }
+
+        //******************************** COMPARISON ************************************
+
+
+        //******************************** ARITHMETIC ************************************
+
+        friend
+        BigInteger operator-(BigInteger a)
+        {
+            if (!a.is_zero()) a.negative = !a.negative;
+            return a;
+        }
+
+        friend
+        BigInteger operator+(const BigInteger& a, const BigInteger& b)
+        {
+            if (a.negative == b.negative)
+            {
+                BigInteger r = add_magnitude(a, b);
+                r.negative = a.negative && !r.is_zero();
+                return r;
+            }
+            return signed_difference(a, b, a.negative);
+        }
+
+        friend
+        BigInteger operator-(const BigInteger& a, const BigInteger& b)
+        {
+            if (a.negative != b.negative)
+            {
+                BigInteger r = add_magnitude(a, b);
+                r.negative = a.negative && !r.is_zero();
+                return r;
+            }
+            return signed_difference(a, b, a.negative);
+        }
+
+        friend
+        BigInteger operator*(const BigInteger& a, const BigInteger& b)
+        {
+            BigInteger r = &a == &b ? square_magnitude(a) : multiply_magnitude(a, b);
+            r.negative = a.negative != b.negative && !r.is_zero();
+            return r;
+        }
+
+        // Truncated division, as for the built-in integers.
+        // Precondition: b != 0.
+        friend
+        BigInteger operator/(const BigInteger& a, const BigInteger& b)
+        {
+            return quotient_remainder(a, b).first;
+        }
+
+        // The sign of the remainder is the sign of a, as for the built-in integers.
+        // Precondition: b != 0.
+        friend
+        BigInteger operator%(const BigInteger& a, const BigInteger& b)
+        {
+            return quotient_remainder(a, b).second;
+        }
+
+        BigInteger& operator+=(const BigInteger& b) { return *this = *this + b; }
+        BigInteger& operator-=(const BigInteger& b) { return *this = *this - b; }
+        BigInteger& operator*=(const BigInteger& b) { return *this = *this * b; }
+        BigInteger& operator/=(const BigInteger& b) { return *this = *this / b; }
+        BigInteger& operator%=(const BigInteger& b) { return *this = *this % b; }
+
+        BigInteger& operator++() { return *this = *this + BigInteger{1}; }
+        BigInteger& operator--() { return *this = *this - BigInteger{1}; }
+
+
+        // Precondition: b != 0.
+        // Return {quotient, remainder} with a single long division.
+        static
+        Pair<BigInteger, BigInteger> quotient_remainder(const BigInteger& a, const BigInteger& b)
+        {
+            auto qr = divide_magnitude(a, b);
+            qr.first.negative = a.negative != b.negative && !qr.first.is_zero();
+            qr.second.negative = a.negative && !qr.second.is_zero();
+            return qr;
+        }
+
+        //******************************** ARITHMETIC ************************************
+
+
+        //******************************** BITS ************************************
+
+        // Bitwise and of the magnitudes.
+        // Precondition: a >= 0 && b >= 0.
+        friend
+        BigInteger operator&(const BigInteger& a, const BigInteger& b)
+        {
+            size_type n = a.length < b.length ? a.length : b.length;
+            BigInteger r;
+            r.resize(n);
+            for (size_type i = 0; i < n; ++i) r.limbs()[i] = a.limbs()[i] & b.limbs()[i];
+            r.normalize();
+            return r;
+        }
+
+        // Shift of the magnitude, the sign is kept (truncation toward zero for >>).
+        // Precondition: s >= 0.
+        friend
+        BigInteger operator<<(const BigInteger& a, int s)
+        {
+            if (a.is_zero()) return a;
+            size_type words = static_cast<size_type>(s) / 64;
+            int bits = s % 64;
+            BigInteger r;
+            r.resize(a.length + words + 1);
+            limb* rp = r.limbs();
+            const limb* ap = a.limbs();
+            for (size_type i = 0; i < a.length; ++i)
+            {
+                rp[i + words] |= ap[i] << bits;
+                if (bits != 0) rp[i + words + 1] = ap[i] >> (64 - bits);
+            }
+            r.negative = a.negative;
+            r.normalize();
+            return r;
+        }
+
+        // Precondition: s >= 0.
+        friend
+        BigInteger operator>>(const BigInteger& a, int s)
+        {
+            size_type words = static_cast<size_type>(s) / 64;
+            if (words >= a.length) return BigInteger{};
+            int bits = s % 64;
+            BigInteger r;
+            r.resize(a.length - words);
+            limb* rp = r.limbs();
+            const limb* ap = a.limbs();
+            for (size_type i = 0; i < r.length; ++i)
+            {
+                rp[i] = ap[i + words] >> bits;
+                if (bits != 0 && i + words + 1 < a.length) rp[i] |= ap[i + words + 1] << (64 - bits);
+            }
+            r.negative = a.negative;
+            r.normalize();
+            return r;
+        }
+
+        //******************************** BITS ************************************
+
+
+        // Decimal representation.
+        [[nodiscard]]
+        std::string to_string() const
+        {
+            if (is_zero()) return "0";
+            constexpr limb base = 10'000'000'000'000'000'000ull; // 10^19
+            std::string s;
+            BigInteger x = *this;
+            while (!x.is_zero())
+            {
+                limb r = x.divide_limb(base);
+                for (int i = 0; i < 19 && (!x.is_zero() || r != 0); ++i)
+                {
+                    s.push_back(static_cast<char>('0' + r % 10));
+                    r = r / 10;
+                }
+            }
+            if (negative) s.push_back('-');
+            return std::string(s.rbegin(), s.rend());
+        }
+
+
+    private:
+        std::array<limb, inline_capacity> small{};
+        Vector<limb> large;
+        size_type length = 0;
+        bool negative = false;
+
+
+        //******************************** STORAGE ************************************
+
+        // The storage is the inline array until the first time more than inline_capacity limbs are needed.
+        limb* limbs() noexcept
+        {
+            return large.size() == 0 ? small.data() : large.raw_data();
+        }
+
+        const limb* limbs() const noexcept
+        {
+            return large.size() == 0 ? small.data() : large.raw_data();
+        }
+
+        // Set the number of limbs, the new limbs are zero.
+        void resize(size_type n)
+        {
+            if (large.size() == 0 && n <= inline_capacity)
+            {
+                for (size_type i = length; i < n; ++i) small[i] = 0;
+            }
+            else if (large.size() == 0)
+            {
+                large.resize(n);
+                for (size_type i = 0; i < length; ++i) large[i] = small[i];
+            }
+            else if (large.size() < n)
+            {
+                large.resize(n);
+            }
+            else
+            {
+                for (size_type i = length; i < n; ++i) large[i] = 0;
+            }
+            length = n;
+        }
+
+        // Remove the leading zero limbs. Zero is never negative.
+        void normalize() noexcept
+        {
+            const limb* p = limbs();
+            while (length > 0 && p[length - 1] == 0) --length;
+            if (length == 0) negative = false;
+        }
+
+        void assign_limb(limb x)
+        {
+            length = 0;
+            if (x != 0)
+            {
+                resize(1);
+                limbs()[0] = x;
+            }
+        }
+
+        // Copy of the limbs [from, from + n) of a, clamped to the size of a.
+        static
+        BigInteger slice(const BigInteger& a, size_type from, size_type n)
+        {
+            BigInteger r;
+            if (from >= a.length) return r;
+            if (from + n > a.length) n = a.length - from;
+            r.resize(n);
+            const limb* ap = a.limbs() + from;
+            limb* rp = r.limbs();
+            for (size_type i = 0; i < n; ++i) rp[i] = ap[i];
+            r.normalize();
+            return r;
+        }
+
+        //******************************** STORAGE ************************************
+
+
+        //******************************** MAGNITUDE ************************************
+
+        static
+        int compare_magnitude(const BigInteger& a, const BigInteger& b) noexcept
+        {
+            if (a.length != b.length) return a.length < b.length ? -1 : 1;
+            const limb* ap = a.limbs();
+            const limb* bp = b.limbs();
+            for (size_type i = a.length; i-- > 0; )
+            {
+                if (ap[i] != bp[i]) return ap[i] < bp[i] ? -1 : 1;
+            }
+            return 0;
+        }
+
+        static
+        BigInteger add_magnitude(const BigInteger& a, const BigInteger& b)
+        {
+            const BigInteger& x = a.length < b.length ? b : a;
+            const BigInteger& y = a.length < b.length ? a : b;
+            BigInteger r;
+            r.resize(x.length + 1);
+            const limb* xp = x.limbs();
+            const limb* yp = y.limbs();
+            limb* rp = r.limbs();
+            limb carry = 0;
+            for (size_type i = 0; i < x.length; ++i)
+            {
+                unsigned __int128 s = static_cast<unsigned __int128>(xp[i]) + carry;
+                if (i < y.length) s = s + yp[i];
+                rp[i] = static_cast<limb>(s);
+                carry = static_cast<limb>(s >> 64);
+            }
+            rp[x.length] = carry;
+            r.normalize();
+            return r;
+        }
+
+        // Precondition: |a| >= |b|.
+        static
+        BigInteger subtract_magnitude(const BigInteger& a, const BigInteger& b)
+        {
+            BigInteger r;
+            r.resize(a.length);
+            const limb* ap = a.limbs();
+            const limb* bp = b.limbs();
+            limb* rp = r.limbs();
+            limb borrow = 0;
+            for (size_type i = 0; i < a.length; ++i)
+            {
+                limb y = i < b.length ? bp[i] : 0;
+                limb d = ap[i] - y - borrow;
+                borrow = (ap[i] < y || (ap[i] == y && borrow)) ? 1 : 0;
+                rp[i] = d;
+            }
+            r.normalize();
+            return r;
+        }
+
+        // |a| - |b| with the sign of a (negative_a) when |a| >= |b|, the opposite otherwise.
+        static
+        BigInteger signed_difference(const BigInteger& a, const BigInteger& b, bool negative_a)
+        {
+            int c = compare_magnitude(a, b);
+            if (c == 0) return BigInteger{};
+            BigInteger r = c > 0 ? subtract_magnitude(a, b) : subtract_magnitude(b, a);
+            r.negative = c > 0 ? negative_a : !negative_a;
+            return r;
+        }
+
+        // |*this| += |x| * 2^(64 * k).
+        void add_shifted(const BigInteger& x, size_type k)
+        {
+            if (x.is_zero()) return;
+            size_type n = x.length + k + 1;
+            if (length < n) resize(n);
+            limb* rp = limbs();
+            const limb* xp = x.limbs();
+            limb carry = 0;
+            size_type i = 0;
+            for (; i < x.length; ++i)
+            {
+                unsigned __int128 s = static_cast<unsigned __int128>(rp[i + k]) + xp[i] + carry;
+                rp[i + k] = static_cast<limb>(s);
+                carry = static_cast<limb>(s >> 64);
+            }
+            for (i = i + k; carry != 0; ++i)
+            {
+                if (i == length) resize(length + 1);
+                rp = limbs();
+                unsigned __int128 s = static_cast<unsigned __int128>(rp[i]) + carry;
+                rp[i] = static_cast<limb>(s);
+                carry = static_cast<limb>(s >> 64);
+            }
+            normalize();
+        }
+
+        // Divide the magnitude in place by d and return the remainder.
+        // Precondition: d != 0.
+        limb divide_limb(limb d)
+        {
+            limb* p = limbs();
+            unsigned __int128 r = 0;
+            for (size_type i = length; i-- > 0; )
+            {
+                unsigned __int128 cur = (r << 64) | p[i];
+                p[i] = static_cast<limb>(cur / d);
+                r = cur % d;
+            }
+            normalize();
+            return static_cast<limb>(r);
+        }
+
+        //******************************** MAGNITUDE ************************************
+
+
+        //******************************** MULTIPLICATION ************************************
+
+        static
+        BigInteger multiply_schoolbook(const BigInteger& a, const BigInteger& b)
+        {
+            BigInteger r;
+            if (a.is_zero() || b.is_zero()) return r;
+            r.resize(a.length + b.length);
+            const limb* ap = a.limbs();
+            const limb* bp = b.limbs();
+            limb* rp = r.limbs();
+            for (size_type i = 0; i < a.length; ++i)
+            {
+                limb carry = 0;
+                for (size_type j = 0; j < b.length; ++j)
+                {
+                    unsigned __int128 t = static_cast<unsigned __int128>(ap[i]) * bp[j] + rp[i + j] + carry;
+                    rp[i + j] = static_cast<limb>(t);
+                    carry = static_cast<limb>(t >> 64);
+                }
+                rp[i + b.length] = carry;
+            }
+            r.normalize();
+            return r;
+        }
+
+        // The products a[i] * a[j] with i < j are computed once and doubled, then the squares
+        // a[i] * a[i] are added.
+        static
+        BigInteger square_schoolbook(const BigInteger& a)
+        {
+            BigInteger r;
+            if (a.is_zero()) return r;
+            size_type n = a.length;
+            r.resize(2 * n);
+            const limb* ap = a.limbs();
+            limb* rp = r.limbs();
+            for (size_type i = 0; i < n; ++i)
+            {
+                limb carry = 0;
+                for (size_type j = i + 1; j < n; ++j)
+                {
+                    unsigned __int128 t = static_cast<unsigned __int128>(ap[i]) * ap[j] + rp[i + j] + carry;
+                    rp[i + j] = static_cast<limb>(t);
+                    carry = static_cast<limb>(t >> 64);
+                }
+                rp[i + n] = carry;
+            }
+            limb top = 0;
+            for (size_type i = 0; i < 2 * n; ++i)
+            {
+                limb next = rp[i] >> 63;
+                rp[i] = (rp[i] << 1) | top;
+                top = next;
+            }
+            limb carry = 0;
+            for (size_type i = 0; i < n; ++i)
+            {
+                unsigned __int128 sq = static_cast<unsigned __int128>(ap[i]) * ap[i];
+                unsigned __int128 t = static_cast<unsigned __int128>(rp[2 * i]) + static_cast<limb>(sq) + carry;
+                rp[2 * i] = static_cast<limb>(t);
+                t = static_cast<unsigned __int128>(rp[2 * i + 1]) + static_cast<limb>(sq >> 64) + (t >> 64);
+                rp[2 * i + 1] = static_cast<limb>(t);
+                carry = static_cast<limb>(t >> 64);
+            }
+            r.normalize();
+            return r;
+        }
+
+        // a = a1 B^k + a0, b = b1 B^k + b0 then
+        // a b = a1 b1 B^2k + ((a0 + a1)(b0 + b1) - a1 b1 - a0 b0) B^k + a0 b0.
+        static
+        BigInteger multiply_karatsuba(const BigInteger& a, const BigInteger& b)
+        {
+            size_type k = (a.length > b.length ? a.length : b.length) / 2;
+            BigInteger a0 = slice(a, 0, k);
+            BigInteger a1 = slice(a, k, a.length);
+            BigInteger b0 = slice(b, 0, k);
+            BigInteger b1 = slice(b, k, b.length);
+
+            BigInteger z0 = multiply_magnitude(a0, b0);
+            BigInteger z2 = multiply_magnitude(a1, b1);
+            BigInteger z1 = multiply_magnitude(add_magnitude(a0, a1), add_magnitude(b0, b1));
+            z1 = subtract_magnitude(subtract_magnitude(z1, z0), z2);
+
+            BigInteger r = z0;
+            r.add_shifted(z1, k);
+            r.add_shifted(z2, 2 * k);
+            return r;
+        }
+
+        static
+        BigInteger square_karatsuba(const BigInteger& a)
+        {
+            size_type k = a.length / 2;
+            BigInteger a0 = slice(a, 0, k);
+            BigInteger a1 = slice(a, k, a.length);
+
+            BigInteger z0 = square_magnitude(a0);
+            BigInteger z2 = square_magnitude(a1);
+            BigInteger z1 = square_magnitude(add_magnitude(a0, a1));
+            z1 = subtract_magnitude(subtract_magnitude(z1, z0), z2);
+
+            BigInteger r = z0;
+            r.add_shifted(z1, k);
+            r.add_shifted(z2, 2 * k);
+            return r;
+        }
+
+        // Exact division of a signed value by 3.
+        static
+        BigInteger divide_by_3(BigInteger a)
+        {
+            bool n = a.negative;
+            a.divide_limb(3);
+            a.negative = n && !a.is_zero();
+            return a;
+        }
+
+        // Evaluation of x2 B^2k + x1 B^k + x0 at 0, 1, -1, -2 and infinity.
+        static
+        std::array<BigInteger, 5> toom3_evaluate(const BigInteger& x0, const BigInteger& x1, const BigInteger& x2)
+        {
+            BigInteger p = x0 + x2;
+            BigInteger p1 = p + x1;
+            BigInteger pm1 = p - x1;
+            BigInteger pm2 = ((pm1 + x2) << 1) - x0;
+            return {x0, p1, pm1, pm2, x2};
+        }
+
+        // Interpolation of the values at 0, 1, -1, -2 and infinity (Bodrato sequence).
+        static
+        BigInteger toom3_interpolate(std::array<BigInteger, 5>& v, size_type k)
+        {
+            BigInteger& r0 = v[0];
+            BigInteger& r4 = v[4];
+            BigInteger r3 = divide_by_3(v[3] - v[1]);
+            BigInteger r1 = (v[1] - v[2]) >> 1;
+            BigInteger r2 = v[2] - r0;
+            r3 = ((r2 - r3) >> 1) + (r4 << 1);
+            r2 = r2 + r1 - r4;
+            r1 = r1 - r3;
+
+            // The intermediate terms may be negative, so they are added with their sign.
+            BigInteger r = r0;
+            r = r + (r1 << static_cast<int>(64 * k));
+            r = r + (r2 << static_cast<int>(128 * k));
+            r = r + (r3 << static_cast<int>(192 * k));
+            r.add_shifted(r4, 4 * k);
+            return r;
+        }
+
+        static
+        BigInteger multiply_toom3(const BigInteger& a, const BigInteger& b)
+        {
+            size_type n = a.length > b.length ? a.length : b.length;
+            size_type k = (n + 2) / 3;
+            auto pa = toom3_evaluate(slice(a, 0, k), slice(a, k, k), slice(a, 2 * k, a.length));
+            auto pb = toom3_evaluate(slice(b, 0, k), slice(b, k, k), slice(b, 2 * k, b.length));
+            std::array<BigInteger, 5> v;
+            for (size_type i = 0; i < 5; ++i) v[i] = pa[i] * pb[i];
+            return toom3_interpolate(v, k);
+        }
+
+        static
+        BigInteger square_toom3(const BigInteger& a)
+        {
+            size_type k = (a.length + 2) / 3;
+            auto pa = toom3_evaluate(slice(a, 0, k), slice(a, k, k), slice(a, 2 * k, a.length));
+            std::array<BigInteger, 5> v;
+            for (size_type i = 0; i < 5; ++i) v[i] = pa[i] * pa[i];
+            return toom3_interpolate(v, k);
+        }
+
+        // Unbalanced operands: a is cut in slices of the size of b.
+        // Precondition: b.size() <= a.size().
+        static
+        BigInteger multiply_unbalanced(const BigInteger& a, const BigInteger& b)
+        {
+            BigInteger r;
+            for (size_type i = 0; i < a.length; i += b.length)
+            {
+                r.add_shifted(multiply_magnitude(slice(a, i, b.length), b), i);
+            }
+            return r;
+        }
+
+        static
+        BigInteger multiply_magnitude(const BigInteger& a, const BigInteger& b)
+        {
+            const BigInteger& x = a.length < b.length ? b : a;
+            const BigInteger& y = a.length < b.length ? a : b;
+            if (y.length < karatsuba_threshold) return multiply_schoolbook(x, y);
+            if (2 * y.length <= x.length) return multiply_unbalanced(x, y);
+            if (y.length < toom3_threshold) return multiply_karatsuba(x, y);
+            if (3 * y.length <= 2 * x.length) return multiply_karatsuba(x, y);
+            return multiply_toom3(x, y);
+        }
+
+        static
+        BigInteger square_magnitude(const BigInteger& a)
+        {
+            if (a.length < karatsuba_threshold) return square_schoolbook(a);
+            if (a.length < toom3_threshold) return square_karatsuba(a);
+            return square_toom3(a);
+        }
+
+        //******************************** MULTIPLICATION ************************************
+
+
+        //******************************** DIVISION ************************************
+
+        // Knuth algorithm D on the magnitudes. Return {|a| / |b|, |a| % |b|}.
+        // Precondition: b != 0.
+        static
+        Pair<BigInteger, BigInteger> divide_magnitude(const BigInteger& a, const BigInteger& b)
+        {
+            using u128 = unsigned __int128;
+            using i128 = __int128;
+
+            if (compare_magnitude(a, b) < 0)
+            {
+                BigInteger r = a;
+                r.negative = false;
+                return {BigInteger{}, r};
+            }
+            if (b.length == 1)
+            {
+                BigInteger q = a;
+                q.negative = false;
+                limb r = q.divide_limb(b.limbs()[0]);
+                return {q, BigInteger{r}};
+            }
+
+            size_type n = b.length;
+            size_type m = a.length - n;
+            int s = std::countl_zero(b.limbs()[n - 1]);
+
+            // Normalize so that the top limb of the divisor has the most significant bit set.
+            BigInteger vn = b << s;
+            vn.negative = false;
+            BigInteger un = a << s;
+            un.negative = false;
+            un.resize(a.length + 1);
+            limb* u = un.limbs();
+            const limb* v = vn.limbs();
+
+            BigInteger q;
+            q.resize(m + 1);
+            limb* qp = q.limbs();
+
+            for (size_type j = m + 1; j-- > 0; )
+            {
+                u128 num = (static_cast<u128>(u[j + n]) << 64) | u[j + n - 1];
+                u128 qhat = num / v[n - 1];
+                u128 rhat = num % v[n - 1];
+                while (qhat >> 64 != 0 ||
+                       qhat * v[n - 2] > ((rhat << 64) | u[j + n - 2]))
+                {
+                    qhat = qhat - 1;
+                    rhat = rhat + v[n - 1];
+                    if (rhat >> 64 != 0) break;
+                }
+
+                // Multiply and subtract.
+                i128 k = 0;
+                i128 t = 0;
+                for (size_type i = 0; i < n; ++i)
+                {
+                    u128 p = qhat * v[i];
+                    t = static_cast<i128>(u[i + j]) - k - static_cast<i128>(static_cast<limb>(p));
+                    u[i + j] = static_cast<limb>(t);
+                    k = static_cast<i128>(p >> 64) - (t >> 64);
+                }
+                t = static_cast<i128>(u[j + n]) - k;
+                u[j + n] = static_cast<limb>(t);
+
+                qp[j] = static_cast<limb>(qhat);
+                if (t < 0)
+                {
+                    // qhat was one too big, add back.
+                    qp[j] = qp[j] - 1;
+                    u128 c = 0;
+                    for (size_type i = 0; i < n; ++i)
+                    {
+                        u128 sum = static_cast<u128>(u[i + j]) + v[i] + c;
+                        u[i + j] = static_cast<limb>(sum);
+                        c = sum >> 64;
+                    }
+                    u[j + n] = u[j + n] + static_cast<limb>(c);
+                }
+            }
+            q.normalize();
+            un.normalize();
+            return {q, un >> s};
+        }
+
+        //******************************** DIVISION ************************************
+    };
+} // namespace eop
+
+
+#endif
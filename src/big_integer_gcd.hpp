@@ -0,0 +1,91 @@
+#ifndef BIG_INTEGER_GCD_HPP
+#define BIG_INTEGER_GCD_HPP
+
+/*
+big_integer_gcd.hpp
+
+PURPOSE: GCD of BigInteger.
+
+FUNCTIONS:
+    lehmer_gcd:     GCD of multi-limb integers with one linear combination for many Euclidean steps.
+
+DESCRIPTION:
+In its own header so division.hpp does not depend on BigInteger.
+The last step, on one limb, is GCD::stein_gcd.
+
+*/
+
+#include <cstdint>
+#include <utility>
+
+#include "big_integer.hpp"
+#include "division.hpp"
+
+namespace eop
+{
+    struct BigIntegerGCD
+    {
+        // Lehmer GCD: the Euclidean quotients are computed on the leading 63 bits of a and b
+        // while they are certain to be the same as the quotients of a and b (Knuth 4.5.2 L),
+        // then the whole sequence of steps is applied with one linear combination of a and b.
+        // Each multi-limb step replaces about 30 multi-limb divisions.
+        // Precondition: a >= 0 && b >= 0
+        static
+        BigInteger lehmer_gcd(BigInteger a, BigInteger b)
+        {
+            using i128 = __int128;
+
+            if (a < b) std::swap(a, b);
+            while (b.size() > 1)
+            {
+                int shift = static_cast<int>(a.bit_width()) - 63;
+                i128 x = static_cast<i128>((a >> shift)[0]);
+                BigInteger b_high = b >> shift;
+                i128 y = b_high.is_zero() ? 0 : static_cast<i128>(b_high[0]);
+
+                // Cosequences: the leading parts of a and b are A a + B b and C a + D b.
+                i128 A = 1;
+                i128 B = 0;
+                i128 C = 0;
+                i128 D = 1;
+                while (y + C != 0 && y + D != 0)
+                {
+                    i128 q = (x + A) / (y + C);
+                    if (q != (x + B) / (y + D)) break;
+                    i128 t = A - q * C;
+                    A = C;
+                    C = t;
+                    t = B - q * D;
+                    B = D;
+                    D = t;
+                    t = x - q * y;
+                    x = y;
+                    y = t;
+                }
+
+                if (B == 0)
+                {
+                    // No certain quotient: one multi-limb division step.
+                    BigInteger r = a % b;
+                    a = std::move(b);
+                    b = std::move(r);
+                }
+                else
+                {
+                    BigInteger t = BigInteger{static_cast<std::int64_t>(A)} * a + BigInteger{static_cast<std::int64_t>(B)} * b;
+                    BigInteger w = BigInteger{static_cast<std::int64_t>(C)} * a + BigInteger{static_cast<std::int64_t>(D)} * b;
+                    a = std::move(t);
+                    b = std::move(w);
+                }
+            }
+
+            if (b.is_zero()) return a;
+            // a % b fits in one limb.
+            BigInteger r = a % b;
+            return BigInteger{GCD::stein_gcd(b[0], r.is_zero() ? std::uint64_t{0} : r[0])};
+        }
+    };
+} // namespace eop
+
+
+#endif
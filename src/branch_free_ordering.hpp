@@ -0,0 +1,270 @@
+#ifndef BRANCH_FREE_ORDERING_HPP
+#define BRANCH_FREE_ORDERING_HPP
+
+/*
+branch_free_ordering.hpp
+
+PURPOSE: selection networks without branches for arithmetic types.
+
+FUNCTIONS:
+    select_i_j:         same as Ordering::select_i_j for arithmetic T under less<T>, by value.
+    median_5_batch:     out[i] = median_5(a[i], b[i], c[i], d[i], e[i]) for i in [0, n).
+    median_5_filter:    out[i] = median_5(x[i], ..., x[i + 4]) for i in [0, n - 4).
+
+DESCRIPTION:
+The functions of Ordering minimize the number of comparisons but each comparison is a branch,
+on random data half of them are mispredicted. Here every comparison is a min or a max, that the
+compiler translates to cmov or minss/maxss, and the same network is evaluated on SIMD vectors
+(AVX2: 8 float or int32, 16 int16; AVX-512: 16 float or int32) to process independent
+quintuples in parallel.
+
+The networks use more comparisons than the ones of Ordering:
+    median_5 = median_3(e, max(min(a, b), min(c, d)), min(max(a, b), max(c, d)))
+the max of the 2 minimums can't be the smallest of a, b, c, d and the min of the 2 maximums
+can't be the largest, so the median of a, b, c, d, e is the median of the 3 remaining.
+It's 9 min/max instead of 6 comparisons, but there is no branch to mispredict.
+
+The values are returned, not references: equal values are indistinguishable so stability
+is not defined. Precondition for floating point: no NaN.
+
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "relations.hpp"
+
+namespace eop
+{
+    // simd_vector<T>: vector type, number of lanes, load, store, min and max. lanes = 0 if there is none.
+    template <typename T>
+    struct simd_vector
+    {
+        static constexpr std::size_t lanes = 0;
+    };
+
+#if defined(__AVX512F__)
+    template <>
+    struct simd_vector<float>
+    {
+        using vector = __m512;
+        static constexpr std::size_t lanes = 16;
+        static vector load(const float* p) { return _mm512_loadu_ps(p); }
+        static void store(float* p, vector x) { _mm512_storeu_ps(p, x); }
+        static vector min(vector x, vector y) { return _mm512_min_ps(x, y); }
+        static vector max(vector x, vector y) { return _mm512_max_ps(x, y); }
+    };
+
+    template <>
+    struct simd_vector<std::int32_t>
+    {
+        using vector = __m512i;
+        static constexpr std::size_t lanes = 16;
+        static vector load(const std::int32_t* p) { return _mm512_loadu_si512(p); }
+        static void store(std::int32_t* p, vector x) { _mm512_storeu_si512(p, x); }
+        static vector min(vector x, vector y) { return _mm512_min_epi32(x, y); }
+        static vector max(vector x, vector y) { return _mm512_max_epi32(x, y); }
+    };
+#elif defined(__AVX2__)
+    template <>
+    struct simd_vector<float>
+    {
+        using vector = __m256;
+        static constexpr std::size_t lanes = 8;
+        static vector load(const float* p) { return _mm256_loadu_ps(p); }
+        static void store(float* p, vector x) { _mm256_storeu_ps(p, x); }
+        static vector min(vector x, vector y) { return _mm256_min_ps(x, y); }
+        static vector max(vector x, vector y) { return _mm256_max_ps(x, y); }
+    };
+
+    template <>
+    struct simd_vector<std::int32_t>
+    {
+        using vector = __m256i;
+        static constexpr std::size_t lanes = 8;
+        static vector load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const vector*>(p)); }
+        static void store(std::int32_t* p, vector x) { _mm256_storeu_si256(reinterpret_cast<vector*>(p), x); }
+        static vector min(vector x, vector y) { return _mm256_min_epi32(x, y); }
+        static vector max(vector x, vector y) { return _mm256_max_epi32(x, y); }
+    };
+#endif
+
+#if defined(__AVX2__)
+    template <>
+    struct simd_vector<std::int16_t>
+    {
+        using vector = __m256i;
+        static constexpr std::size_t lanes = 16;
+        static vector load(const std::int16_t* p) { return _mm256_loadu_si256(reinterpret_cast<const vector*>(p)); }
+        static void store(std::int16_t* p, vector x) { _mm256_storeu_si256(reinterpret_cast<vector*>(p), x); }
+        static vector min(vector x, vector y) { return _mm256_min_epi16(x, y); }
+        static vector max(vector x, vector y) { return _mm256_max_epi16(x, y); }
+    };
+
+    template <>
+    struct simd_vector<double>
+    {
+        using vector = __m256d;
+        static constexpr std::size_t lanes = 4;
+        static vector load(const double* p) { return _mm256_loadu_pd(p); }
+        static void store(double* p, vector x) { _mm256_storeu_pd(p, x); }
+        static vector min(vector x, vector y) { return _mm256_min_pd(x, y); }
+        static vector max(vector x, vector y) { return _mm256_max_pd(x, y); }
+    };
+#endif
+
+
+    struct BranchFreeOrdering
+    {
+        template <typename T>
+        static constexpr
+        T minimum(T a, T b)
+        {
+            return b < a ? b : a;
+        }
+
+
+        template <typename T>
+        static constexpr
+        T maximum(T a, T b)
+        {
+            return b < a ? a : b;
+        }
+
+
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static constexpr
+        T select_0_2(T a, T b, less<T> = {})
+        {
+            return minimum(a, b);
+        }
+
+
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static constexpr
+        T select_1_2(T a, T b, less<T> = {})
+        {
+            return maximum(a, b);
+        }
+
+
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static constexpr
+        T select_0_3(T a, T b, T c, less<T> = {})
+        {
+            return select_0_2(select_0_2(a, b), c);
+        }
+
+
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static constexpr
+        T select_2_3(T a, T b, T c, less<T> = {})
+        {
+            return select_1_2(select_1_2(a, b), c);
+        }
+
+
+        // Median of 3.
+        template <typename V, typename Min, typename Max>
+        static constexpr
+        V median_3_network(V a, V b, V c, Min min, Max max)
+        {
+            return max(min(a, b), min(max(a, b), c));
+        }
+
+
+        // max(min(a, b), min(c, d)) and min(max(a, b), max(c, d)) are the 2nd and the 3rd
+        // of a, b, c, d in some order.
+        template <typename V, typename Min, typename Max>
+        static constexpr
+        V median_5_network(V a, V b, V c, V d, V e, Min min, Max max)
+        {
+            V f = max(min(a, b), min(c, d));
+            V g = min(max(a, b), max(c, d));
+            return median_3_network(e, f, g, min, max);
+        }
+
+
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static constexpr
+        T select_1_3(T a, T b, T c, less<T> = {})
+        {
+            return median_3_network(a, b, c, minimum<T>, maximum<T>);
+        }
+
+
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static constexpr
+        T select_1_4(T a, T b, T c, T d, less<T> = {})
+        {
+            return minimum(maximum(minimum(a, b), minimum(c, d)), minimum(maximum(a, b), maximum(c, d)));
+        }
+
+
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static constexpr
+        T select_2_4(T a, T b, T c, T d, less<T> = {})
+        {
+            return maximum(maximum(minimum(a, b), minimum(c, d)), minimum(maximum(a, b), maximum(c, d)));
+        }
+
+
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static constexpr
+        T median_5(T a, T b, T c, T d, T e, less<T> = {})
+        {
+            return median_5_network(a, b, c, d, e, minimum<T>, maximum<T>);
+        }
+
+
+        // Precondition: readable ranges [a, a + n), ..., [e, e + n) && writable_weak_range(out, n)
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static
+        void median_5_batch(const T* a, const T* b, const T* c, const T* d, const T* e, std::size_t n, T* out)
+        {
+            std::size_t i = 0;
+            if constexpr (simd_vector<T>::lanes > 0)
+            {
+                using S = simd_vector<T>;
+                for (; i + S::lanes <= n; i += S::lanes)
+                {
+                    S::store(out + i, median_5_network(S::load(a + i), S::load(b + i), S::load(c + i),
+                                                       S::load(d + i), S::load(e + i), S::min, S::max));
+                }
+            }
+            for (; i < n; ++i)
+            {
+                out[i] = median_5(a[i], b[i], c[i], d[i], e[i]);
+            }
+        }
+
+
+        // Median filter of width 5: the windows of consecutive outputs overlap, the 5 loads
+        // at offsets 0, ..., 4 give the 5 elements of S::lanes windows.
+        // Precondition: readable_bounded_range(x, x + n) && n >= 5 && writable_weak_range(out, n - 4)
+        template <typename T>
+            requires std::is_arithmetic_v<T>
+        static
+        void median_5_filter(const T* x, std::size_t n, T* out)
+        {
+            median_5_batch(x, x + 1, x + 2, x + 3, x + 4, n - 4, out);
+        }
+    };
+} // namespace eop
+
+
+#endif
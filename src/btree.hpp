@@ -0,0 +1,974 @@
+#ifndef BTREE_HPP
+#define BTREE_HPP
+
+/*
+btree.hpp
+
+PURPOSE: sorted map and set of unique keys in a B-tree of nodes of a few cache lines.
+
+CLASSES:
+    simd_rank:              number of the elements of a node less than a key, with vector comparisons.
+    BTreeNode:              keys and values of a node, its parent and its position in the parent.
+    BTreeInternal:          node with successors and the weights of their subtrees.
+    BTreeIterator:          bidirectional iterator on the elements of a BTree in increasing order.
+    BTree:                  B-tree ordered by a weak ordering of the keys.
+    BTreeMap, BTreeSet:     BTree with and without values.
+
+DESCRIPTION:
+A node holds up to capacity - 1 keys, capacity = 256 / sizeof(K) (at least 8): 256 bytes of keys,
+4 cache lines, instead of one key per node in a binary tree. The height is about log(n) / log(capacity / 2),
+5 nodes for 10^7 keys of 4 bytes instead of about 30 for a red black tree: few cache misses per
+search, and the keys of a node are compared in contiguous memory. Every node except the root has
+at least minimum = capacity / 2 - 1 keys: insert splits a full node and moves its median key up,
+erase borrows a key from a sibling or merges two siblings.
+
+The search in a node counts the keys less than x. For the keys of simd_rank (32 and 64 bits
+integers, float, double) ordered by less<K> it's a sequence of vector comparisons and a popcount,
+without branches on the keys; for the other keys it's a binary search with the relation.
+
+An internal node keeps the weights (number of elements) of the subtrees of its successors, updated
+along the path of each insertion and erasure: select (the element of a given rank) and rank are
+O(log(n)).
+
+assign_sorted_n builds the tree from a sorted range without comparisons, level by level, with the
+nodes filled to capacity - 1 keys and the remainder distributed evenly.
+
+For 10^7 random 32 bits keys (test_btree.cpp): the lookups are 20% faster than a binary search in
+a sorted vector and 7 times faster than in std::set, the insertions 5 times faster than in
+std::set (and O(log(n)) instead of O(n) in the vector). The bulk load of the sorted keys takes
+90 ms, the insertions one by one 4.5 s.
+
+The tree owns its nodes: it's movable, not copyable. The root pointer is on the heap, the end
+iterator points to it: the iterators stay valid when the tree is moved, and while their element
+is in the tree and no insertion or erasure happens (a split or a merge moves the elements).
+
+*/
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "iterator.hpp"
+#include "ordering_concepts.hpp"
+#include "pair.hpp"
+#include "relations.hpp"
+#include "type_concepts.hpp"
+#include "type_traits.hpp"
+#include "vector.hpp"
+
+namespace eop
+{
+    // simd_rank<T>: number of lanes, and less_mask(p, x) with the bit i set if p[i] < x for i < lanes.
+    // lanes = 0 if there is none.
+    template <typename T>
+    struct simd_rank
+    {
+        static constexpr int lanes = 0;
+    };
+
+#if defined(__AVX512F__)
+    template <>
+    struct simd_rank<std::int32_t>
+    {
+        static constexpr int lanes = 16;
+        static unsigned less_mask(const std::int32_t* p, std::int32_t x)
+        {
+            return _mm512_cmplt_epi32_mask(_mm512_loadu_si512(p), _mm512_set1_epi32(x));
+        }
+    };
+
+    template <>
+    struct simd_rank<std::int64_t>
+    {
+        static constexpr int lanes = 8;
+        static unsigned less_mask(const std::int64_t* p, std::int64_t x)
+        {
+            return _mm512_cmplt_epi64_mask(_mm512_loadu_si512(p), _mm512_set1_epi64(x));
+        }
+    };
+
+    template <>
+    struct simd_rank<float>
+    {
+        static constexpr int lanes = 16;
+        static unsigned less_mask(const float* p, float x)
+        {
+            return _mm512_cmp_ps_mask(_mm512_loadu_ps(p), _mm512_set1_ps(x), _CMP_LT_OQ);
+        }
+    };
+
+    template <>
+    struct simd_rank<double>
+    {
+        static constexpr int lanes = 8;
+        static unsigned less_mask(const double* p, double x)
+        {
+            return _mm512_cmp_pd_mask(_mm512_loadu_pd(p), _mm512_set1_pd(x), _CMP_LT_OQ);
+        }
+    };
+#elif defined(__AVX2__)
+    template <>
+    struct simd_rank<std::int32_t>
+    {
+        static constexpr int lanes = 8;
+        static unsigned less_mask(const std::int32_t* p, std::int32_t x)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(x), a))));
+        }
+    };
+
+    template <>
+    struct simd_rank<std::int64_t>
+    {
+        static constexpr int lanes = 4;
+        static unsigned less_mask(const std::int64_t* p, std::int64_t x)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_set1_epi64x(x), a))));
+        }
+    };
+
+    template <>
+    struct simd_rank<float>
+    {
+        static constexpr int lanes = 8;
+        static unsigned less_mask(const float* p, float x)
+        {
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(x), _CMP_LT_OQ)));
+        }
+    };
+
+    template <>
+    struct simd_rank<double>
+    {
+        static constexpr int lanes = 4;
+        static unsigned less_mask(const double* p, double x)
+        {
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(x), _CMP_LT_OQ)));
+        }
+    };
+#endif
+
+
+    // Maximum number of keys of a node + 1: 256 bytes of keys, a multiple of the lanes of simd_rank.
+    template <typename K>
+    inline constexpr int btree_capacity = sizeof(K) <= 32 ? static_cast<int>(256 / sizeof(K)) : 8;
+
+
+    template <typename V, int N>
+    struct btree_values
+    {
+        V v[N]{};
+    };
+
+    template <int N>
+    struct btree_values<void, N>
+    {
+
+    };
+
+
+    template <typename K, typename V, int N>
+    struct BTreeInternal;
+
+
+    // The keys [size, N) are value initialized or moved from: the vector comparisons read them.
+    template <typename K, typename V, int N>
+    struct BTreeNode
+    {
+        BTreeInternal<K, V, N>* parent = nullptr;
+        std::uint16_t size = 0;
+        std::uint16_t position = 0; // index of the node in the successors of its parent
+        bool leaf = true;
+        K keys[N]{};
+        [[no_unique_address]] btree_values<V, N> values;
+    };
+
+
+    // The successor i has the keys between keys[i - 1] and keys[i], weights[i] elements.
+    template <typename K, typename V, int N>
+    struct BTreeInternal : BTreeNode<K, V, N>
+    {
+        BTreeInternal()
+        {
+            this->leaf = false;
+        }
+
+        BTreeNode<K, V, N>* children[N + 1]{};
+        std::size_t weights[N + 1]{};
+    };
+
+
+
+    template <typename K, typename V, weak_ordering_relation R>
+        requires regular<K> && std::same_as<domain_t<R>, K>
+    class BTree;
+
+
+    template <typename K, typename V, int N>
+    class BTreeIterator
+    {
+    public:
+        using value_type = std::conditional_t<std::is_void_v<V>, K, Pair<K, V>>;
+        using distance_type = std::size_t;
+        using iterator_tag = bidirectional_iterator_tag;
+
+        BTreeIterator() = default;
+
+
+        // Precondition: the iterator is not the end
+        [[nodiscard]]
+        value_type operator*() const
+        {
+            if constexpr (std::is_void_v<V>)
+            {
+                return n->keys[i];
+            }
+            else
+            {
+                return {n->keys[i], n->values.v[i]};
+            }
+        }
+
+        // Precondition: the iterator is not the end
+        [[nodiscard]]
+        const K& key() const noexcept
+        {
+            return n->keys[i];
+        }
+
+        // Precondition: the iterator is not the end
+        [[nodiscard]]
+        auto& value() const noexcept
+            requires (!std::is_void_v<V>)
+        {
+            return n->values.v[i];
+        }
+
+
+        // Precondition: the iterator is not the end
+        BTreeIterator& operator++() noexcept
+        {
+            if (!n->leaf)
+            {
+                n = successor(n, i + 1);
+                while (!n->leaf) n = successor(n, 0);
+                i = 0;
+                return *this;
+            }
+            ++i;
+            while (i == n->size)
+            {
+                if (n->parent == nullptr)
+                {
+                    n = nullptr;
+                    i = 0;
+                    return *this;
+                }
+                i = n->position;
+                n = n->parent;
+            }
+            return *this;
+        }
+
+        BTreeIterator operator++(int) noexcept
+        {
+            BTreeIterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        // Precondition: the iterator is not the first
+        BTreeIterator& operator--() noexcept
+        {
+            if (n == nullptr || !n->leaf)
+            {
+                n = n == nullptr ? *root : successor(n, i);
+                while (!n->leaf) n = successor(n, n->size);
+                i = n->size - 1;
+                return *this;
+            }
+            if (i > 0)
+            {
+                --i;
+                return *this;
+            }
+            while (n->position == 0) n = n->parent;
+            i = n->position - 1;
+            n = n->parent;
+            return *this;
+        }
+
+        BTreeIterator operator--(int) noexcept
+        {
+            BTreeIterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        // The iterators of different trees are not compared.
+        friend
+        bool operator==(const BTreeIterator& x, const BTreeIterator& y) noexcept
+        {
+            return x.n == y.n && x.i == y.i;
+        }
+
+    private:
+        template <typename K0, typename V0, weak_ordering_relation R>
+            requires regular<K0> && std::same_as<domain_t<R>, K0>
+        friend class BTree;
+
+        using node_type = BTreeNode<K, V, N>;
+
+        BTreeIterator(node_type* n, int i, node_type* const* root) : n(n), i(i), root(root) {}
+
+        static node_type* successor(node_type* x, int j) noexcept
+        {
+            return static_cast<BTreeInternal<K, V, N>*>(x)->children[j];
+        }
+
+        node_type* n = nullptr; // nullptr at the end
+        int i = 0;
+        node_type* const* root = nullptr;
+    };
+
+
+
+    template <typename K, typename V, weak_ordering_relation R>
+        requires regular<K> && std::same_as<domain_t<R>, K>
+    class BTree
+    {
+    public:
+        static constexpr int capacity = btree_capacity<K>;
+        static constexpr int minimum = capacity / 2 - 1;
+
+        using key_type = K;
+        using mapped_type = V;
+        using weight_type = std::size_t;
+        using iterator = BTreeIterator<K, V, capacity>;
+        using value_type = typename iterator::value_type;
+        using node_type = BTreeNode<K, V, capacity>;
+        using internal_type = BTreeInternal<K, V, capacity>;
+
+        explicit BTree(R r = R{}) : root(std::make_unique<node_type*>(nullptr)), r(r) {}
+
+        // The moved-from tree gets a new root cell: it is empty and usable.
+        BTree(BTree&& x) noexcept : root(std::move(x.root)), n(x.n), r(x.r)
+        {
+            x.root = std::make_unique<node_type*>(nullptr);
+            x.n = 0;
+        }
+
+        BTree& operator=(BTree&& x) noexcept
+        {
+            if (this != &x)
+            {
+                clear();
+                root = std::move(x.root);
+                n = x.n;
+                r = x.r;
+                x.root = std::make_unique<node_type*>(nullptr);
+                x.n = 0;
+            }
+            return *this;
+        }
+
+        ~BTree()
+        {
+            clear();
+        }
+
+
+        [[nodiscard]]
+        weight_type size() const noexcept
+        {
+            return n;
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+            return n == 0;
+        }
+
+        [[nodiscard]]
+        iterator begin() const noexcept
+        {
+            node_type* c = *root;
+            if (c == nullptr) return end();
+            while (!c->leaf) c = successor(c, 0);
+            return {c, 0, root.get()};
+        }
+
+        [[nodiscard]]
+        iterator end() const noexcept
+        {
+            return {nullptr, 0, root.get()};
+        }
+
+
+        [[nodiscard]]
+        iterator find(const K& x) const
+        {
+            node_type* c = *root;
+            while (c != nullptr)
+            {
+                int i = rank_in_node(c, x);
+                if (i < c->size && !r(x, c->keys[i])) return {c, i, root.get()};
+                if (c->leaf) break;
+                c = successor(c, i);
+            }
+            return end();
+        }
+
+        [[nodiscard]]
+        bool contains(const K& x) const
+        {
+            return find(x) != end();
+        }
+
+        // The first element whose key is not less than x.
+        [[nodiscard]]
+        iterator lower_bound(const K& x) const
+        {
+            return bound(x, false);
+        }
+
+        // The first element whose key is greater than x.
+        [[nodiscard]]
+        iterator upper_bound(const K& x) const
+        {
+            return bound(x, true);
+        }
+
+
+        // Inserts x if there's no equivalent key: returns its position and true, else the position
+        // of the equivalent key and false.
+        Pair<iterator, bool> insert(const K& x)
+            requires std::is_void_v<V>
+        {
+            return insert_key(x);
+        }
+
+        // Inserts x with the value v if there's no equivalent key, else the value is unchanged.
+        template <typename W = V>
+            requires (!std::is_void_v<W>)
+        Pair<iterator, bool> insert(const K& x, const W& v)
+        {
+            Pair<iterator, bool> p = insert_key(x);
+            if (p.second) p.first.value() = v;
+            return p;
+        }
+
+        // The value of x, inserted value initialized if there's no equivalent key.
+        auto& operator[](const K& x)
+            requires (!std::is_void_v<V>)
+        {
+            return insert_key(x).first.value();
+        }
+
+
+        // Erases the element of key x: returns false if there's none.
+        bool erase(const K& x)
+        {
+            iterator i = find(x);
+            if (i == end()) return false;
+            erase(i);
+            return true;
+        }
+
+        // Precondition: i is an element of the tree
+        void erase(iterator i)
+        {
+            node_type* c = i.n;
+            int j = i.i;
+            if (!c->leaf)
+            {
+                // The predecessor, in a leaf, replaces the key.
+                node_type* l = successor(c, j);
+                while (!l->leaf) l = successor(l, l->size);
+                c->keys[j] = std::move(l->keys[l->size - 1]);
+                if constexpr (!std::is_void_v<V>) c->values.v[j] = std::move(l->values.v[l->size - 1]);
+                c = l;
+                j = l->size - 1;
+            }
+            move_elements(c, j + 1, c, j, c->size - j - 1);
+            --c->size;
+            for (node_type* a = c; a->parent != nullptr; a = a->parent) --a->parent->weights[a->position];
+            --n;
+            rebalance(c);
+        }
+
+        void clear() noexcept
+        {
+            if (root != nullptr && *root != nullptr)
+            {
+                destroy(*root);
+                *root = nullptr;
+            }
+            n = 0;
+        }
+
+
+        // The element of rank k, the first one has rank 0.
+        // Precondition: k < size()
+        [[nodiscard]]
+        iterator select(weight_type k) const noexcept
+        {
+            node_type* c = *root;
+            while (!c->leaf)
+            {
+                internal_type* a = static_cast<internal_type*>(c);
+                int i = 0;
+                while (k >= a->weights[i])
+                {
+                    if (k == a->weights[i]) return {c, i, root.get()};
+                    k = k - a->weights[i] - 1;
+                    ++i;
+                }
+                c = a->children[i];
+            }
+            return {c, static_cast<int>(k), root.get()};
+        }
+
+        // Number of elements less than x.
+        [[nodiscard]]
+        weight_type rank(const K& x) const
+        {
+            weight_type k = 0;
+            node_type* c = *root;
+            while (c != nullptr)
+            {
+                int i = rank_in_node(c, x);
+                k = k + weight_type(i);
+                if (c->leaf) break;
+                internal_type* a = static_cast<internal_type*>(c);
+                for (int j = 0; j < i; ++j) k = k + a->weights[j];
+                if (i < c->size && !r(x, c->keys[i])) return k + a->weights[i];
+                c = a->children[i];
+            }
+            return k;
+        }
+
+
+        // Replaces the elements by the n elements of [f, f + n), *f is a value_type.
+        // Precondition: readable_weak_range(f, n) && the keys are strictly increasing
+        template <typename I>
+        void assign_sorted_n(I f, weight_type m)
+        {
+            clear();
+            if (m == 0) return;
+            n = m;
+
+            // The leaves, a separator after each leaf except the last. l leaves of at most
+            // capacity - 1 keys: each leaf and its separator take at most capacity elements.
+            weight_type l = (m + 1 + capacity - 1) / capacity;
+            Vector<node_type*> level;
+            Vector<weight_type> weights;
+            Vector<value_type> separators;
+            level.reserve(l);
+            weights.reserve(l);
+            separators.reserve(l);
+            weight_type q = (m - (l - 1)) / l;
+            weight_type extra = (m - (l - 1)) % l;
+            for (weight_type j = 0; j < l; ++j)
+            {
+                node_type* c = new node_type;
+                int k = static_cast<int>(q + (j < extra ? 1 : 0));
+                for (int i = 0; i < k; ++i, ++f) put(c, i, *f);
+                c->size = static_cast<std::uint16_t>(k);
+                level.emplace_back(c);
+                weights.emplace_back(weight_type(k));
+                if (j + 1 < l)
+                {
+                    separators.emplace_back(*f);
+                    ++f;
+                }
+            }
+
+            // The upper levels: l nodes of l - 1 separators become nodes of at most capacity successors.
+            while (level.size() > 1)
+            {
+                l = level.size();
+                weight_type u = (l + capacity - 1) / capacity;
+                q = l / u;
+                extra = l % u;
+                Vector<node_type*> up;
+                Vector<weight_type> up_weights;
+                Vector<value_type> up_separators;
+                weight_type child = 0;
+                weight_type s = 0;
+                for (weight_type j = 0; j < u; ++j)
+                {
+                    internal_type* a = new internal_type;
+                    int k = static_cast<int>(q + (j < extra ? 1 : 0));
+                    weight_type w = weight_type(k - 1);
+                    for (int i = 0; i < k; ++i, ++child)
+                    {
+                        if (i > 0) put(a, i - 1, separators[s++]);
+                        a->children[i] = level[child];
+                        a->weights[i] = weights[child];
+                        level[child]->parent = a;
+                        level[child]->position = static_cast<std::uint16_t>(i);
+                        w = w + weights[child];
+                    }
+                    a->size = static_cast<std::uint16_t>(k - 1);
+                    up.emplace_back(a);
+                    up_weights.emplace_back(w);
+                    if (j + 1 < u) up_separators.emplace_back(separators[s++]);
+                }
+                level = std::move(up);
+                weights = std::move(up_weights);
+                separators = std::move(up_separators);
+            }
+            *root = level[0];
+        }
+
+        // Number of levels of nodes.
+        [[nodiscard]]
+        int height() const noexcept
+        {
+            int h = 0;
+            for (node_type* c = *root; c != nullptr; c = c->leaf ? nullptr : successor(c, 0)) ++h;
+            return h;
+        }
+
+    private:
+        static node_type* successor(node_type* c, int i) noexcept
+        {
+            return static_cast<internal_type*>(c)->children[i];
+        }
+
+        // Number of keys of c less than x.
+        [[nodiscard]]
+        int rank_in_node(const node_type* c, const K& x) const
+        {
+            int m = c->size;
+            if constexpr (std::same_as<R, less<K>> && simd_rank<K>::lanes > 0)
+            {
+                using S = simd_rank<K>;
+                int k = 0;
+                for (int i = 0; i < m; i += S::lanes)
+                {
+                    unsigned b = S::less_mask(c->keys + i, x);
+                    if (m - i < S::lanes) b = b & ((1u << (m - i)) - 1);
+                    k = k + std::popcount(b);
+                }
+                return k;
+            }
+            else
+            {
+                int f = 0;
+                while (m > 0)
+                {
+                    int h = m / 2;
+                    if (r(c->keys[f + h], x))
+                    {
+                        f = f + h + 1;
+                        m = m - h - 1;
+                    }
+                    else
+                    {
+                        m = h;
+                    }
+                }
+                return f;
+            }
+        }
+
+        [[nodiscard]]
+        iterator bound(const K& x, bool upper) const
+        {
+            iterator b = end();
+            node_type* c = *root;
+            while (c != nullptr)
+            {
+                int i = rank_in_node(c, x);
+                if (i < c->size && !r(x, c->keys[i]))
+                {
+                    // The keys are unique: the upper bound is the next element.
+                    iterator j{c, i, root.get()};
+                    return upper ? ++j : j;
+                }
+                if (i < c->size) b = iterator{c, i, root.get()};
+                if (c->leaf) break;
+                c = successor(c, i);
+            }
+            return b;
+        }
+
+        static void put(node_type* c, int i, const value_type& x)
+        {
+            if constexpr (std::is_void_v<V>)
+            {
+                c->keys[i] = x;
+            }
+            else
+            {
+                c->keys[i] = x.first;
+                c->values.v[i] = x.second;
+            }
+        }
+
+        // Moves the k elements [i, i + k) of a to [j, j + k) of b, a == b is allowed.
+        static void move_elements(node_type* a, int i, node_type* b, int j, int k)
+        {
+            if (a == b && j > i)
+            {
+                std::move_backward(a->keys + i, a->keys + i + k, b->keys + j + k);
+                if constexpr (!std::is_void_v<V>) std::move_backward(a->values.v + i, a->values.v + i + k, b->values.v + j + k);
+            }
+            else
+            {
+                std::move(a->keys + i, a->keys + i + k, b->keys + j);
+                if constexpr (!std::is_void_v<V>) std::move(a->values.v + i, a->values.v + i + k, b->values.v + j);
+            }
+        }
+
+        // Moves the k successors [i, i + k) of a to [j, j + k) of b, a == b is allowed.
+        static void move_successors(internal_type* a, int i, internal_type* b, int j, int k)
+        {
+            if (a == b && j > i)
+            {
+                std::move_backward(a->children + i, a->children + i + k, b->children + j + k);
+                std::move_backward(a->weights + i, a->weights + i + k, b->weights + j + k);
+            }
+            else
+            {
+                std::move(a->children + i, a->children + i + k, b->children + j);
+                std::move(a->weights + i, a->weights + i + k, b->weights + j);
+            }
+            for (int t = j; t < j + k; ++t)
+            {
+                b->children[t]->parent = b;
+                b->children[t]->position = static_cast<std::uint16_t>(t);
+            }
+        }
+
+        static weight_type node_weight(const node_type* c) noexcept
+        {
+            weight_type w = c->size;
+            if (!c->leaf)
+            {
+                const internal_type* a = static_cast<const internal_type*>(c);
+                for (int i = 0; i <= c->size; ++i) w = w + a->weights[i];
+            }
+            return w;
+        }
+
+        static void destroy(node_type* c) noexcept
+        {
+            if (c->leaf)
+            {
+                delete c;
+                return;
+            }
+            internal_type* a = static_cast<internal_type*>(c);
+            for (int i = 0; i <= c->size; ++i) destroy(a->children[i]);
+            delete a;
+        }
+
+
+        Pair<iterator, bool> insert_key(const K& x)
+        {
+            node_type*& t = *root;
+            if (t == nullptr)
+            {
+                t = new node_type;
+            }
+            node_type* c = t;
+            int i;
+            while (true)
+            {
+                i = rank_in_node(c, x);
+                if (i < c->size && !r(x, c->keys[i])) return {iterator{c, i, root.get()}, false};
+                if (c->leaf) break;
+                c = successor(c, i);
+            }
+
+            move_elements(c, i, c, i + 1, c->size - i);
+            c->keys[i] = x;
+            if constexpr (!std::is_void_v<V>) c->values.v[i] = V{};
+            ++c->size;
+            for (node_type* a = c; a->parent != nullptr; a = a->parent) ++a->parent->weights[a->position];
+            ++n;
+
+            // The nodes of capacity keys are split, the element of x is followed up.
+            node_type* a = c;
+            while (a->size == capacity) a = split(a, c, i);
+            return {iterator{c, i, root.get()}, true};
+        }
+
+        // Splits the full node a in two and inserts its median key in its parent, returns the parent.
+        // The element (c, i) is updated if it moves.
+        internal_type* split(node_type* a, node_type*& c, int& i)
+        {
+            internal_type* p = a->parent;
+            if (p == nullptr)
+            {
+                p = new internal_type;
+                p->children[0] = a;
+                p->weights[0] = node_weight(a);
+                a->parent = p;
+                a->position = 0;
+                *root = p;
+            }
+            constexpr int m = capacity / 2;
+            node_type* b = a->leaf ? new node_type : new internal_type;
+            move_elements(a, m + 1, b, 0, capacity - m - 1);
+            if (!a->leaf)
+            {
+                move_successors(static_cast<internal_type*>(a), m + 1, static_cast<internal_type*>(b), 0, capacity - m);
+            }
+            b->size = static_cast<std::uint16_t>(capacity - m - 1);
+            a->size = static_cast<std::uint16_t>(m);
+
+            int k = a->position;
+            move_elements(p, k, p, k + 1, p->size - k);
+            move_successors(p, k + 1, p, k + 2, p->size - k);
+            move_elements(a, m, p, k, 1);
+            p->children[k + 1] = b;
+            b->parent = p;
+            b->position = static_cast<std::uint16_t>(k + 1);
+            ++p->size;
+            weight_type w = node_weight(b);
+            p->weights[k] = p->weights[k] - w - 1;
+            p->weights[k + 1] = w;
+
+            if (c == a && i == m)
+            {
+                c = p;
+                i = k;
+            }
+            else if (c == a && i > m)
+            {
+                c = b;
+                i = i - m - 1;
+            }
+            return p;
+        }
+
+        // Restores the minimum number of keys from c up.
+        void rebalance(node_type* c)
+        {
+            while (c->parent != nullptr && c->size < minimum)
+            {
+                internal_type* p = c->parent;
+                int k = c->position;
+                if (k > 0 && p->children[k - 1]->size > minimum)
+                {
+                    borrow_left(p, k);
+                    return;
+                }
+                if (k < p->size && p->children[k + 1]->size > minimum)
+                {
+                    borrow_right(p, k);
+                    return;
+                }
+                merge(p, k > 0 ? k - 1 : k);
+                c = p;
+            }
+            node_type*& t = *root;
+            if (t->size == 0)
+            {
+                node_type* s = t->leaf ? nullptr : successor(t, 0);
+                if (t->leaf) delete t;
+                else delete static_cast<internal_type*>(t);
+                t = s;
+                if (s != nullptr)
+                {
+                    s->parent = nullptr;
+                    s->position = 0;
+                }
+            }
+        }
+
+        // The last key of the successor k - 1 of p goes up, the key k - 1 of p goes down to the successor k.
+        void borrow_left(internal_type* p, int k)
+        {
+            node_type* l = p->children[k - 1];
+            node_type* c = p->children[k];
+            move_elements(c, 0, c, 1, c->size);
+            move_elements(p, k - 1, c, 0, 1);
+            move_elements(l, l->size - 1, p, k - 1, 1);
+            weight_type w = 0;
+            if (!c->leaf)
+            {
+                internal_type* a = static_cast<internal_type*>(c);
+                move_successors(a, 0, a, 1, c->size + 1);
+                w = static_cast<internal_type*>(l)->weights[l->size];
+                move_successors(static_cast<internal_type*>(l), l->size, a, 0, 1);
+            }
+            --l->size;
+            ++c->size;
+            p->weights[k - 1] = p->weights[k - 1] - w - 1;
+            p->weights[k] = p->weights[k] + w + 1;
+        }
+
+        // The first key of the successor k + 1 of p goes up, the key k of p goes down to the successor k.
+        void borrow_right(internal_type* p, int k)
+        {
+            node_type* c = p->children[k];
+            node_type* s = p->children[k + 1];
+            move_elements(p, k, c, c->size, 1);
+            move_elements(s, 0, p, k, 1);
+            move_elements(s, 1, s, 0, s->size - 1);
+            weight_type w = 0;
+            if (!c->leaf)
+            {
+                internal_type* a = static_cast<internal_type*>(s);
+                w = a->weights[0];
+                move_successors(a, 0, static_cast<internal_type*>(c), c->size + 1, 1);
+                move_successors(a, 1, a, 0, s->size);
+            }
+            ++c->size;
+            --s->size;
+            p->weights[k] = p->weights[k] + w + 1;
+            p->weights[k + 1] = p->weights[k + 1] - w - 1;
+        }
+
+        // The successors k and k + 1 of p and the key k of p become the successor k.
+        void merge(internal_type* p, int k)
+        {
+            node_type* a = p->children[k];
+            node_type* b = p->children[k + 1];
+            move_elements(p, k, a, a->size, 1);
+            move_elements(b, 0, a, a->size + 1, b->size);
+            if (!a->leaf)
+            {
+                move_successors(static_cast<internal_type*>(b), 0, static_cast<internal_type*>(a), a->size + 1, b->size + 1);
+            }
+            a->size = static_cast<std::uint16_t>(a->size + 1 + b->size);
+            p->weights[k] = p->weights[k] + p->weights[k + 1] + 1;
+            move_elements(p, k + 1, p, k, p->size - k - 1);
+            move_successors(p, k + 2, p, k + 1, p->size - k - 1);
+            --p->size;
+            if (b->leaf) delete b;
+            else delete static_cast<internal_type*>(b);
+        }
+
+
+        std::unique_ptr<node_type*> root;
+        weight_type n = 0;
+        R r;
+    };
+
+
+    template <typename K, typename V, weak_ordering_relation R = less<K>>
+    using BTreeMap = BTree<K, V, R>;
+
+    template <typename K, weak_ordering_relation R = less<K>>
+    using BTreeSet = BTree<K, void, R>;
+} // namespace eop
+
+
+#endif
@@ -0,0 +1,380 @@
+#ifndef CONCURRENT_HASH_MAP_HPP
+#define CONCURRENT_HASH_MAP_HPP
+
+/*
+concurrent_hash_map.hpp
+
+PURPOSE: hash map shared by threads: lock striped writes, optimistic reads validated by a version.
+
+CLASSES:
+    ConcurrentHashMap:      map of unique keys, find, insert_or_get, get_or_compute and erase
+                            called concurrently.
+
+DESCRIPTION:
+The keys are distributed over shards (stripes) by their hash: each shard is an open addressing
+table with linear probing, a mutex and a version, aligned on a cache line. The writers of a shard
+(insert_or_get, erase) lock its mutex; the writers of different shards don't interact.
+
+The version is a sequence lock: a writer makes it odd before modifying the table and even after.
+find reads the version, searches the table without a lock and reads the version again: if it is
+the same even number no writer ran in between and the result is consistent, else find retries,
+and locks the mutex after a few attempts so that a stream of writers can't starve it. A read
+writes no shared memory: the readers of a shard don't invalidate each other's cache lines, the
+90% of reads of a memo table scale with the threads.
+
+The optimistic reads need keys and values read atomically: std::atomic<T> lock free (integers,
+pointers, small trivially copyable structs). The keys, values and control bytes are relaxed
+atomics, the fences of the sequence lock order them. A rehash publishes the new table with a
+release store of the current table, find loads it with acquire: the construction of the table is
+visible before the probe. For the other types find locks the mutex.
+
+A reader may still search a table that a writer replaced by a larger one: the tables of a
+shard are freed with the map (at most twice the size of the current table per capacity, a rehash
+to the same capacity reuses the previous table of that capacity). Without the optimistic reads
+the old tables are freed at once.
+
+erase marks a slot empty if the next slot is empty (no probe went past it), else deleted. A shard
+is at most 3/4 full (elements and deleted slots), then it's rehashed: to twice the capacity if
+the elements fill more than half of the limit, else to the same capacity.
+
+get_or_compute is the memoization: the value is computed without a lock, by each thread that
+misses, the first insertion wins and every caller gets its value.
+
+For the throughput of 90% finds and 10% insertions or erasures against std::unordered_map
+behind a mutex, see test_concurrent_hash_map.cpp: twice the throughput in one thread.
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "pair.hpp"
+#include "relation_concepts.hpp"
+#include "relations.hpp"
+#include "type_concepts.hpp"
+#include "type_traits.hpp"
+#include "vector.hpp"
+
+namespace eop
+{
+    template <typename T>
+    concept atomic_lock_free = std::is_trivially_copyable_v<T> && std::atomic<T>::is_always_lock_free;
+
+
+    template <typename K, typename V, typename H = std::hash<K>, relation E = equal<K>>
+        requires regular<K> && regular<V> && std::same_as<domain_t<E>, K>
+    class ConcurrentHashMap
+    {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+
+        // Optimistic finds, without a lock.
+        static constexpr bool optimistic = atomic_lock_free<K> && atomic_lock_free<V>;
+
+        // shards is rounded up to a power of 2.
+        explicit ConcurrentHashMap(std::size_t shards = 256, H hash = H{}, E e = E{})
+            : shard_count(std::bit_ceil(shards == 0 ? std::size_t{1} : shards)),
+              shards(std::make_unique<shard[]>(shard_count)), hash(hash), e(e)
+        {
+
+        }
+
+
+        [[nodiscard]]
+        std::optional<V> find(const K& x) const
+        {
+            std::uint64_t h = mix(x);
+            shard& s = shard_of(h);
+            if constexpr (optimistic)
+            {
+                for (int attempt = 0; attempt < 4; ++attempt)
+                {
+                    std::uint64_t v = s.version.load(std::memory_order_acquire);
+                    if ((v & 1) != 0) continue;
+                    const table* t = s.current.load(std::memory_order_acquire);
+                    std::size_t i = t == nullptr ? npos : probe(t, x, h);
+                    V y = i == npos ? V{} : load<V>(t->values[i]);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (s.version.load(std::memory_order_relaxed) == v)
+                    {
+                        return i == npos ? std::nullopt : std::optional<V>(y);
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(s.mutex);
+            const table* t = s.current.load(std::memory_order_relaxed);
+            std::size_t i = t == nullptr ? npos : probe(t, x, h);
+            return i == npos ? std::nullopt : std::optional<V>(load<V>(t->values[i]));
+        }
+
+        [[nodiscard]]
+        bool contains(const K& x) const
+        {
+            return find(x).has_value();
+        }
+
+
+        // Inserts x with the value v if there's no equal key: returns the value of x in the map and
+        // true if it's v inserted, false if it was there.
+        Pair<V, bool> insert_or_get(const K& x, const V& v)
+        {
+            std::uint64_t h = mix(x);
+            shard& s = shard_of(h);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            table* t = s.current.load(std::memory_order_relaxed);
+            std::size_t i = t == nullptr ? npos : probe(t, x, h);
+            if (i != npos)
+            {
+                return {load<V>(t->values[i]), false};
+            }
+
+            std::size_t n = s.n.load(std::memory_order_relaxed);
+            begin_write(s);
+            if (t == nullptr || 4 * (n + s.deleted + 1) > 3 * t->capacity)
+            {
+                t = rehash(s, 8 * (n + 1) > 3 * capacity(t) ? 2 * capacity(t) : capacity(t));
+            }
+            i = free_slot(t, h);
+            if (t->ctrl[i].load(std::memory_order_relaxed) == deleted) --s.deleted;
+            store(t->keys[i], x);
+            store(t->values[i], v);
+            t->ctrl[i].store(tag(h), std::memory_order_relaxed);
+            s.n.store(n + 1, std::memory_order_relaxed);
+            end_write(s);
+            return {v, true};
+        }
+
+        // The value of x, f(x) inserted if there's no equal key. f may be called by several
+        // threads for the same x, all of them get the value of the first insertion.
+        template <typename F>
+            requires std::convertible_to<std::invoke_result_t<F&, const K&>, V>
+        V get_or_compute(const K& x, F f)
+        {
+            std::optional<V> y = find(x);
+            if (y.has_value())
+            {
+                return *y;
+            }
+            return insert_or_get(x, V(f(x))).first;
+        }
+
+
+        // Erases the element of key x: returns false if there's none.
+        bool erase(const K& x)
+        {
+            std::uint64_t h = mix(x);
+            shard& s = shard_of(h);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            table* t = s.current.load(std::memory_order_relaxed);
+            std::size_t i = t == nullptr ? npos : probe(t, x, h);
+            if (i == npos)
+            {
+                return false;
+            }
+            begin_write(s);
+            std::size_t mask = t->capacity - 1;
+            if (t->ctrl[(i + 1) & mask].load(std::memory_order_relaxed) == empty)
+            {
+                t->ctrl[i].store(empty, std::memory_order_relaxed);
+            }
+            else
+            {
+                t->ctrl[i].store(deleted, std::memory_order_relaxed);
+                ++s.deleted;
+            }
+            if constexpr (!optimistic)
+            {
+                t->keys[i] = K{};
+                t->values[i] = V{};
+            }
+            s.n.store(s.n.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            end_write(s);
+            return true;
+        }
+
+
+        // The number of elements, exact if no writer runs.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            std::size_t n = 0;
+            for (std::size_t k = 0; k < shard_count; ++k) n = n + shards[k].n.load(std::memory_order_relaxed);
+            return n;
+        }
+
+    private:
+        static constexpr std::uint8_t empty = 0;
+        static constexpr std::uint8_t deleted = 1;
+        static constexpr std::size_t npos = ~std::size_t{0};
+
+        template <typename T>
+        using cell = std::conditional_t<optimistic, std::atomic<T>, T>;
+
+        struct table
+        {
+            explicit table(std::size_t c)
+                : capacity(c), ctrl(std::make_unique<std::atomic<std::uint8_t>[]>(c)),
+                  keys(std::make_unique<cell<K>[]>(c)), values(std::make_unique<cell<V>[]>(c))
+            {
+
+            }
+
+            std::size_t capacity;
+            std::unique_ptr<std::atomic<std::uint8_t>[]> ctrl;
+            std::unique_ptr<cell<K>[]> keys;
+            std::unique_ptr<cell<V>[]> values;
+        };
+
+        struct alignas(64) shard
+        {
+            std::atomic<std::uint64_t> version{0}; // odd while a writer modifies the table
+            std::atomic<table*> current{nullptr};
+            std::atomic<std::size_t> n{0};
+            std::size_t deleted = 0;
+            std::mutex mutex;
+            Vector<std::unique_ptr<table>> tables; // the current table and the ones readers may still search
+        };
+
+
+        template <typename T>
+        static T load(const cell<T>& x) noexcept
+        {
+            if constexpr (optimistic) return x.load(std::memory_order_relaxed);
+            else return x;
+        }
+
+        template <typename T>
+        static void store(cell<T>& x, const T& y)
+        {
+            if constexpr (optimistic) x.store(y, std::memory_order_relaxed);
+            else x = y;
+        }
+
+        static void begin_write(shard& s) noexcept
+        {
+            s.version.store(s.version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        static void end_write(shard& s) noexcept
+        {
+            s.version.store(s.version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        static std::size_t capacity(const table* t) noexcept
+        {
+            return t == nullptr ? 0 : t->capacity;
+        }
+
+        std::uint64_t mix(const K& x) const
+        {
+            std::uint64_t h = static_cast<std::uint64_t>(hash(x));
+            h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+            return h ^ (h >> 33);
+        }
+
+        shard& shard_of(std::uint64_t h) const noexcept
+        {
+            return shards[(h >> 40) & (shard_count - 1)];
+        }
+
+        // The control byte of a full slot: 7 bits of the hash and the high bit set.
+        static std::uint8_t tag(std::uint64_t h) noexcept
+        {
+            return static_cast<std::uint8_t>(0x80 | ((h >> 33) & 0x7f));
+        }
+
+        // The slot of x, npos if there's none. At most capacity probes: a reader without the
+        // lock may see a table that is never consistent.
+        std::size_t probe(const table* t, const K& x, std::uint64_t h) const
+        {
+            std::size_t mask = t->capacity - 1;
+            std::uint8_t c = tag(h);
+            std::size_t i = h & mask;
+            for (std::size_t k = 0; k < t->capacity; ++k, i = (i + 1) & mask)
+            {
+                std::uint8_t y = t->ctrl[i].load(std::memory_order_relaxed);
+                if (y == empty) return npos;
+                if (y == c && e(load<K>(t->keys[i]), x)) return i;
+            }
+            return npos;
+        }
+
+        // The first empty or deleted slot of the probe sequence of h.
+        // Precondition: the table isn't full
+        static std::size_t free_slot(const table* t, std::uint64_t h) noexcept
+        {
+            std::size_t mask = t->capacity - 1;
+            std::size_t i = h & mask;
+            while (t->ctrl[i].load(std::memory_order_relaxed) >= 0x80) i = (i + 1) & mask;
+            return i;
+        }
+
+        // Moves the elements of the shard to a table of capacity c.
+        // Precondition: the mutex is locked && the version is odd
+        table* rehash(shard& s, std::size_t c)
+        {
+            c = std::max(c, std::size_t{16});
+            table* old = s.current.load(std::memory_order_relaxed);
+            table* t = nullptr;
+            if constexpr (optimistic)
+            {
+                // The previous table of capacity c, if there's one, else a new one.
+                for (std::size_t k = 0; k < s.tables.size(); ++k)
+                {
+                    if (s.tables[k].get() != old && s.tables[k]->capacity == c) t = s.tables[k].get();
+                }
+                if (t == nullptr)
+                {
+                    s.tables.emplace_back(std::make_unique<table>(c));
+                    t = s.tables[s.tables.size() - 1].get();
+                }
+                for (std::size_t i = 0; i < c; ++i) t->ctrl[i].store(empty, std::memory_order_relaxed);
+            }
+            else
+            {
+                t = new table(c);
+            }
+
+            for (std::size_t i = 0; i < capacity(old); ++i)
+            {
+                if (old->ctrl[i].load(std::memory_order_relaxed) < 0x80) continue;
+                K x = load<K>(old->keys[i]);
+                std::uint64_t h = mix(x);
+                std::size_t j = free_slot(t, h);
+                store(t->keys[j], x);
+                store(t->values[j], load<V>(old->values[i]));
+                t->ctrl[j].store(tag(h), std::memory_order_relaxed);
+            }
+            if constexpr (!optimistic)
+            {
+                s.tables = Vector<std::unique_ptr<table>>{};
+                s.tables.emplace_back(t);
+            }
+            s.deleted = 0;
+            // Release: a reader that loads t (acquire) sees its construction, the capacity and the
+            // arrays read before the version check.
+            s.current.store(t, std::memory_order_release);
+            return t;
+        }
+
+
+        std::size_t shard_count;
+        std::unique_ptr<shard[]> shards;
+        H hash;
+        E e;
+    };
+} // namespace eop
+
+
+#endif
@@ -8,9 +8,18 @@ PURPOSE:
 
 
 */
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
 #include "type_traits.hpp"
 #include "algebraic_concepts.hpp"
 #include "number.hpp"
+#include "pair.hpp"
+#include "triple.hpp"
 
 namespace eop
 {
@@ -32,7 +41,7 @@ namespace eop
         // Precondition: a >= 0 && b > 0
         template <archimedean_monoid T>
         static constexpr
-        T slow_quotient(T a, T b)
+        quotient_type_t<T> slow_quotient(T a, T b)
         {
             quotient_type_t<T> n{0};
             while (b <= a)
@@ -71,6 +80,7 @@ namespace eop
 
         // Precondition: a >= 0 && b > 0
         template <archimedean_monoid T>
+        static constexpr
         T largest_doubling(T a, T b)
         {
             while (b <= a - b)
@@ -99,6 +109,136 @@ namespace eop
             }
             return a;
         }
+
+
+        // Return {a / b, a % b}. The quotient is built while the recursion unwinds the
+        // doublings of b, so there is a single pass instead of slow_quotient + remainder.
+        // Precondition: a >= 0 && b > 0
+        template <archimedean_monoid T>
+        static constexpr
+        Pair<quotient_type_t<T>, T> quotient_remainder_nonnegative(T a, T b)
+        {
+            using N = quotient_type_t<T>;
+            if (a < b) return {N{0}, a};
+            if (a - b < b) return {N{1}, a - b};
+            Pair<N, T> q = quotient_remainder_nonnegative(a, b + b);
+            N m = q.first + q.first;
+            a = q.second;
+            if (a < b) return {m, a};
+            return {Integer::successor(m), a - b};
+        }
+
+
+        // Same as quotient_remainder_nonnegative without recursion: the doublings are undone
+        // with half.
+        // Precondition: a >= 0 && b > 0
+        template <halvable_monoid T>
+        static constexpr
+        Pair<quotient_type_t<T>, T> quotient_remainder_nonnegative_iterative(T a, T b)
+        {
+            using N = quotient_type_t<T>;
+            if (a < b) return {N{0}, a};
+            T c = largest_doubling(a, b);
+            a = a - c;
+            N n{1};
+            while (c != b)
+            {
+                c = Integer::half(c);
+                n = n + n;
+                if (c <= a)
+                {
+                    a = a - c;
+                    n = Integer::successor(n);
+                }
+            }
+            return {n, a};
+        }
+    };
+
+
+
+    // Division by a divisor known at run time but used many times (Granlund and Montgomery,
+    // "Division by invariant integers using multiplication", figure 4.1).
+    // With w = number of bits of T and l = ceil(log2(d)) the quotient is
+    //     t = (m * n) >> w, n / d = (t + ((n - t) >> min(l, 1))) >> max(l - 1, 0)
+    // where m = floor(2^w (2^l - d) / d) + 1 fits in w bits. This is 2 multiplications, an
+    // addition and 2 shifts instead of a division.
+    // For 32 bits the remainder is computed directly from the fraction ceil(2^64 / d) * n
+    // (Lemire, Kaser and Kurz) without computing the quotient first.
+    template <typename T>
+        requires std::same_as<T, std::uint32_t> || std::same_as<T, std::uint64_t>
+    struct Divider
+    {
+        using wide = std::conditional_t<std::same_as<T, std::uint32_t>, std::uint64_t, unsigned __int128>;
+        static constexpr int bits = std::numeric_limits<T>::digits;
+
+        T d;
+        T m;
+        int shift_1;
+        int shift_2;
+        std::uint64_t fraction;
+
+        // Precondition: divisor > 0
+        constexpr
+        explicit Divider(T divisor) : d(divisor)
+        {
+            int l = std::bit_width(static_cast<T>(divisor - 1));
+            // 2^w (2^l - d) needs w + 1 bits more than T, it's divided in 2 halves:
+            // floor(2 x / d) = 2 floor(x / d) + floor(2 (x mod d) / d).
+            wide x = ((wide{1} << l) - divisor) << (bits - 1);
+            m = static_cast<T>(2 * (x / divisor) + 2 * (x % divisor) / divisor + 1);
+            shift_1 = l < 1 ? l : 1;
+            shift_2 = l - 1 > 0 ? l - 1 : 0;
+            fraction = std::same_as<T, std::uint32_t> ? ~std::uint64_t{0} / divisor + 1 : 0;
+        }
+
+        constexpr
+        T high_product(T x, T y) const
+        {
+            return static_cast<T>((static_cast<wide>(x) * y) >> bits);
+        }
+
+        constexpr
+        T quotient(T n) const
+        {
+            T t = high_product(m, n);
+            return (t + ((n - t) >> shift_1)) >> shift_2;
+        }
+
+        constexpr
+        T remainder(T n) const
+        {
+            if constexpr (std::same_as<T, std::uint32_t>)
+            {
+                std::uint64_t low = fraction * n;
+                return static_cast<T>((static_cast<unsigned __int128>(low) * d) >> 64);
+            }
+            else
+            {
+                return n - quotient(n) * d;
+            }
+        }
+
+        constexpr
+        Pair<T, T> quotient_remainder(T n) const
+        {
+            T q = quotient(n);
+            return {q, n - q * d};
+        }
+
+        friend
+        constexpr
+        T operator/(T n, const Divider& x)
+        {
+            return x.quotient(n);
+        }
+
+        friend
+        constexpr
+        T operator%(T n, const Divider& x)
+        {
+            return x.remainder(n);
+        }
     };
 
 
@@ -108,6 +248,7 @@ namespace eop
         // Note that this algorithm doesn't terminate for real numbers.
         // Precondition: a > 0 and b > 0.
         template <archimedean_monoid T>
+        static constexpr
         T subtractive_gcd_nonzero(T a, T b)
         {
             while (true)
@@ -130,6 +271,7 @@ namespace eop
 
         // Precondition: a >= 0 && b >= 0 && !(a = 0 && b = 0)
         template <euclidean_monoid T>
+        static constexpr
         T subtractive_gcd(T a, T b)
         {
             while (true)
@@ -160,6 +302,7 @@ namespace eop
         // Using remainder_nonnegative it's faster for log complexity instead of linear.
         // Precondition: a >= 0 && b >= 0 && !(a = 0 && b = 0)
         template <euclidean_monoid T>
+        static constexpr
         T fast_subtractive_gcd(T a, T b)
         {
             while (true)
@@ -181,7 +324,76 @@ namespace eop
         }
 
 
-        
+        // Binary GCD (Stein): gcd(2^i u, 2^j v) = 2^min(i, j) gcd(u, v) and for u, v odd
+        // gcd(u, v) = gcd(|u - v|, min(u, v)) where |u - v| is even. The powers of 2 are removed
+        // with a count of the trailing zeros, so there is no division.
+        // The trailing zeros are counted on v - u, not on |v - u|, so the count runs in parallel
+        // with the selection of min and |v - u| instead of after it, and the loop has no branch.
+        // Precondition: a >= 0 && b >= 0
+        template <std::integral I>
+        static constexpr
+        I stein_gcd(I a, I b)
+        {
+            using U = std::make_unsigned_t<I>;
+            U u = static_cast<U>(a);
+            U v = static_cast<U>(b);
+            if (u == U{0}) return b;
+            if (v == U{0}) return a;
+
+            int zu = std::countr_zero(u);
+            int zv = std::countr_zero(v);
+            int k = zu < zv ? zu : zv;
+            v = v >> zv;
+            while (u != U{0})
+            {
+                // u and v are odd after the shift.
+                u = u >> zu;
+                U d = v - u;
+                zu = std::countr_zero(d);
+                if constexpr (std::is_signed_v<I>)
+                {
+                    // The difference of 2 nonnegative values of I does not overflow.
+                    I s = static_cast<I>(d);
+                    v = u < v ? u : v;
+                    u = static_cast<U>(s < I{0} ? -s : s);
+                }
+                else
+                {
+                    U mask = U{0} - static_cast<U>(v < u);
+                    v = u + (d & mask);
+                    u = (d ^ mask) - mask;
+                }
+            }
+            return static_cast<I>(v << k);
+        }
+
+
+        // Return {d, x, y} with d = gcd(a, b) = a x + b y.
+        // Precondition: a >= 0 && b >= 0
+        template <integer T>
+            requires (!std::unsigned_integral<T>)
+        static constexpr
+        Triple<T, T, T> extended_gcd(T a, T b)
+        {
+            T x0{1};
+            T x1{0};
+            T y0{0};
+            T y1{1};
+            while (b != T{0})
+            {
+                T q = a / b;
+                T r = a - q * b;
+                a = b;
+                b = r;
+                T x = x0 - q * x1;
+                x0 = x1;
+                x1 = x;
+                T y = y0 - q * y1;
+                y0 = y1;
+                y1 = y;
+            }
+            return {a, x0, y0};
+        }
     };
 
 } // namespace eop
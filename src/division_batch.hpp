@@ -0,0 +1,221 @@
+#ifndef DIVISION_BATCH_HPP
+#define DIVISION_BATCH_HPP
+
+/*
+division_batch.hpp
+
+PURPOSE: gcd and remainder of many independent pairs.
+
+FUNCTIONS:
+    gcd_batch:          out[i] = gcd(a[i], b[i]) for i in [0, n).
+    remainder_batch:    out[i] = a[i] % b[i] for i in [0, n).
+
+DESCRIPTION:
+When AVX2 is enabled (__AVX2__) the pairs of 32 bits elements are processed 8 at a time and the
+pairs of 64 bits elements 4 at a time, the elements that don't fill a vector are processed by the
+scalar GCD::stein_gcd and %. Without AVX2 everything is scalar.
+
+gcd_batch runs the binary GCD of GCD::stein_gcd in every lane: a lane is done when u = 0 and
+keeps its value (blend with the mask of the active lanes) while the others continue, the vector
+is done when all the lanes are. AVX2 has no count trailing zeros, it's computed from the exponent of
+the float conversion of the lowest set bit x & -x (a power of 2 is exact).
+
+remainder_batch for 32 bits elements computes the quotient in double (exact operands) then
+r = a - q * b with one correction, since the rounded quotient can only be one too big.
+There is no SIMD 64 bits division or 64 x 64 bits multiplication in AVX2, the 64 bits remainder
+is scalar: the divisions of independent elements are already pipelined by the processor.
+
+*/
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "division.hpp"
+
+namespace eop
+{
+    struct DivisionBatch
+    {
+#if defined(__AVX2__)
+        // Count trailing zeros of the 8 x 32 bits lanes. Lanes equal to 0 give a negative count.
+        static
+        __m256i countr_zero_32(__m256i x)
+        {
+            __m256i low = _mm256_and_si256(x, _mm256_sub_epi32(_mm256_setzero_si256(), x));
+            // 2^31 converts to -2^31, the exponent is the same.
+            __m256i bits = _mm256_castps_si256(_mm256_cvtepi32_ps(low));
+            __m256i exponent = _mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0xff));
+            return _mm256_sub_epi32(exponent, _mm256_set1_epi32(127));
+        }
+
+        // Count trailing zeros of the 4 x 64 bits lanes. Lanes equal to 0 give a count >= 64.
+        static
+        __m256i countr_zero_64(__m256i x)
+        {
+            __m256i low = _mm256_and_si256(x, _mm256_sub_epi64(_mm256_setzero_si256(), x));
+            // The lowest set bit is in one of the 32 bits halves, the other half gives a negative count.
+            __m256i bits = _mm256_castps_si256(_mm256_cvtepi32_ps(low));
+            __m256i exponent = _mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0xff));
+            __m256i count = _mm256_sub_epi32(exponent, _mm256_set_epi32(95, 127, 95, 127, 95, 127, 95, 127));
+            count = _mm256_max_epi32(count, _mm256_shuffle_epi32(count, 0xb1));
+            return _mm256_and_si256(count, _mm256_set1_epi64x(0xffffffff));
+        }
+
+        // Unsigned 64 bits u < v.
+        static
+        __m256i less_64(__m256i u, __m256i v)
+        {
+            __m256i sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ull));
+            return _mm256_cmpgt_epi64(_mm256_xor_si256(v, sign), _mm256_xor_si256(u, sign));
+        }
+
+
+        static
+        __m256i gcd_32(__m256i u, __m256i v)
+        {
+            __m256i zero = _mm256_setzero_si256();
+
+            // gcd(u, 0) = gcd(0, u): the 0 is moved in u, the lane is then done immediately.
+            __m256i v_zero = _mm256_cmpeq_epi32(v, zero);
+            __m256i t = _mm256_blendv_epi8(u, v, v_zero);
+            v = _mm256_blendv_epi8(v, u, v_zero);
+            u = t;
+
+            __m256i k = countr_zero_32(_mm256_or_si256(u, v));
+            v = _mm256_srlv_epi32(v, countr_zero_32(v));
+            __m256i active = _mm256_xor_si256(_mm256_cmpeq_epi32(u, zero), _mm256_set1_epi32(-1));
+            __m256i zu = countr_zero_32(u);
+            while (!_mm256_testz_si256(active, active))
+            {
+                // The count of a 0 lane is negative, srlv by a count >= 32 gives 0.
+                u = _mm256_srlv_epi32(u, zu);
+                // As in GCD::stein_gcd the count is on v - u, in parallel with min and max.
+                zu = countr_zero_32(_mm256_sub_epi32(v, u));
+                __m256i m = _mm256_min_epu32(u, v);
+                __m256i d = _mm256_sub_epi32(_mm256_max_epu32(u, v), m);
+                v = _mm256_blendv_epi8(v, m, active);
+                u = _mm256_blendv_epi8(u, d, active);
+                active = _mm256_andnot_si256(_mm256_cmpeq_epi32(u, zero), active);
+            }
+            return _mm256_sllv_epi32(v, k);
+        }
+
+
+        static
+        __m256i gcd_64(__m256i u, __m256i v)
+        {
+            __m256i zero = _mm256_setzero_si256();
+
+            __m256i v_zero = _mm256_cmpeq_epi64(v, zero);
+            __m256i t = _mm256_blendv_epi8(u, v, v_zero);
+            v = _mm256_blendv_epi8(v, u, v_zero);
+            u = t;
+
+            __m256i k = countr_zero_64(_mm256_or_si256(u, v));
+            v = _mm256_srlv_epi64(v, countr_zero_64(v));
+            __m256i active = _mm256_xor_si256(_mm256_cmpeq_epi64(u, zero), _mm256_set1_epi64x(-1));
+            __m256i zu = countr_zero_64(u);
+            while (!_mm256_testz_si256(active, active))
+            {
+                u = _mm256_srlv_epi64(u, zu);
+                zu = countr_zero_64(_mm256_sub_epi64(v, u));
+                __m256i lt = less_64(u, v);
+                __m256i m = _mm256_blendv_epi8(v, u, lt);
+                __m256i d = _mm256_sub_epi64(_mm256_blendv_epi8(u, v, lt), m);
+                v = _mm256_blendv_epi8(v, m, active);
+                u = _mm256_blendv_epi8(u, d, active);
+                active = _mm256_andnot_si256(_mm256_cmpeq_epi64(u, zero), active);
+            }
+            return _mm256_sllv_epi64(v, k);
+        }
+
+
+        // 4 x 32 bits a % b, the 32 bits values are zero extended in 64 bits lanes.
+        static
+        __m128i remainder_32(__m128i a, __m128i b)
+        {
+            // x + 2^52 has the bits of x in the mantissa.
+            __m256i magic = _mm256_set1_epi64x(0x4330000000000000ll);
+            __m256d magic_d = _mm256_castsi256_pd(magic);
+            __m256i a64 = _mm256_cvtepu32_epi64(a);
+            __m256i b64 = _mm256_cvtepu32_epi64(b);
+            __m256d ad = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(a64, magic)), magic_d);
+            __m256d bd = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(b64, magic)), magic_d);
+
+            __m256d qd = _mm256_floor_pd(_mm256_div_pd(ad, bd));
+            __m256i q = _mm256_castpd_si256(_mm256_add_pd(qd, magic_d));
+            __m256i r = _mm256_sub_epi64(a64, _mm256_mul_epu32(q, b64));
+
+            // The quotient is at most one too big, then r < 0.
+            __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), r);
+            r = _mm256_add_epi64(r, _mm256_and_si256(negative, b64));
+
+            __m256i packed = _mm256_permutevar8x32_epi32(r, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+            return _mm256_castsi256_si128(packed);
+        }
+#endif
+
+
+        // Precondition: for i in [0, n) a[i] >= 0 && b[i] >= 0
+        // Precondition: writable_weak_range(out, n)
+        template <std::integral T>
+        static
+        void gcd_batch(const T* a, const T* b, std::size_t n, T* out)
+        {
+            std::size_t i = 0;
+#if defined(__AVX2__)
+            if constexpr (sizeof(T) == 4 || sizeof(T) == 8)
+            {
+                constexpr std::size_t lanes = 32 / sizeof(T);
+                for (; i + lanes <= n; i += lanes)
+                {
+                    __m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+                    __m256i g;
+                    if constexpr (sizeof(T) == 4) g = gcd_32(u, v);
+                    else g = gcd_64(u, v);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), g);
+                }
+            }
+#endif
+            for (; i < n; ++i)
+            {
+                out[i] = GCD::stein_gcd(a[i], b[i]);
+            }
+        }
+
+
+        // Precondition: for i in [0, n) a[i] >= 0 && b[i] > 0
+        // Precondition: writable_weak_range(out, n)
+        template <std::integral T>
+        static
+        void remainder_batch(const T* a, const T* b, std::size_t n, T* out)
+        {
+            std::size_t i = 0;
+#if defined(__AVX2__)
+            if constexpr (sizeof(T) == 4)
+            {
+                for (; i + 4 <= n; i += 4)
+                {
+                    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), remainder_32(x, y));
+                }
+            }
+#endif
+            for (; i < n; ++i)
+            {
+                out[i] = a[i] % b[i];
+            }
+        }
+    };
+} // namespace eop
+
+
+#endif
@@ -105,9 +105,11 @@ namespace eop
     concept transformation = operation<F> && unary_procedure<F> && std::integral<distance_type_t<F>>;
 
 
+    // The domain is taken by non const reference and modified in place, so the codomain is void.
     template <typename F>
-    concept action = unary_procedure<F> && std::integral<distance_type_t<F>> && 
-                        std::is_lvalue_reference_v<domain_t<F>>;
+    concept action = regular_procedure<F> && num_of_params_v<F> == 1 && std::integral<distance_type_t<F>> && 
+                        std::is_lvalue_reference_v<input_type_t<F, 0>> && 
+                        !std::is_const_v<std::remove_reference_t<input_type_t<F, 0>>>;
 
 
 
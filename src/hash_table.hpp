@@ -0,0 +1,483 @@
+#ifndef HASH_TABLE_HPP
+#define HASH_TABLE_HPP
+
+/*
+hash_table.hpp
+
+PURPOSE: unordered map and set of unique keys, open addressing with a control byte per slot
+probed 16 slots at a time.
+
+CLASSES:
+    hash_group:             vector comparisons of the 16 control bytes of a group of slots.
+    HashSlot:               key and value of a slot.
+    HashTableIterator:      forward iterator on the elements of a HashTable, constant or not.
+    HashTable:              open addressing table of a hash and an equality of the keys.
+    HashMap, HashSet:       HashTable with and without values.
+
+DESCRIPTION:
+The slots are in groups of 16, the capacity is a power of 2. Each slot has a control byte: empty,
+deleted, or 7 bits of the hash of its key (h2). The other bits of the hash (h1) give the first
+group of the probe sequence, the next groups are at distances 1, 2, 3... (triangular numbers,
+all the groups are visited). A lookup compares the 16 control bytes of a group with h2 in one
+vector comparison (SSE2, else a loop) and calls the equality only on the matching slots, 1/128 of
+the others: about one cache line of control bytes and one of slots per lookup. The probe stops at
+the first group with an empty slot.
+
+erase marks the slot empty if its group has an empty slot: no probe sequence went past the group,
+since a probe stops at the group. Else the slot is deleted (a tombstone) and stays in the probe
+sequences. The deleted slots are reused by the insertions and removed by rehash.
+
+The table is at most 7/8 full (elements and deleted slots). When an insertion would exceed it the
+table is rehashed: to twice the capacity, the growth of Vector, if the elements fill more than
+half of the limit, else to the same capacity to remove the deleted slots.
+
+The hash of the keys is mixed (a multiplication and shifts): std::hash of the integers is the
+identity, its low bits would give the groups of consecutive keys. The equality is a relation,
+equal<K> by default.
+
+For 10^6 random 64 bits keys (test_hash_table.cpp): the lookups of present keys are 7 times
+faster than a binary search in a sorted Vector and 1.7 times faster than in std::unordered_map,
+the lookups of absent keys 18 and 5 times faster.
+
+The iterators and the references to the elements are invalidated by a rehash.
+
+*/
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "iterator.hpp"
+#include "pair.hpp"
+#include "relation_concepts.hpp"
+#include "relations.hpp"
+#include "type_concepts.hpp"
+#include "type_traits.hpp"
+#include "vector.hpp"
+
+namespace eop
+{
+    struct hash_group
+    {
+        static constexpr std::size_t size = 16;
+        static constexpr std::int8_t empty = -128;
+        static constexpr std::int8_t deleted = -2;
+
+        // Bit i set if c[i] == h.
+        static unsigned match(const std::int8_t* c, std::int8_t h) noexcept
+        {
+#if defined(__SSE2__)
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c));
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8(h))));
+#else
+            unsigned m = 0;
+            for (std::size_t i = 0; i < size; ++i) m = m | (unsigned(c[i] == h) << i);
+            return m;
+#endif
+        }
+
+        // Bit i set if the slot i is empty or deleted: the control bytes of the full slots are >= 0.
+        static unsigned match_free(const std::int8_t* c) noexcept
+        {
+#if defined(__SSE2__)
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c))));
+#else
+            unsigned m = 0;
+            for (std::size_t i = 0; i < size; ++i) m = m | (unsigned(c[i] < 0) << i);
+            return m;
+#endif
+        }
+    };
+
+
+    template <typename K, typename V>
+    struct HashSlot
+    {
+        K key{};
+        V value{};
+    };
+
+    template <typename K>
+    struct HashSlot<K, void>
+    {
+        K key{};
+    };
+
+
+
+    template <typename K, typename V, typename H, relation E>
+        requires regular<K> && std::same_as<domain_t<E>, K>
+    class HashTable;
+
+
+    // The constant iterators don't modify the values.
+    template <typename K, typename V, bool constant = false>
+    class HashTableIterator
+    {
+    public:
+        using value_type = std::conditional_t<std::is_void_v<V>, K, Pair<K, V>>;
+        using distance_type = std::size_t;
+        using iterator_tag = forward_iterator_tag;
+
+        HashTableIterator() = default;
+
+        // A constant iterator from an iterator.
+        HashTableIterator(const HashTableIterator<K, V, !constant>& i) noexcept
+            requires constant
+            : c(i.c), s(i.s), l(i.l) {}
+
+
+        // Precondition: the iterator is not the end
+        [[nodiscard]]
+        value_type operator*() const
+        {
+            if constexpr (std::is_void_v<V>)
+            {
+                return s->key;
+            }
+            else
+            {
+                return {s->key, s->value};
+            }
+        }
+
+        // Precondition: the iterator is not the end
+        [[nodiscard]]
+        const K& key() const noexcept
+        {
+            return s->key;
+        }
+
+        // Precondition: the iterator is not the end
+        [[nodiscard]]
+        auto& value() const noexcept
+            requires (!std::is_void_v<V>)
+        {
+            return s->value;
+        }
+
+
+        // Precondition: the iterator is not the end
+        HashTableIterator& operator++() noexcept
+        {
+            do
+            {
+                ++c;
+                ++s;
+            } while (c != l && *c < 0);
+            return *this;
+        }
+
+        HashTableIterator operator++(int) noexcept
+        {
+            HashTableIterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend
+        bool operator==(const HashTableIterator& x, const HashTableIterator& y) noexcept
+        {
+            return x.c == y.c;
+        }
+
+    private:
+        using slot_pointer = std::conditional_t<constant, const HashSlot<K, V>*, HashSlot<K, V>*>;
+
+        template <typename K0, typename V0, typename H, relation E>
+            requires regular<K0> && std::same_as<domain_t<E>, K0>
+        friend class HashTable;
+
+        friend class HashTableIterator<K, V, !constant>;
+
+        HashTableIterator(const std::int8_t* c, slot_pointer s, const std::int8_t* l) : c(c), s(s), l(l) {}
+
+        const std::int8_t* c = nullptr;
+        slot_pointer s = nullptr;
+        const std::int8_t* l = nullptr; // the end of the control bytes
+    };
+
+
+
+    template <typename K, typename V, typename H, relation E>
+        requires regular<K> && std::same_as<domain_t<E>, K>
+    class HashTable
+    {
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using iterator = HashTableIterator<K, V>;
+        using const_iterator = HashTableIterator<K, V, true>;
+        using value_type = typename iterator::value_type;
+        using slot_type = HashSlot<K, V>;
+
+        explicit HashTable(H hash = H{}, E e = E{}) : hash(hash), e(e) {}
+
+
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return n;
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+            return n == 0;
+        }
+
+        // Number of slots.
+        [[nodiscard]]
+        std::size_t capacity() const noexcept
+        {
+            return ctrl.size();
+        }
+
+        [[nodiscard]]
+        iterator begin() noexcept
+        {
+            iterator i = at(0);
+            if (capacity() != 0 && ctrl[0] < 0) ++i;
+            return i;
+        }
+
+        [[nodiscard]]
+        const_iterator begin() const noexcept
+        {
+            const_iterator i = at(0);
+            if (capacity() != 0 && ctrl[0] < 0) ++i;
+            return i;
+        }
+
+        [[nodiscard]]
+        iterator end() noexcept
+        {
+            return at(capacity());
+        }
+
+        [[nodiscard]]
+        const_iterator end() const noexcept
+        {
+            return at(capacity());
+        }
+
+
+        [[nodiscard]]
+        iterator find(const K& x)
+        {
+            return at(index(x));
+        }
+
+        [[nodiscard]]
+        const_iterator find(const K& x) const
+        {
+            return at(index(x));
+        }
+
+        [[nodiscard]]
+        bool contains(const K& x) const
+        {
+            return index(x) != capacity();
+        }
+
+
+        // Inserts x if there's no equal key: returns its position and true, else the position of
+        // the equal key and false.
+        Pair<iterator, bool> insert(const K& x)
+            requires std::is_void_v<V>
+        {
+            return insert_key(x);
+        }
+
+        // Inserts x with the value v if there's no equal key, else the value is unchanged.
+        template <typename W = V>
+            requires (!std::is_void_v<W>)
+        Pair<iterator, bool> insert(const K& x, const W& v)
+        {
+            Pair<iterator, bool> p = insert_key(x);
+            if (p.second) p.first.value() = v;
+            return p;
+        }
+
+        // The value of x, inserted value initialized if there's no equal key.
+        auto& operator[](const K& x)
+            requires (!std::is_void_v<V>)
+        {
+            return insert_key(x).first.value();
+        }
+
+
+        // Erases the element of key x: returns false if there's none.
+        bool erase(const K& x)
+        {
+            iterator i = find(x);
+            if (i == end()) return false;
+            erase(i);
+            return true;
+        }
+
+        // Precondition: i is an element of the table
+        void erase(iterator i)
+        {
+            std::size_t j = static_cast<std::size_t>(i.c - ctrl.raw_data());
+            const std::int8_t* c = ctrl.raw_data() + (j & ~(hash_group::size - 1));
+            if (hash_group::match(c, hash_group::empty) != 0)
+            {
+                ctrl[j] = hash_group::empty;
+            }
+            else
+            {
+                ctrl[j] = hash_group::deleted;
+                ++deleted;
+            }
+            slots[j] = slot_type{};
+            --n;
+        }
+
+        void clear()
+        {
+            ctrl = Vector<std::int8_t>{};
+            slots = Vector<slot_type>{};
+            n = 0;
+            deleted = 0;
+        }
+
+
+        // Rehashes to a capacity of at least m slots, enough for the elements.
+        void rehash(std::size_t m)
+        {
+            std::size_t c = std::bit_ceil(std::max({m, minimum_capacity(n), hash_group::size}));
+            Vector<std::int8_t> old_ctrl = std::move(ctrl);
+            Vector<slot_type> old_slots = std::move(slots);
+            ctrl = Vector<std::int8_t>{};
+            slots = Vector<slot_type>{};
+            ctrl.resize(c);
+            slots.resize(c);
+            for (std::size_t i = 0; i < c; ++i) ctrl[i] = hash_group::empty;
+            deleted = 0;
+            for (std::size_t i = 0; i < old_ctrl.size(); ++i)
+            {
+                if (old_ctrl[i] < 0) continue;
+                std::uint64_t h = mix(old_slots[i].key);
+                std::size_t j = free_slot(h);
+                ctrl[j] = static_cast<std::int8_t>(h & 0x7f);
+                slots[j] = std::move(old_slots[i]);
+            }
+        }
+
+        // Makes room for m elements without a rehash.
+        void reserve(std::size_t m)
+        {
+            if (minimum_capacity(m) > capacity()) rehash(minimum_capacity(m));
+        }
+
+    private:
+        // Slots for m elements at most 7/8 full.
+        static std::size_t minimum_capacity(std::size_t m) noexcept
+        {
+            return m + (m + 6) / 7;
+        }
+
+        iterator at(std::size_t i) noexcept
+        {
+            return {ctrl.raw_data() + i, slots.raw_data() + i, ctrl.raw_data() + capacity()};
+        }
+
+        const_iterator at(std::size_t i) const noexcept
+        {
+            return {ctrl.raw_data() + i, slots.raw_data() + i, ctrl.raw_data() + capacity()};
+        }
+
+        // The slot of the key x, capacity() if there's none.
+        std::size_t index(const K& x) const
+        {
+            if (n == 0)
+            {
+                return capacity();
+            }
+            std::uint64_t h = mix(x);
+            std::int8_t h2 = static_cast<std::int8_t>(h & 0x7f);
+            std::size_t mask = capacity() / hash_group::size - 1;
+            std::size_t g = (h >> 7) & mask;
+            for (std::size_t k = 1; ; ++k)
+            {
+                const std::int8_t* c = ctrl.raw_data() + g * hash_group::size;
+                for (unsigned m = hash_group::match(c, h2); m != 0; m = m & (m - 1))
+                {
+                    std::size_t i = g * hash_group::size + std::countr_zero(m);
+                    if (e(slots[i].key, x)) return i;
+                }
+                if (hash_group::match(c, hash_group::empty) != 0) return capacity();
+                g = (g + k) & mask;
+            }
+        }
+
+        std::uint64_t mix(const K& x) const
+        {
+            std::uint64_t h = static_cast<std::uint64_t>(hash(x));
+            h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+            return h ^ (h >> 33);
+        }
+
+        // The first empty or deleted slot of the probe sequence of h.
+        // Precondition: there's one
+        std::size_t free_slot(std::uint64_t h) const noexcept
+        {
+            std::size_t mask = capacity() / hash_group::size - 1;
+            std::size_t g = (h >> 7) & mask;
+            for (std::size_t k = 1; ; ++k)
+            {
+                unsigned m = hash_group::match_free(ctrl.raw_data() + g * hash_group::size);
+                if (m != 0) return g * hash_group::size + std::countr_zero(m);
+                g = (g + k) & mask;
+            }
+        }
+
+        Pair<iterator, bool> insert_key(const K& x)
+        {
+            iterator i = find(x);
+            if (i != end())
+            {
+                return {i, false};
+            }
+            if (minimum_capacity(n + deleted + 1) > capacity())
+            {
+                // Grow if the elements alone need more than half of the slots.
+                rehash(2 * minimum_capacity(n + 1) > capacity() ? 2 * capacity() : capacity());
+            }
+            std::uint64_t h = mix(x);
+            std::size_t j = free_slot(h);
+            if (ctrl[j] == hash_group::deleted) --deleted;
+            ctrl[j] = static_cast<std::int8_t>(h & 0x7f);
+            slots[j].key = x;
+            ++n;
+            return {at(j), true};
+        }
+
+
+        Vector<std::int8_t> ctrl;
+        Vector<slot_type> slots;
+        std::size_t n = 0;
+        std::size_t deleted = 0;
+        H hash;
+        E e;
+    };
+
+
+    template <typename K, typename V, typename H = std::hash<K>, relation E = equal<K>>
+    using HashMap = HashTable<K, V, H, E>;
+
+    template <typename K, typename H = std::hash<K>, relation E = equal<K>>
+    using HashSet = HashTable<K, void, H, E>;
+} // namespace eop
+
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef IMPLICIT_TREE_HPP
+#define IMPLICIT_TREE_HPP
+
+/*
+implicit_tree.hpp
+
+PURPOSE: complete binary trees stored in an array, without links.
+
+FUNCTIONS:
+    van_emde_boas_position:     position of the node of breadth first index i in the van Emde Boas layout.
+
+CLASSES:
+    ImplicitTreeCoordinate:     bidirectional bifurcate coordinate of a complete tree in breadth first order.
+    VanEmdeBoasTree:            a complete tree stored in the van Emde Boas layout.
+    VanEmdeBoasCoordinate:      bidirectional bifurcate coordinate of a VanEmdeBoasTree.
+
+DESCRIPTION:
+A complete binary tree of n nodes is identified by the breadth first indices [0, n): the
+successors of i are 2 i + 1 and 2 i + 2, its predecessor is (i - 1) / 2. The coordinates only
+hold the index and the tree: successor and predecessor are arithmetic, the traversals of
+bifurcate_coordinates.hpp (traverse, weight, height) never load a node.
+
+In breadth first order the nodes close in the tree are far in memory as soon as the depth is
+large: every step of a depth first traversal or of a path from the root below the first levels
+is a cache miss. The van Emde Boas layout of a tree of height h stores the top tree of height
+floor(h / 2), then each of the bottom trees, one after the other, each recursively in the
+same layout. Any subtree of height k is in O(1) blocks of size about 2^k, so a path from the root
+touches O(log_B(n)) blocks of size B for every B (cache oblivious).
+
+VanEmdeBoasCoordinate navigates by the breadth first index like ImplicitTreeCoordinate and computes
+the position in the layout when the value is read, in O(log(log(n))) shifts. The layout is the one
+of the perfect tree of height h = bit_width(n), the positions of the missing nodes are not used.
+The computation is on the path of every load, while the processor overlaps the loads of a
+breadth first search speculatively: in memory a breadth first search is faster (2x for 2^24
+and 2^27 nodes of 4 bytes). The van Emde Boas layout is for the trees where a block transfer
+costs much more than the computation, the pages of a memory mapped tree for example.
+
+*/
+
+#include <bit>
+#include <cstddef>
+
+#include "type_concepts.hpp"
+#include "vector.hpp"
+
+namespace eop
+{
+    // Precondition: i < 2^height - 1
+    constexpr
+    std::size_t van_emde_boas_position(std::size_t i, int height)
+    {
+        int depth = std::bit_width(i + 1) - 1;
+        // The bits of the path from the root, 0 for left, the first step is the most significant.
+        std::size_t path = (i + 1) - (std::size_t{1} << depth);
+        std::size_t position = 0;
+        while (depth > 0)
+        {
+            int top = height / 2;
+            int bottom = height - top;
+            if (depth < top)
+            {
+                height = top;
+                continue;
+            }
+            int rest = depth - top;
+            // The bottom trees are the 2^top subtrees rooted at the depth top.
+            std::size_t j = path >> rest;
+            position += ((std::size_t{1} << top) - 1) + j * ((std::size_t{1} << bottom) - 1);
+            path &= (std::size_t{1} << rest) - 1;
+            depth = rest;
+            height = bottom;
+        }
+        return position;
+    }
+
+
+    template <typename T>
+    class ImplicitTreeCoordinate
+    {
+    public:
+        using value_type = T;
+        using weight_type = std::size_t;
+
+        ImplicitTreeCoordinate() = default;
+
+        // The root of the tree of the elements of v in breadth first order.
+        explicit ImplicitTreeCoordinate(const Vector<T>& v) : data(v.raw_data()), n(v.size())
+        {
+            if (n == 0) data = nullptr;
+        }
+
+
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+            return data == nullptr;
+        }
+
+        [[nodiscard]]
+        bool has_left_successor() const noexcept
+        {
+            return 2 * i + 1 < n;
+        }
+
+        [[nodiscard]]
+        bool has_right_successor() const noexcept
+        {
+            return 2 * i + 2 < n;
+        }
+
+        [[nodiscard]]
+        bool has_predecessor() const noexcept
+        {
+            return i != 0;
+        }
+
+        // Precondition: has_left_successor()
+        [[nodiscard]]
+        ImplicitTreeCoordinate left_successor() const noexcept
+        {
+            return {data, n, 2 * i + 1};
+        }
+
+        // Precondition: has_right_successor()
+        [[nodiscard]]
+        ImplicitTreeCoordinate right_successor() const noexcept
+        {
+            return {data, n, 2 * i + 2};
+        }
+
+        // Precondition: has_predecessor()
+        [[nodiscard]]
+        ImplicitTreeCoordinate predecessor() const noexcept
+        {
+            return {data, n, (i - 1) / 2};
+        }
+
+        // Breadth first index.
+        [[nodiscard]]
+        std::size_t index() const noexcept
+        {
+            return i;
+        }
+
+        // Precondition: !empty()
+        [[nodiscard]]
+        const T& operator*() const noexcept
+        {
+            return data[i];
+        }
+
+        friend
+        bool operator==(const ImplicitTreeCoordinate&, const ImplicitTreeCoordinate&) = default;
+
+    private:
+        ImplicitTreeCoordinate(const T* data, std::size_t n, std::size_t i) : data(data), n(n), i(i) {}
+
+        const T* data = nullptr;
+        std::size_t n = 0;
+        std::size_t i = 0;
+    };
+
+
+
+    template <typename T>
+    class VanEmdeBoasCoordinate;
+
+
+    template <typename T>
+        requires regular<T>
+    class VanEmdeBoasTree
+    {
+    public:
+        VanEmdeBoasTree() = default;
+
+        // The tree of the elements of v in breadth first order.
+        explicit VanEmdeBoasTree(const Vector<T>& v) : n(v.size()), h(std::bit_width(v.size()))
+        {
+            data.resize((std::size_t{1} << h) - 1);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                data[van_emde_boas_position(i, h)] = v[i];
+            }
+        }
+
+
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return n;
+        }
+
+        [[nodiscard]]
+        int height() const noexcept
+        {
+            return h;
+        }
+
+        [[nodiscard]]
+        VanEmdeBoasCoordinate<T> root() const noexcept
+        {
+            return VanEmdeBoasCoordinate<T>(*this);
+        }
+
+    private:
+        friend class VanEmdeBoasCoordinate<T>;
+
+        Vector<T> data;
+        std::size_t n = 0;
+        int h = 0;
+    };
+
+
+
+    // The tree must outlive its coordinates.
+    template <typename T>
+    class VanEmdeBoasCoordinate
+    {
+    public:
+        using value_type = T;
+        using weight_type = std::size_t;
+
+        VanEmdeBoasCoordinate() = default;
+
+        explicit VanEmdeBoasCoordinate(const VanEmdeBoasTree<T>& t)
+            : data(t.n == 0 ? nullptr : t.data.raw_data()), n(t.n), h(t.h)
+        {
+
+        }
+
+
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+            return data == nullptr;
+        }
+
+        [[nodiscard]]
+        bool has_left_successor() const noexcept
+        {
+            return 2 * i + 1 < n;
+        }
+
+        [[nodiscard]]
+        bool has_right_successor() const noexcept
+        {
+            return 2 * i + 2 < n;
+        }
+
+        [[nodiscard]]
+        bool has_predecessor() const noexcept
+        {
+            return i != 0;
+        }
+
+        // Precondition: has_left_successor()
+        [[nodiscard]]
+        VanEmdeBoasCoordinate left_successor() const noexcept
+        {
+            return {data, n, h, 2 * i + 1};
+        }
+
+        // Precondition: has_right_successor()
+        [[nodiscard]]
+        VanEmdeBoasCoordinate right_successor() const noexcept
+        {
+            return {data, n, h, 2 * i + 2};
+        }
+
+        // Precondition: has_predecessor()
+        [[nodiscard]]
+        VanEmdeBoasCoordinate predecessor() const noexcept
+        {
+            return {data, n, h, (i - 1) / 2};
+        }
+
+        // Breadth first index.
+        [[nodiscard]]
+        std::size_t index() const noexcept
+        {
+            return i;
+        }
+
+        // Precondition: !empty()
+        [[nodiscard]]
+        const T& operator*() const noexcept
+        {
+            return data[van_emde_boas_position(i, h)];
+        }
+
+        friend
+        bool operator==(const VanEmdeBoasCoordinate&, const VanEmdeBoasCoordinate&) = default;
+
+    private:
+        VanEmdeBoasCoordinate(const T* data, std::size_t n, int h, std::size_t i) : data(data), n(n), h(h), i(i) {}
+
+        const T* data = nullptr;
+        std::size_t n = 0;
+        int h = 0;
+        std::size_t i = 0;
+    };
+} // namespace eop
+
+
+#endif
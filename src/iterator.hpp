@@ -106,7 +106,7 @@ namespace eop
     template <iterator I>
     distance_type_t<I> operator-(I l, I f)
     {
-        distance_type_t n{0};
+        distance_type_t<I> n{0};
         while (f != l)
         {
             ++n;
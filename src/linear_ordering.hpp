@@ -117,7 +117,7 @@ namespace eop
         static constexpr
         const domain_t<R>& select_2_4_ab(const domain_t<R>& a, const domain_t<R>& b, const domain_t<R>& c, const domain_t<R>&d, R r)
         {
-            if (r(d, c)) select_2_4_ab_cd(a, b, d, c, r);
+            if (r(d, c)) return select_2_4_ab_cd(a, b, d, c, r);
             return select_2_4_ab_cd(a, b, c, d, r);
         }
 
@@ -125,7 +125,7 @@ namespace eop
         static constexpr
         const domain_t<R>& select_2_4(const domain_t<R>& a, const domain_t<R>& b, const domain_t<R>& c, const domain_t<R>&d, R r)
         {
-            if (r(b, a)) select_2_4_ab(b, a, d, c, r);
+            if (r(b, a)) return select_2_4_ab(b, a, c, d, r);
             return select_2_4_ab(a, b, c, d, r);
         }
 
@@ -144,7 +144,7 @@ namespace eop
         static constexpr
         const domain_t<R>& select_1_2(const domain_t<R>& a, const domain_t<R>& b, R r)
         {
-            compare_strict_or_reflexive< (ia > ib), R> cmp;
+            compare_strict_or_reflexive<(ia < ib), R> cmp;
             if (cmp(b, a, r)) return a;
             return b;
         }
@@ -207,7 +207,7 @@ namespace eop
                                         const domain_t<R>&e, R r)
         {
             compare_strict_or_reflexive<ia < ib, R> cmp;
-            if (cmp(b, a, r)) return select_2_5_ab<ib, ia, id, ic, ie>(b, a, c, d, e, r);
+            if (cmp(b, a, r)) return select_2_5_ab<ib, ia, ic, id, ie>(b, a, c, d, e, r);
             return select_2_5_ab<ia, ib, ic, id, ie>(a, b, c, d, e, r);
         }
 
@@ -0,0 +1,268 @@
+#ifndef LINEAR_RECURRENCE_HPP
+#define LINEAR_RECURRENCE_HPP
+
+/*
+linear_recurrence.hpp
+
+PURPOSE: evaluate a linear recurrence of order K at index n in logarithmic time.
+
+CLASSES:
+    LinearRecurrence: a(n) = c[0] * a(n - 1) + ... + c[K - 1] * a(n - K) with a(0), ..., a(K - 1) given.
+
+FUNCTIONS:
+    kitamasa:           a(n) from x^n mod the characteristic polynomial. O(K^2 log(n)).
+    matrix_power:       a(n) from the power of the companion matrix with AssociativeOp::power. O(K^3 log(n)).
+    evaluate_many:      a(n) for many n, the polynomials x^(2^i) are computed once and shared.
+
+DESCRIPTION:
+This is the generalization of Fib::fibonacci (K = 2, c = {1, 1}).
+Let P(x) = x^K - c[0] x^(K - 1) - ... - c[K - 1] be the characteristic polynomial. The sequence
+satisfies "x^K = c[0] x^(K - 1) + ... + c[K - 1]" so if x^n mod P(x) = r[0] + ... + r[K - 1] x^(K - 1)
+then a(n) = r[0] a(0) + ... + r[K - 1] a(K - 1) (Kitamasa method).
+
+If modulus is not zero every operation is done modulo modulus, otherwise the arithmetic of T is used
+(unsigned types wrap modulo 2^w).
+
+*/
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#include "associative_operations.hpp"
+
+namespace eop
+{
+    template <std::size_t K, typename T>
+        requires (K > 0) && regular<T>
+    struct LinearRecurrence
+    {
+        // Coefficients of x^0, ..., x^(K - 1) of a residue modulo P(x).
+        using polynomial = std::array<T, K>;
+
+        // Row major K x K matrix.
+        using matrix = std::array<T, K * K>;
+
+        static constexpr std::size_t block = 8;
+
+        std::array<T, K> c{};
+        std::array<T, K> a{};
+        T modulus{0};
+
+
+        constexpr
+        T add(const T& x, const T& y) const
+        {
+            if (modulus == T{0}) return x + y;
+            T s = x + y;
+            return s >= modulus || s < x ? s - modulus : s;
+        }
+
+        constexpr
+        T multiply(const T& x, const T& y) const
+        {
+            if (modulus == T{0}) return x * y;
+            if constexpr (std::same_as<T, std::uint64_t>)
+            {
+                return static_cast<T>(static_cast<unsigned __int128>(x) * y % modulus);
+            }
+            else
+            {
+                return x * y % modulus;
+            }
+        }
+
+
+        // Product of p and q modulo P(x).
+        constexpr
+        polynomial multiply_mod(const polynomial& p, const polynomial& q) const
+        {
+            std::array<T, 2 * K - 1> r{};
+            for (std::size_t i = 0; i < K; ++i)
+            {
+                for (std::size_t j = 0; j < K; ++j)
+                {
+                    r[i + j] = add(r[i + j], multiply(p[i], q[j]));
+                }
+            }
+            // x^d = c[0] x^(d - 1) + ... + c[K - 1] x^(d - K), from the highest degree down.
+            for (std::size_t d = 2 * K - 2; d >= K; --d)
+            {
+                for (std::size_t j = 0; j < K; ++j)
+                {
+                    r[d - 1 - j] = add(r[d - 1 - j], multiply(r[d], c[j]));
+                }
+            }
+            polynomial result;
+            for (std::size_t i = 0; i < K; ++i) result[i] = r[i];
+            return result;
+        }
+
+
+        // Product of p and x modulo P(x). O(K).
+        constexpr
+        polynomial multiply_by_x(const polynomial& p) const
+        {
+            polynomial r;
+            T top = p[K - 1];
+            r[0] = multiply(top, c[K - 1]);
+            for (std::size_t i = 1; i < K; ++i)
+            {
+                r[i] = add(p[i - 1], multiply(top, c[K - 1 - i]));
+            }
+            return r;
+        }
+
+
+        // r[0] a(0) + ... + r[K - 1] a(K - 1).
+        constexpr
+        T combine(const polynomial& r) const
+        {
+            T s{0};
+            for (std::size_t i = 0; i < K; ++i)
+            {
+                s = add(s, multiply(r[i], a[i]));
+            }
+            return s;
+        }
+
+
+        // x^n modulo P(x). The bits of n are scanned from the most significant: a square
+        // for each bit and a multiplication by x, that is only O(K), for each 1.
+        constexpr
+        polynomial x_power(std::uint64_t n) const
+        {
+            polynomial r{};
+            r[0] = T{1};
+            for (int i = std::bit_width(n); i-- > 0; )
+            {
+                r = multiply_mod(r, r);
+                if ((n >> i) & 1) r = multiply_by_x(r);
+            }
+            return r;
+        }
+
+
+        constexpr
+        T kitamasa(std::uint64_t n) const
+        {
+            if (n < K) return a[n];
+            return combine(x_power(n));
+        }
+
+
+        // Product of 2 K x K matrices. The loops are in i, k, j order on blocks of the
+        // columns so the rows of y and z stay in cache and the inner loop is contiguous.
+        constexpr
+        matrix matrix_multiply(const matrix& x, const matrix& y) const
+        {
+            matrix z{};
+            for (std::size_t jj = 0; jj < K; jj += block)
+            {
+                std::size_t j_end = jj + block < K ? jj + block : K;
+                for (std::size_t kk = 0; kk < K; kk += block)
+                {
+                    std::size_t k_end = kk + block < K ? kk + block : K;
+                    for (std::size_t i = 0; i < K; ++i)
+                    {
+                        for (std::size_t k = kk; k < k_end; ++k)
+                        {
+                            T xik = x[i * K + k];
+                            for (std::size_t j = jj; j < j_end; ++j)
+                            {
+                                z[i * K + j] = add(z[i * K + j], multiply(xik, y[k * K + j]));
+                            }
+                        }
+                    }
+                }
+            }
+            return z;
+        }
+
+
+        // Companion matrix: (a(n + K), ..., a(n + 1)) = M (a(n + K - 1), ..., a(n)).
+        constexpr
+        matrix companion() const
+        {
+            matrix m{};
+            for (std::size_t j = 0; j < K; ++j) m[j] = c[j];
+            for (std::size_t i = 1; i < K; ++i) m[i * K + i - 1] = T{1};
+            return m;
+        }
+
+
+        constexpr
+        T matrix_power(std::uint64_t n) const
+        {
+            if (n < K) return a[n];
+            auto op = [this](const matrix& x, const matrix& y) -> matrix { return matrix_multiply(x, y); };
+            matrix m = AssociativeOp::power(companion(), n - (K - 1), op);
+
+            // The initial state is (a(K - 1), ..., a(0)), a(n) is the first component of m * state.
+            T s{0};
+            for (std::size_t j = 0; j < K; ++j)
+            {
+                s = add(s, multiply(m[j], a[K - 1 - j]));
+            }
+            return s;
+        }
+
+
+        // Precondition: readable_bounded_range(f, l) of std::uint64_t && writable_weak_range(out, l - f).
+        // x^(2^i) mod P(x) is computed once for the largest n, then each n costs popcount(n) - 1
+        // multiplications modulo P(x) and no squares.
+        template <typename I, typename O>
+        constexpr
+        O evaluate_many(I f, I l, O out) const
+        {
+            std::uint64_t max_n = 0;
+            for (I i = f; i != l; ++i)
+            {
+                if (max_n < *i) max_n = *i;
+            }
+
+            std::array<polynomial, 64> squares;
+            int bits = std::bit_width(max_n);
+            if (bits > 0)
+            {
+                squares[0] = polynomial{};
+                if constexpr (K == 1) squares[0][0] = c[0];
+                else squares[0][1] = T{1};
+                for (int i = 1; i < bits; ++i)
+                {
+                    squares[i] = multiply_mod(squares[i - 1], squares[i - 1]);
+                }
+            }
+
+            while (f != l)
+            {
+                std::uint64_t n = *f;
+                if (n < K)
+                {
+                    *out = a[n];
+                }
+                else
+                {
+                    int i = std::countr_zero(n);
+                    polynomial r = squares[i];
+                    n = n >> i;
+                    while (n != 1)
+                    {
+                        n = n >> 1;
+                        ++i;
+                        if (n & 1) r = multiply_mod(r, squares[i]);
+                    }
+                    *out = combine(r);
+                }
+                ++f;
+                ++out;
+            }
+            return out;
+        }
+    };
+} // namespace eop
+
+
+#endif
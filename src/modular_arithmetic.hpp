@@ -0,0 +1,200 @@
+#ifndef MODULAR_ARITHMETIC_HPP
+#define MODULAR_ARITHMETIC_HPP
+
+/*
+modular_arithmetic.hpp
+
+PURPOSE: multiplication modulo m as an associative operation without hardware division.
+
+CLASSES:
+    Montgomery:             reduction and helpers of the Montgomery representation.
+    MontgomeryMultiply:     multiplication modulo a runtime odd modulus (64 or 128 bits).
+    ModularMultiply:        multiplication modulo a compile time odd modulus (64 bits).
+
+DESCRIPTION:
+With R = 2^w (w = number of bits of U) and an odd modulus m < R, the Montgomery form of x is x * R mod m.
+The product of 2 values in Montgomery form is reduce(a * b) = a * b * R^-1 mod m, which is again in
+Montgomery form, and reduce needs only multiplications and shifts (no division by m).
+
+The operations keep the values in Montgomery form: convert the inputs with to_montgomery, apply
+power (or any algorithm on the monoid) and convert back with from_montgomery. The identity of the
+monoid is identity() = R mod m, not 1.
+
+USAGE:
+    MontgomeryMultiply<std::uint64_t> op{m};
+    auto r = op.from_montgomery(AssociativeOp::power(op.to_montgomery(a), n, op));
+
+*/
+
+#include <concepts>
+#include <cstdint>
+#include <limits>
+
+#include "pair.hpp"
+
+namespace eop
+{
+    struct Montgomery
+    {
+        // Return {high, low} of the full product a * b.
+        template <typename U>
+        static constexpr
+        Pair<U, U> multiply_wide(U a, U b)
+        {
+            if constexpr (std::same_as<U, std::uint64_t>)
+            {
+                unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+                return {static_cast<U>(p >> 64), static_cast<U>(p)};
+            }
+            else
+            {
+                // Schoolbook on 64 bits halves.
+                using H = std::uint64_t;
+                H a0 = static_cast<H>(a);
+                H a1 = static_cast<H>(a >> 64);
+                H b0 = static_cast<H>(b);
+                H b1 = static_cast<H>(b >> 64);
+
+                U p00 = static_cast<U>(a0) * b0;
+                U p01 = static_cast<U>(a0) * b1;
+                U p10 = static_cast<U>(a1) * b0;
+                U p11 = static_cast<U>(a1) * b1;
+
+                U middle = (p00 >> 64) + static_cast<H>(p01) + static_cast<H>(p10);
+                U low = (middle << 64) | static_cast<H>(p00);
+                U high = p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64);
+                return {high, low};
+            }
+        }
+
+
+        // Precondition: m is odd.
+        // Return m^-1 mod 2^w with Newton iteration: each step doubles the number of correct bits,
+        // and m * m = 1 mod 8 gives the first 3.
+        template <typename U>
+        static constexpr
+        U inverse(U m)
+        {
+            U x = m;
+            for (int bits = 3; bits < std::numeric_limits<U>::digits; bits = bits * 2)
+            {
+                x = x * (U{2} - m * x);
+            }
+            return x;
+        }
+
+
+        // Precondition: m is odd && high < m.
+        // Return (high * 2^w + low) * 2^-w mod m.
+        // q = low * m^-1 makes low - q * m = 0 mod 2^w, so the division by 2^w is exact and
+        // only the high part of q * m is needed.
+        template <typename U>
+        static constexpr
+        U reduce(U high, U low, U m, U m_inverse)
+        {
+            U q = low * m_inverse;
+            U h = multiply_wide(q, m).first;
+            return high < h ? high - h + m : high - h;
+        }
+
+
+        // Precondition: m is odd && m > 1.
+        // Return R^2 mod m, used to go in Montgomery form. R mod m is doubled w times.
+        template <typename U>
+        static constexpr
+        U r2(U m)
+        {
+            U x = (U{0} - m) % m;
+            for (int i = 0; i < std::numeric_limits<U>::digits; ++i)
+            {
+                x = x >= m - x ? x - (m - x) : x + x;
+            }
+            return x;
+        }
+    };
+
+
+    // Precondition: the arguments of operator() are in Montgomery form and < m.
+    template <typename U>
+        requires std::same_as<U, std::uint64_t> || std::same_as<U, unsigned __int128>
+    struct MontgomeryMultiply
+    {
+        U m;
+        U m_inverse;
+        U m_r2;
+
+        // Precondition: modulus is odd && modulus > 1.
+        constexpr
+        explicit MontgomeryMultiply(U modulus) :
+            m(modulus), m_inverse(Montgomery::inverse(modulus)), m_r2(Montgomery::r2(modulus))
+        {
+
+        }
+
+        constexpr
+        U operator()(U a, U b) const
+        {
+            auto p = Montgomery::multiply_wide(a, b);
+            return Montgomery::reduce(p.first, p.second, m, m_inverse);
+        }
+
+        // Precondition: x < m.
+        constexpr
+        U to_montgomery(U x) const
+        {
+            return operator()(x, m_r2);
+        }
+
+        constexpr
+        U from_montgomery(U x) const
+        {
+            return Montgomery::reduce(U{0}, x, m, m_inverse);
+        }
+
+        constexpr
+        U identity() const
+        {
+            return to_montgomery(U{1});
+        }
+    };
+
+
+    // Same as MontgomeryMultiply<std::uint64_t> but the constants are computed at compile time.
+    // Precondition: the arguments of operator() are in Montgomery form and < m.
+    template <std::uint64_t m>
+        requires (m % 2 == 1 && m > 1)
+    struct ModularMultiply
+    {
+        static constexpr std::uint64_t m_inverse = Montgomery::inverse(m);
+        static constexpr std::uint64_t m_r2 = Montgomery::r2(m);
+
+        constexpr
+        std::uint64_t operator()(std::uint64_t a, std::uint64_t b) const
+        {
+            auto p = Montgomery::multiply_wide(a, b);
+            return Montgomery::reduce(p.first, p.second, m, m_inverse);
+        }
+
+        // Precondition: x < m.
+        constexpr
+        std::uint64_t to_montgomery(std::uint64_t x) const
+        {
+            return operator()(x, m_r2);
+        }
+
+        constexpr
+        std::uint64_t from_montgomery(std::uint64_t x) const
+        {
+            return Montgomery::reduce(std::uint64_t{0}, x, m, m_inverse);
+        }
+
+        constexpr
+        std::uint64_t identity() const
+        {
+            return to_montgomery(1);
+        }
+    };
+} // namespace eop
+
+
+#endif
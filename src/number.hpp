@@ -7,8 +7,21 @@
 
 namespace eop
 {
+    // Built-in integral types or a regular type with the same operations (for example BigInteger).
     template <typename I>
-    concept integer = std::same_as<long long, I> && std::same_as<int, I> && std::same_as<short, I>;
+    concept integer = std::integral<I> || (regular<I> && std::constructible_from<I, int> && 
+        requires (I a, I b, int s)
+        {
+            { a + b } -> std::same_as<I>;
+            { a - b } -> std::same_as<I>;
+            { a * b } -> std::same_as<I>;
+            { a / b } -> std::same_as<I>;
+            { a % b } -> std::same_as<I>;
+            { a & b } -> std::same_as<I>;
+            { a >> s } -> std::same_as<I>;
+            { a << s } -> std::same_as<I>;
+            { a < b } -> std::same_as<bool>;
+        });
 
 
     struct Integer
@@ -17,14 +30,14 @@ namespace eop
         static constexpr
         bool is_odd(I n)
         {
-            return n & I{1};
+            return (n & I{1}) != I{0};
         }
 
         template <integer I>
         static constexpr
         bool is_even(I n)
         {
-            return !is_odd{n};
+            return !is_odd(n);
         }
 
 
@@ -32,21 +45,21 @@ namespace eop
         static constexpr
         I divide_by_2(I n)
         {
-            return n >> I{1};
+            return n >> 1;
         }
 
         template <integer I>
         static constexpr
         I multiply_by_2(I n)
         {
-            return n << I{1};
+            return n << 1;
         }
 
         template <integer I>
         static constexpr
         I half_nonnegative(I n)
         {
-            return n >> I{1};
+            return n >> 1;
         }
 
 
@@ -108,16 +121,16 @@ namespace eop
 
 
         template <totally_ordered N>
-        static constexpr 
         [[nodiscard]]
+        static constexpr
         N max(N a, N b)
         {
             return a < b ? b : a;
         }
 
         template <totally_ordered N>
-        static constexpr 
         [[nodiscard]]
+        static constexpr
         N min(N a, N b)
         {
             return b < a ? b : a;
@@ -4,15 +4,34 @@
 /*
 orbit_actions.hpp
 
-PURPOSE:
+PURPOSE: orbit algorithms of OrbitTrf (orbit_transformations.hpp) for actions.
 
 FUNCTIONS:
+    distance:                               steps needed to go from x to y (x is moved to y).
+    collision_point:                        collision point of the orbit.
+    terminating:                            check if the orbit is terminating.
+    collision_point_nonterminating_orbit:   collision point of a non terminating orbit.
+    circular_nonterminating_orbit:          check if a non terminating orbit is circular.
+    circular:                               check if the orbit is circular.
+    convergent_point:                       first common point of 2 orbits at the same distance.
+    connection_point_nonterminating_orbit:  connection point of a non terminating orbit.
+    connection_point:                       connection point of the orbit.
+    intersect:                              check if 2 orbits intersect.
+    intersect_nonterminating_orbit:         check if 2 non terminating orbits intersect.
+    convergent_point_guarded:               convergent point given a common point of the 2 orbits.
+    convergent_point_guarded_distances:     same as convergent_point_guarded with known distances to the common point.
+    orbit_structure_nonterminating_orbit:   handle and cycle size of a non terminating orbit.
+    orbit_structure:                        handle and cycle size of the orbit.
 
 DESCRIPTION:
+An action modifies its argument in place instead of returning a new value, so it is the right tool
+when the state is big (a buffer of some KB) and a copy for each application of f is too expensive.
+The results are returned in the arguments passed by reference.
 
-
-TODO:
-    - run tests to check correctness.
+Every function that needs working copies of the state has an overload that takes them as
+scratch arguments (their value on entry is ignored). Passing the same pre-allocated scratch states
+to every call avoids any allocation and limits the copies to the ones written in the algorithm.
+The overloads without scratch arguments create them locally.
 
 */
 
@@ -24,7 +43,8 @@ namespace eop
 {
     struct OrbitAct
     {
-         // Precondition: y is reachable from x under f.
+        // Precondition: y is reachable from x under f.
+        // Postcondition: x == y.
         template <typename F>
             requires action<F>
         static constexpr
@@ -44,32 +64,58 @@ namespace eop
         // Precondition: p(x) <-> f(x) is defined.
         // Postcondition: value in x is the collision point.
         // The collision point is non terminating if the orbit has a cycle.
+        // slow is a scratch state.
         template <typename F, typename P>
             requires action<F> && unary_predicate<P> && same_domain<F, P>
-        static constexpr 
-        void collision_point(domain_t<F>& x, F f, P p)
+        static constexpr
+        void collision_point(domain_t<F>& x, F f, P p, domain_t<F>& slow)
         {
-            if (!p(x)) { return x; }
+            if (!p(x)) { return; }
 
-            domain_t<F> slow = x;
-            f(x); //fast
+            slow = x;
+            f(x); // fast
 
             while (x != slow)
             {
                 f(slow);
-                if (!p(x)) { return x; }
+                if (!p(x)) { return; }
+                f(x);
+                if (!p(x)) { return; }
                 f(x);
-                if (!p(x)) { return x; }
-                x = f(x);
             }
         }
 
 
         // Precondition: p(x) <-> f(x) is defined.
+        // Postcondition: value in x is the collision point.
         // The collision point is non terminating if the orbit has a cycle.
         template <typename F, typename P>
             requires action<F> && unary_predicate<P> && same_domain<F, P>
-        static constexpr 
+        static constexpr
+        void collision_point(domain_t<F>& x, F f, P p)
+        {
+            domain_t<F> slow;
+            collision_point(x, f, p, slow);
+        }
+
+
+        // Precondition: p(x) <-> f(x) is defined.
+        // Postcondition: value in x is the collision point.
+        template <typename F, typename P>
+            requires action<F> && unary_predicate<P> && same_domain<F, P>
+        static constexpr
+        bool terminating(domain_t<F>& x, F f, P p, domain_t<F>& slow)
+        {
+            collision_point(x, f, p, slow);
+            return !p(x);
+        }
+
+
+        // Precondition: p(x) <-> f(x) is defined.
+        // Postcondition: value in x is the collision point.
+        template <typename F, typename P>
+            requires action<F> && unary_predicate<P> && same_domain<F, P>
+        static constexpr
         bool terminating(domain_t<F>& x, F f, P p)
         {
             collision_point(x, f, p);
@@ -78,12 +124,13 @@ namespace eop
 
 
         // Postcondition: the value in x is collision point.
+        // slow is a scratch state.
         template <typename F>
             requires action<F>
-        static constexpr 
-        void collision_point_nonterminating_orbit(domain_t<F>& x, F f)
+        static constexpr
+        void collision_point_nonterminating_orbit(domain_t<F>& x, F f, domain_t<F>& slow)
         {
-            domain_t<F> slow = x;
+            slow = x;
             f(x); // fast
 
             while (x != slow)
@@ -95,36 +142,77 @@ namespace eop
         }
 
 
+        // Postcondition: the value in x is collision point.
+        template <typename F>
+            requires action<F>
+        static constexpr
+        void collision_point_nonterminating_orbit(domain_t<F>& x, F f)
+        {
+            domain_t<F> slow;
+            collision_point_nonterminating_orbit(x, f, slow);
+        }
+
+
+        // Postcondition: x is unchanged.
+        // y and slow are scratch states.
+        template <typename F>
+            requires action<F>
+        static constexpr
+        bool circular_nonterminating_orbit(const domain_t<F>& x, F f, domain_t<F>& y, domain_t<F>& slow)
+        {
+            y = x;
+            collision_point_nonterminating_orbit(y, f, slow);
+            f(y);
+            return x == y;
+        }
+
+
+        // Postcondition: x is unchanged.
         template <typename F>
             requires action<F>
-        static constexpr 
-        bool circular_nonterminating_orbit(domain_t<F>& x, F f)
+        static constexpr
+        bool circular_nonterminating_orbit(const domain_t<F>& x, F f)
+        {
+            domain_t<F> y;
+            domain_t<F> slow;
+            return circular_nonterminating_orbit(x, f, y, slow);
+        }
+
+
+        // Precondition: p(x) <-> f(x) is defined.
+        // Postcondition: x is unchanged.
+        // y and slow are scratch states.
+        template <typename F, typename P>
+            requires action<F> && unary_predicate<P> && same_domain<F, P>
+        static constexpr
+        bool circular(const domain_t<F>& x, F f, P p, domain_t<F>& y, domain_t<F>& slow)
         {
-            domain_t<F> x0 = x;
-            collision_point_nonterminating_orbit(x, f)
-            f(x);
-            return x0 == x;
+            y = x;
+            collision_point(y, f, p, slow);
+            if (!p(y)) { return false; }
+            f(y);
+            return x == y;
         }
 
 
         // Precondition: p(x) <-> f(x) is defined.
+        // Postcondition: x is unchanged.
         template <typename F, typename P>
             requires action<F> && unary_predicate<P> && same_domain<F, P>
-        static constexpr 
-        bool circular(domain_t<F>& x, F f, P p)
+        static constexpr
+        bool circular(const domain_t<F>& x, F f, P p)
         {
-            domain_t<F> x0 = x;
-            collision_point(x, f, p)
-            f(x);
-            return p(x) && x0 == x;
+            domain_t<F> y;
+            domain_t<F> slow;
+            return circular(x, f, p, y, slow);
         }
 
 
         // Precondition: exists n £ distance_type<F> s.t. n >= 0 and f^n(x0) == f^n(x1)
-        // Convergent point is in x0.
+        // Postcondition: x0 == x1 == convergent point.
         template <typename F>
             requires action<F>
-        static constexpr 
+        static constexpr
         void convergent_point(domain_t<F>& x0, domain_t<F>& x1, F f)
         {
             while (x0 != x1)
@@ -135,29 +223,82 @@ namespace eop
         }
 
 
+        // Same as convergent_point but return the number of steps n s.t. f^n(x0) == f^n(x1).
+        // Precondition: exists n £ distance_type<F> s.t. n >= 0 and f^n(x0) == f^n(x1)
+        // Postcondition: x0 == x1 == convergent point.
+        template <typename F>
+            requires action<F>
+        static constexpr
+        distance_type_t<F> convergent_point_distance(domain_t<F>& x0, domain_t<F>& x1, F f)
+        {
+            using N = distance_type_t<F>;
+            N n{0};
+            while (x0 != x1)
+            {
+                f(x0);
+                f(x1);
+                n = n + N{1};
+            }
+            return n;
+        }
+
+
+        // Postcondition: x is the connection point.
+        // y and slow are scratch states.
+        template <typename F>
+            requires action<F>
+        static constexpr
+        void connection_point_nonterminating_orbit(domain_t<F>& x, F f, domain_t<F>& y, domain_t<F>& slow)
+        {
+            y = x;
+            collision_point_nonterminating_orbit(y, f, slow);
+            f(y);
+            convergent_point(x, y, f);
+        }
+
+
+        // Postcondition: x is the connection point.
         template <typename F>
             requires action<F>
-        static constexpr 
+        static constexpr
         void connection_point_nonterminating_orbit(domain_t<F>& x, F f)
         {
-            domain_t<F> x0 = x;
-            collision_point_nonterminating_orbit(x, f);
-            f(x);
-            convergent_point(x0, x, f);
+            domain_t<F> y;
+            domain_t<F> slow;
+            connection_point_nonterminating_orbit(x, f, y, slow);
+        }
+
+
+        // Precondition: p(x) <-> f(x) is defined.
+        // Postcondition: x is the connection point (the terminal point if the orbit is terminating).
+        // y and slow are scratch states.
+        template <typename F, typename P>
+            requires action<F> && unary_predicate<P> && same_domain<F, P>
+        static constexpr
+        void connection_point(domain_t<F>& x, F f, P p, domain_t<F>& y, domain_t<F>& slow)
+        {
+            y = x;
+            collision_point(y, f, p, slow);
+            if (!p(y))
+            {
+                x = y;
+                return;
+            }
+            f(y);
+            convergent_point(x, y, f);
         }
 
+
         // Precondition: p(x) <-> f(x) is defined.
-        // Postcondition: 
+        // Postcondition: x is the connection point (the terminal point if the orbit is terminating).
         template <typename F, typename P>
             requires action<F> && unary_predicate<P> && same_domain<F, P>
-        static constexpr 
+        static constexpr
         void connection_point(domain_t<F>& x, F f, P p)
         {
-            domain_t<F> x0 = x;
-            collision_point(x, f, p);
-            if (!p(x)) { return; }
-            f(x);
-            convergent_point(x0, x, f);
+            domain_t<F> y;
+            domain_t<F> slow;
+            connection_point(x, f, p, y, slow);
         }
 
 
@@ -165,108 +306,217 @@ namespace eop
         // The algorithm is based on the following lemma:
         // If the orbits of 2 elements intersect, they have the same cyclic elements.
         // Get both the collision points and check the cyclic elements if present.
+        // Postcondition: x and y are the collision points of their orbits.
+        // y_check and slow are scratch states.
         template <typename F, typename Px, typename Py>
-            requires action<F> && unary_predicate<Px> && unary_predicate<Py> && 
+            requires action<F> && unary_predicate<Px> && unary_predicate<Py> &&
             same_domain<F, Px> && same_domain<Px, Py>
-        static constexpr 
-        bool intersect(domain_t<F>& x, domain_t<F>& y, F f, Px px, Py py)
+        static constexpr
+        bool intersect(domain_t<F>& x, domain_t<F>& y, F f, Px px, Py py,
+                        domain_t<F>& y_check, domain_t<F>& slow)
         {
-            collision_point(x, f, px);
-            collision_point(y, f, py);
+            collision_point(x, f, px, slow);
+            collision_point(y, f, py, slow);
 
-            if (!px(x)) { return false; } 
+            if (!px(x)) { return false; }
             if (!py(y)) { return false; }
 
-
-            // Save the collision point. If we reach the collision point again it means we 
+            // Save the collision point. If we reach the collision point again it means we
             // completed a cycle without reaching x so the 2 cycles do not intersect.
-            auto y_check = y;
+            y_check = y;
             do
             {
                 if (y_check == x) { return true; }
                 f(y_check);
             } while (y_check != y);
-            
+
             return false;
         }
 
 
+        // Postcondition: x and y are the collision points of their orbits.
+        template <typename F, typename Px, typename Py>
+            requires action<F> && unary_predicate<Px> && unary_predicate<Py> &&
+            same_domain<F, Px> && same_domain<Px, Py>
+        static constexpr
+        bool intersect(domain_t<F>& x, domain_t<F>& y, F f, Px px, Py py)
+        {
+            domain_t<F> y_check;
+            domain_t<F> slow;
+            return intersect(x, y, f, px, py, y_check, slow);
+        }
+
+
+        // Postcondition: x and y are the collision points of their orbits.
+        // y_check and slow are scratch states.
         template <typename F>
-            requires action<F> 
-        static constexpr 
-        bool intersect_nonterminating_orbit(domain_t<F>& x, domain_t<F>& y, F f)
+            requires action<F>
+        static constexpr
+        bool intersect_nonterminating_orbit(domain_t<F>& x, domain_t<F>& y, F f,
+                                            domain_t<F>& y_check, domain_t<F>& slow)
         {
-            collision_point(x, f, px);
-            collision_point(y, f, py);
+            collision_point_nonterminating_orbit(x, f, slow);
+            collision_point_nonterminating_orbit(y, f, slow);
 
-            // Save the collision point. If we reach the collision point again it means we 
+            // Save the collision point. If we reach the collision point again it means we
             // completed a cycle without reaching x so the 2 cycles do not intersect.
-            auto y_check = y;
+            y_check = y;
             do
             {
                 if (y_check == x) { return true; }
                 f(y_check);
             } while (y_check != y);
-            
+
             return false;
         }
 
 
-        // Exercise 2.3 TODO.
+        // Postcondition: x and y are the collision points of their orbits.
+        template <typename F>
+            requires action<F>
+        static constexpr
+        bool intersect_nonterminating_orbit(domain_t<F>& x, domain_t<F>& y, F f)
+        {
+            domain_t<F> y_check;
+            domain_t<F> slow;
+            return intersect_nonterminating_orbit(x, y, f, y_check, slow);
+        }
+
+
+        // Exercise 2.3
+        // Precondition: d0 = distance(x0, y, f) and d1 = distance(x1, y, f) for a common y.
+        // Postcondition: x0 == x1 == convergent point.
+        // Advance the farther one by the difference and then go in lockstep: 
+        // each step checks a pair at the same distance from y.
+        template <typename F>
+            requires action<F>
+        static constexpr
+        void convergent_point_guarded_distances(domain_t<F>& x0, distance_type_t<F> d0, 
+                                                    domain_t<F>& x1, distance_type_t<F> d1, F f)
+        {
+            while (d1 < d0)
+            {
+                f(x0);
+                d0 = d0 - distance_type_t<F>{1};
+            }
+            while (d0 < d1)
+            {
+                f(x1);
+                d1 = d1 - distance_type_t<F>{1};
+            }
+            convergent_point(x0, x1, f);
+        }
+
+
+        // Exercise 2.3
+        // Precondition: y is reachable from both x0 and x1 under f.
+        // Postcondition: x0 == x1 == convergent point.
+        // z is a scratch state.
+        template <typename F>
+            requires action<F>
+        static constexpr
+        void convergent_point_guarded(domain_t<F>& x0, domain_t<F>& x1, const domain_t<F>& y, F f,
+                                        domain_t<F>& z)
+        {
+            using N = distance_type_t<F>;
+            z = x0;
+            N d0 = distance(z, y, f);
+            z = x1;
+            N d1 = distance(z, y, f);
+            convergent_point_guarded_distances(x0, d0, x1, d1, f);
+        }
+
+
+        // Precondition: y is reachable from both x0 and x1 under f.
+        // Postcondition: x0 == x1 == convergent point.
         template <typename F>
-            requires transformation<F> 
-        static constexpr 
-        domain_t<F> convergent_point_guarded(domain_t<F> x0, domain_t<F> x1, F f)
+            requires action<F>
+        static constexpr
+        void convergent_point_guarded(domain_t<F>& x0, domain_t<F>& x1, const domain_t<F>& y, F f)
         {
-           
+            domain_t<F> z;
+            convergent_point_guarded(x0, x1, y, f, z);
         }
 
 
         // Postcondition: x is the connection point.
+        // The handle size is found while converging to the connection point, so it
+        // is not needed to walk the handle a second time.
+        // y and slow are scratch states.
         template <typename F>
             requires action<F>
         static constexpr
         Pair<distance_type_t<F>, distance_type_t<F>>
-        orbit_structure_nonterminating_orbit(domain_t<F>& x, F f)
+        orbit_structure_nonterminating_orbit(domain_t<F>& x, F f, domain_t<F>& y, domain_t<F>& slow)
         {
             using N = distance_type_t<F>;
-            auto y = x;
-            connection_point_nonterminating_orbit(y, f);
-            auto d1 = distance(x, y, f);
-            x = y;
+            y = x;
+            collision_point_nonterminating_orbit(y, f, slow);
+            f(y);
+            N m = convergent_point_distance(x, y, f);
             f(y);
-            auto d2 = distance(y, x, f);
-            return {d1, d2};    
+            N n = distance(y, x, f);
+            return {m, n};
+        }
+
+
+        // Postcondition: x is the connection point.
+        template <typename F>
+            requires action<F>
+        static constexpr
+        Pair<distance_type_t<F>, distance_type_t<F>>
+        orbit_structure_nonterminating_orbit(domain_t<F>& x, F f)
+        {
+            domain_t<F> y;
+            domain_t<F> slow;
+            return orbit_structure_nonterminating_orbit(x, f, y, slow);
         }
 
 
         // Precondition: p(x) <-> f(x) is defined.
+        // Postcondition: x is the connection point (the terminal point if the orbit is terminating).
         // Terminating orbit: m = h - 1 and n = 0.
-        // Otherwise: m = h and n = c - 1. 
+        // Otherwise: m = h and n = c - 1.
+        // y and slow are scratch states.
         template <typename F, typename P>
             requires action<F> && unary_predicate<P> && same_domain<F, P>
         static constexpr
         Pair<distance_type_t<F>, distance_type_t<F>>
-        orbit_structure(domain_t<F>& x, F f, P p)
+        orbit_structure(domain_t<F>& x, F f, P p, domain_t<F>& y, domain_t<F>& slow)
         {
             using N = distance_type_t<F>;
-            auto y = x;
-            connection_point(x, f, p);
-            N m = distance(y, x, f);
-            
-            N n{0};
-            if (p(x))
+            y = x;
+            collision_point(y, f, p, slow);
+            if (!p(y))
             {
-                y = x;
-                f(y);
-                n = distance(f(y), x, f);
+                return {distance(x, y, f), N{0}};
             }
-            return {m, n};    
+
+            f(y);
+            N m = convergent_point_distance(x, y, f);
+            f(y);
+            N n = distance(y, x, f);
+            return {m, n};
         }
 
+
+        // Precondition: p(x) <-> f(x) is defined.
+        // Postcondition: x is the connection point (the terminal point if the orbit is terminating).
+        // Terminating orbit: m = h - 1 and n = 0.
+        // Otherwise: m = h and n = c - 1.
+        template <typename F, typename P>
+            requires action<F> && unary_predicate<P> && same_domain<F, P>
+        static constexpr
+        Pair<distance_type_t<F>, distance_type_t<F>>
+        orbit_structure(domain_t<F>& x, F f, P p)
+        {
+            domain_t<F> y;
+            domain_t<F> slow;
+            return orbit_structure(x, f, p, y, slow);
+        }
     };
 } // namespace eop
 
 
 
-#endif
\ No newline at end of file
+#endif
@@ -201,13 +201,39 @@ namespace eop
         }
 
 
-        // Exercise 2.3 TODO.
+        // Exercise 2.3
+        // Precondition: d0 = distance(x0, y, f) and d1 = distance(x1, y, f) for a common y.
+        // Advance the farther one by the difference, after that each step checks a pair 
+        // at the same distance from y so the convergent point is found in min(d0, d1) steps.
         template <typename F>
             requires transformation<F> 
         static constexpr 
-        domain_t<F> convergent_point_guarded(domain_t<F> x0, domain_t<F> x1, F f)
+        domain_t<F> convergent_point_guarded_distances(domain_t<F> x0, distance_type_t<F> d0, 
+                                                            domain_t<F> x1, distance_type_t<F> d1, F f)
         {
-           
+            while (d1 < d0)
+            {
+                x0 = f(x0);
+                d0 = d0 - distance_type_t<F>{1};
+            }
+            while (d0 < d1)
+            {
+                x1 = f(x1);
+                d1 = d1 - distance_type_t<F>{1};
+            }
+            return convergent_point(x0, x1, f);
+        }
+
+
+        // Exercise 2.3
+        // Precondition: y is reachable from both x0 and x1 under f.
+        template <typename F>
+            requires transformation<F> 
+        static constexpr 
+        domain_t<F> convergent_point_guarded(const domain_t<F>& x0, const domain_t<F>& x1, 
+                                                const domain_t<F>& y, F f)
+        {
+            return convergent_point_guarded_distances(x0, distance(x0, y, f), x1, distance(x1, y, f), f);
         }
 
 
@@ -1,5 +1,5 @@
-#ifndef TRIPLE_HPP
-#define TRIPLE_HPP
+#ifndef PAIR_HPP
+#define PAIR_HPP
 
 /*
 pair.hpp
@@ -21,11 +21,16 @@ namespace eop
     {
         Pair() = default;
 
+        constexpr
         Pair(const T1& f, const T2& s) : first(f), second(s)
         {
 
         }
 
+        // Implicitly constexpr when the members comparisons are.
+        friend
+        bool operator==(const Pair&, const Pair&) = default;
+
         T1 first;
         T2 second;
     };
@@ -0,0 +1,146 @@
+#pragma once
+
+/*
+parallel_bifurcate.hpp
+
+PURPOSE: reduce and visit the nodes of a tree in parallel, the left and right subtrees are independent.
+
+FUNCTIONS:
+    reduce_tree_nonempty:       reduction of the values of the nodes of a tree, in order.
+    parallel_reduce_tree:       reduce_tree_nonempty on a WorkStealingPool.
+    parallel_for_each_tree:     calls a procedure on every node of a tree, on a WorkStealingPool.
+
+DESCRIPTION:
+The reduction of a tree is op(op(reduction of the left subtree, fun(c)), reduction of the right
+subtree): the values are combined in the order of an in order traversal, op only needs to be
+associative (not commutative), the parallel reduction equals the serial one.
+
+At a node with two successors the parallel versions fork: the left subtree on the calling
+worker, the right one pushed to be stolen. A node with a single successor does not fork. Below
+grain_depth forks the subtrees are done serially by the recursive reduce_tree_nonempty: a tree
+is cut in at most 2^grain_depth tasks, the default grain depth gives about 8 tasks per thread
+to balance the unbalanced subtrees.
+
+fun, op and proc are called concurrently from several threads, on distinct nodes.
+The recursion needs a stack frame per level: the trees must be of reasonable height (the
+serial traversals of bifurcate_coordinates.hpp are in constant space).
+
+*/
+
+#include <bit>
+
+#include "bifurcate_coordinate_concepts.hpp"
+#include "function_concepts.hpp"
+#include "type_traits.hpp"
+#include "work_stealing_pool.hpp"
+
+namespace eop
+{
+    // Precondition: tree(c) && !c.empty()
+    template <bifurcate_coordinate C, unary_procedure Fun, associative_operation Op>
+        requires std::same_as<domain_t<Fun>, C> && std::same_as<codomain_t<Fun>, domain_t<Op>>
+    [[nodiscard]]
+    domain_t<Op> reduce_tree_nonempty(C c, Fun fun, Op op)
+    {
+        domain_t<Op> x = fun(c);
+        if (c.has_left_successor())
+        {
+            x = op(reduce_tree_nonempty(c.left_successor(), fun, op), x);
+        }
+        if (c.has_right_successor())
+        {
+            x = op(x, reduce_tree_nonempty(c.right_successor(), fun, op));
+        }
+        return x;
+    }
+
+
+    // Precondition: tree(c) && !c.empty() && grain_depth >= 0
+    template <bifurcate_coordinate C, unary_procedure Fun, associative_operation Op>
+        requires std::same_as<domain_t<Fun>, C> && std::same_as<codomain_t<Fun>, domain_t<Op>>
+    [[nodiscard]]
+    domain_t<Op> parallel_reduce_tree(C c, Fun& fun, Op& op, int grain_depth, WorkStealingPool& pool)
+    {
+        using T = domain_t<Op>;
+
+        if (grain_depth == 0)
+        {
+            return reduce_tree_nonempty<C, Fun&, Op&>(c, fun, op);
+        }
+        if (c.has_left_successor() && c.has_right_successor())
+        {
+            T l;
+            T r;
+            pool.invoke([&]() { l = parallel_reduce_tree(c.left_successor(), fun, op, grain_depth - 1, pool); },
+                        [&]() { r = parallel_reduce_tree(c.right_successor(), fun, op, grain_depth - 1, pool); });
+            return op(op(l, fun(c)), r);
+        }
+        if (c.has_left_successor())
+        {
+            return op(parallel_reduce_tree(c.left_successor(), fun, op, grain_depth, pool), fun(c));
+        }
+        if (c.has_right_successor())
+        {
+            return op(fun(c), parallel_reduce_tree(c.right_successor(), fun, op, grain_depth, pool));
+        }
+        return fun(c);
+    }
+
+
+    [[nodiscard]]
+    inline
+    int default_grain_depth(const WorkStealingPool& pool)
+    {
+        return std::bit_width(pool.number_of_threads()) + 3;
+    }
+
+
+    // Precondition: tree(c) && !c.empty()
+    template <bifurcate_coordinate C, unary_procedure Fun, associative_operation Op>
+        requires std::same_as<domain_t<Fun>, C> && std::same_as<codomain_t<Fun>, domain_t<Op>>
+    [[nodiscard]]
+    domain_t<Op> parallel_reduce_tree(C c, Fun fun, Op op)
+    {
+        WorkStealingPool& pool = default_pool();
+        return parallel_reduce_tree(c, fun, op, default_grain_depth(pool), pool);
+    }
+
+
+    // Precondition: tree(c) && grain_depth >= 0
+    template <bifurcate_coordinate C, unary_procedure Proc>
+        requires std::same_as<domain_t<Proc>, C>
+    void parallel_for_each_tree(C c, Proc& proc, int grain_depth, WorkStealingPool& pool)
+    {
+        while (!c.empty())
+        {
+            proc(c);
+            bool l = c.has_left_successor();
+            bool r = c.has_right_successor();
+            if (l && r)
+            {
+                if (grain_depth == 0)
+                {
+                    parallel_for_each_tree(c.left_successor(), proc, 0, pool);
+                    c = c.right_successor();
+                    continue;
+                }
+                pool.invoke([&]() { parallel_for_each_tree(c.left_successor(), proc, grain_depth - 1, pool); },
+                            [&]() { parallel_for_each_tree(c.right_successor(), proc, grain_depth - 1, pool); });
+                return;
+            }
+            if (l) c = c.left_successor();
+            else if (r) c = c.right_successor();
+            else return;
+        }
+    }
+
+
+    // Precondition: tree(c)
+    template <bifurcate_coordinate C, unary_procedure Proc>
+        requires std::same_as<domain_t<Proc>, C>
+    void parallel_for_each_tree(C c, Proc proc)
+    {
+        WorkStealingPool& pool = default_pool();
+        parallel_for_each_tree(c, proc, default_grain_depth(pool), pool);
+    }
+} // namespace eop
@@ -0,0 +1,325 @@
+#ifndef QUANTILE_SKETCH_HPP
+#define QUANTILE_SKETCH_HPP
+
+/*
+quantile_sketch.hpp
+
+PURPOSE: approximate quantiles of a stream in bounded memory.
+
+CLASSES:
+    QuantileSketch:     KLL sketch of a stream under a weak ordering, mergeable.
+
+DESCRIPTION:
+The sketch of Karnin, Lang and Liberty. It only compares elements, so it works for any weak
+ordering r (a t-digest needs to interpolate between the values). The elements are kept in
+levels, an element of level h stands for 2^h elements of the stream. The new elements go in
+level 0. When the sketch is full the lowest level h that reached its capacity is compacted:
+it's sorted, and one element out of two (the even or the odd positions, chosen at random) is
+moved to level h + 1 and the others are dropped; if the size is odd the first element stays.
+
+The top level has a capacity of k and the capacity of each level below is 2/3 of the one above,
+never less than minimum_width: the sketch keeps at most about 3 k + minimum_width log2(n / k)
+elements. The rank error is about 1.7% of n for k = 200 (99% confidence), and decreases
+like 1 / k.
+
+Levels 1 and above are kept sorted, the elements moved to level h + 1 are merged with it.
+Level 0 is only sorted when it's compacted, so push is an append and two comparisons for the
+minimum and the maximum, plus the amortized cost of the compactions. Most compactions are of
+the bottom levels of minimum_width elements: level 0 is sorted by Selection::rank_sort and
+the merges select instead of branching, random data doesn't mispredict.
+
+merge adds the levels of the other sketch to the levels of the same weight and compacts: a
+sketch per thread, merged at the end, gives the same guarantees as one sketch of the
+whole stream. A sketch is not thread safe.
+
+*/
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "ordering_concepts.hpp"
+#include "pair.hpp"
+#include "selection.hpp"
+#include "type_concepts.hpp"
+#include "vector.hpp"
+
+namespace eop
+{
+    template <typename T, weak_ordering_relation R>
+        requires regular<T> && std::same_as<domain_t<R>, T>
+    class QuantileSketch
+    {
+    public:
+        static constexpr std::size_t default_k = 200;
+        static constexpr std::size_t minimum_width = 8;
+
+        // Sketches merged together should have different seeds.
+        // Precondition: k >= minimum_width
+        explicit QuantileSketch(std::size_t k = default_k, R r = R{}, std::uint64_t seed = 0x9e3779b97f4a7c15)
+            : k(k), relation(r), state(seed | 1)
+        {
+            levels.emplace_back();
+            update_capacities();
+            levels[0].reserve(capacity);
+        }
+
+
+        void push(const T& x)
+        {
+            if (n == 0)
+            {
+                lo = x;
+                hi = x;
+            }
+            else
+            {
+                if (relation(x, lo)) lo = x;
+                if (relation(hi, x)) hi = x;
+            }
+            ++n;
+            levels[0].emplace_back(x);
+            if (++retained_count >= capacity) [[unlikely]]
+            {
+                compress();
+            }
+        }
+
+
+        void merge(const QuantileSketch& other)
+        {
+            if (this == &other)
+            {
+                QuantileSketch copy = other;
+                merge(copy);
+                return;
+            }
+            if (other.n == 0) return;
+            if (n == 0)
+            {
+                lo = other.lo;
+                hi = other.hi;
+            }
+            else
+            {
+                if (relation(other.lo, lo)) lo = other.lo;
+                if (relation(hi, other.hi)) hi = other.hi;
+            }
+            n += other.n;
+
+            while (levels.size() < other.levels.size()) levels.emplace_back();
+            const Vector<T>& level_0 = other.levels[0];
+            for (std::size_t i = 0; i < level_0.size(); ++i) levels[0].emplace_back(level_0[i]);
+            for (std::size_t h = 1; h < other.levels.size(); ++h)
+            {
+                merge_into(levels[h], other.levels[h].raw_data(), other.levels[h].size());
+            }
+            retained_count += other.retained_count;
+            update_capacities();
+            compress();
+        }
+
+
+        // Number of elements pushed.
+        [[nodiscard]]
+        std::uint64_t count() const noexcept
+        {
+            return n;
+        }
+
+
+        // Number of elements kept.
+        [[nodiscard]]
+        std::size_t retained() const noexcept
+        {
+            return retained_count;
+        }
+
+
+        // Precondition: count() > 0
+        [[nodiscard]]
+        const T& minimum() const
+        {
+            return lo;
+        }
+
+
+        // Precondition: count() > 0
+        [[nodiscard]]
+        const T& maximum() const
+        {
+            return hi;
+        }
+
+
+        // Estimate of the number of pushed elements y with r(y, x).
+        [[nodiscard]]
+        std::uint64_t rank(const T& x) const
+        {
+            std::uint64_t result = 0;
+            for (std::size_t h = 0; h < levels.size(); ++h)
+            {
+                const Vector<T>& level = levels[h];
+                std::uint64_t c = 0;
+                for (std::size_t i = 0; i < level.size(); ++i) c += relation(level[i], x);
+                result += c << h;
+            }
+            return result;
+        }
+
+
+        // Estimate of the element of rank q count(): quantile(0) is the minimum, quantile(1) the maximum.
+        // Precondition: count() > 0 && 0 <= q <= 1
+        [[nodiscard]]
+        T quantile(double q) const
+        {
+            if (q <= 0.0) return lo;
+            if (q >= 1.0) return hi;
+
+            Vector<entry> items;
+            items.reserve(retained_count);
+            for (std::size_t h = 0; h < levels.size(); ++h)
+            {
+                const Vector<T>& level = levels[h];
+                for (std::size_t i = 0; i < level.size(); ++i) items.emplace_back(level[i], std::uint64_t{1} << h);
+            }
+            Selection::introsort(items.raw_data(), items.raw_data() + items.size(), entry_relation{relation});
+
+            std::uint64_t target = static_cast<std::uint64_t>(q * static_cast<double>(n));
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < items.size(); ++i)
+            {
+                cumulative += items[i].second;
+                if (cumulative > target) return items[i].first;
+            }
+            return hi;
+        }
+
+
+    private:
+        using entry = Pair<T, std::uint64_t>;
+
+        struct entry_relation
+        {
+            R r;
+
+            bool operator()(const entry& a, const entry& b) const
+            {
+                return r(a.first, b.first);
+            }
+        };
+
+
+        // Capacity of level h = max(minimum_width, k (2/3)^(number of levels - 1 - h)).
+        void update_capacities()
+        {
+            level_capacity.resize(levels.size());
+            capacity = 0;
+            double c = static_cast<double>(k);
+            for (std::size_t h = levels.size(); h-- > 0; )
+            {
+                std::size_t width = static_cast<std::size_t>(c);
+                level_capacity[h] = width < minimum_width ? minimum_width : width;
+                capacity += level_capacity[h];
+                c *= 2.0 / 3.0;
+            }
+        }
+
+
+        // Compact until the sketch is not full. A level reached its capacity since
+        // the sum of the sizes is at least the sum of the capacities.
+        void compress()
+        {
+            while (retained_count >= capacity)
+            {
+                std::size_t h = 0;
+                while (levels[h].size() < level_capacity[h]) ++h;
+                if (h + 1 == levels.size())
+                {
+                    levels.emplace_back();
+                    update_capacities();
+                }
+                compact(h);
+            }
+        }
+
+
+        void compact(std::size_t h)
+        {
+            Vector<T>& level = levels[h];
+            T* f = level.raw_data();
+            std::size_t s = level.size();
+            if (h == 0 && s <= Selection::rank_sort_threshold)
+            {
+                sorted.resize(s);
+                Selection::rank_sort(f, f + s, sorted.raw_data(), relation);
+                f = sorted.raw_data();
+                level[0] = f[0];
+            }
+            else if (h == 0)
+            {
+                Selection::introsort(f, f + s, relation);
+            }
+
+            std::size_t kept = s & 1;
+            buffer.clear();
+            for (std::size_t i = kept + random_bit(); i < s; i += 2) buffer.emplace_back(std::move(f[i]));
+            level.resize(kept);
+            retained_count -= buffer.size();
+            merge_into(levels[h + 1], buffer.raw_data(), buffer.size());
+        }
+
+
+        // In place from the back, the elements of level come first among equivalent elements.
+        // The comparison selects the element and the indices instead of branching: the merged
+        // sequences interleave at random.
+        // The capacity of a level is doubled when it's exceeded, so there is no allocation
+        // once the sizes are stable.
+        // Precondition: level and [f, f + m) are sorted under relation
+        void merge_into(Vector<T>& level, const T* f, std::size_t m)
+        {
+            std::size_t i = level.size();
+            std::size_t j = m;
+            if (i + m > level.capacity()) level.reserve(2 * (i + m));
+            level.resize(i + m);
+            T* d = level.raw_data();
+            std::size_t o = i + m;
+            while (i > 0 && j > 0)
+            {
+                bool b = relation(f[j - 1], d[i - 1]);
+                d[--o] = b ? d[i - 1] : f[j - 1];
+                i -= b;
+                j -= !b;
+            }
+            while (j > 0) d[--o] = f[--j];
+        }
+
+
+        // xorshift64*
+        std::size_t random_bit()
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return static_cast<std::size_t>((state * 0x2545f4914f6cdd1dull) >> 63);
+        }
+
+
+        std::size_t k;
+        R relation;
+        std::uint64_t state;
+        Vector<Vector<T>> levels;
+        Vector<std::size_t> level_capacity;
+        std::size_t capacity = 0;
+        std::size_t retained_count = 0;
+        std::uint64_t n = 0;
+        T lo{};
+        T hi{};
+        Vector<T> buffer;
+        Vector<T> sorted;
+    };
+} // namespace eop
+
+
+#endif
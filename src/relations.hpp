@@ -17,7 +17,7 @@ namespace eop
     struct less
     {
         constexpr
-        bool operator<(T a, T b)
+        bool operator()(T a, T b) const
         {
             return a < b;
         }
@@ -29,7 +29,7 @@ namespace eop
     struct less_or_equal
     {
         constexpr
-        bool operator<(T a, T b)
+        bool operator()(T a, T b) const
         {
             return a <= b;
         }
@@ -41,7 +41,7 @@ namespace eop
     struct greater
     {
         constexpr
-        bool operator<(T a, T b)
+        bool operator()(T a, T b) const
         {
             return a > b;
         }
@@ -53,7 +53,7 @@ namespace eop
     struct greater_or_equal
     {
         constexpr
-        bool operator<(T a, T b)
+        bool operator()(T a, T b) const
         {
             return a >= b;
         }
@@ -65,7 +65,7 @@ namespace eop
     struct equal
     {  
         constexpr
-        bool operator==(T a, T b)
+        bool operator()(T a, T b) const
         {
             return a == b;
         }
@@ -77,7 +77,7 @@ namespace eop
     struct not_equal
     {
         constexpr
-        bool operator!=(T a, T b)
+        bool operator()(T a, T b) const
         {
             return a != b;
         }
@@ -0,0 +1,368 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+/*
+ring_buffer.hpp
+
+PURPOSE: bounded lock free queues between threads: one producer and one consumer, or several of each.
+
+CLASSES:
+    RingIterator:           forward iterator on a range of a circular array.
+    RingRange:              the elements readable by the consumer of a SpscRingBuffer, in place.
+    SpscRingBuffer:         queue of one producer thread and one consumer thread.
+    MpmcRingBuffer:         queue of any number of producer and consumer threads.
+
+DESCRIPTION:
+The elements are in a circular array of capacity slots, a power of 2, allocated once by the
+constructor. The positions of the producers (tail) and of the consumers (head) are counters that
+only increase, the slot of position p is p & (capacity - 1). Each counter is on its own cache line
+(alignas(64)): the producers and the consumers don't write the same lines.
+
+SpscRingBuffer: only the producer writes tail, only the consumer writes head. The producer
+publishes an element by a release store of tail after writing it, the consumer frees a slot by a
+release store of head after reading it. Each side keeps a copy of the counter of the other side
+and reloads it (a cache miss when the other side has moved) only when the copy says the queue is
+full or empty. push_n and pop_n move up to n elements for one store of the counter and one
+reload: the cost of the synchronization is shared by the batch. readable() gives the published
+elements as a range of RingIterator: for_each and reduce of algorithms.hpp run on them in the
+array, consume(k) frees the first k.
+
+MpmcRingBuffer (D. Vyukov's bounded queue): each slot has a sequence number. The slot of position
+p is free for the producer of p when its sequence is p, full for the consumer of p when it is
+p + 1; the consumer then sets it to p + capacity, free for the next round. A producer claims a
+position by a compare and swap of tail, a consumer by a compare and swap of head: no lock, a
+thread stopped in the middle of an operation only holds its slot. push_n and pop_n claim up to n
+consecutive ready slots with one compare and swap. The consumers of an MPMC queue must release
+each slot after reading it: pop_n copies, there's no readable range.
+
+For 10^8 integers from one thread to another on a single core (test_ring_buffer.cpp, the threads
+take turns): SpscRingBuffer moves 260 million messages per second one at a time, 500 million in
+batches of 256; MpmcRingBuffer 20 million one at a time, 135 million in batches of 16. Between
+cores the transfer of the cache lines of the slots and of the counters adds to these costs.
+
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "iterator.hpp"
+#include "type_concepts.hpp"
+#include "vector.hpp"
+
+namespace eop
+{
+    template <typename T>
+    class RingIterator
+    {
+    public:
+        using value_type = T;
+        using distance_type = std::size_t;
+        using iterator_tag = forward_iterator_tag;
+
+        RingIterator() = default;
+
+        RingIterator(const T* data, std::size_t mask, std::size_t p) : data(data), mask(mask), p(p) {}
+
+
+        [[nodiscard]]
+        T operator*() const
+        {
+            return data[p & mask];
+        }
+
+        // The element in the array.
+        [[nodiscard]]
+        const T& source() const noexcept
+        {
+            return data[p & mask];
+        }
+
+        RingIterator& operator++() noexcept
+        {
+            ++p;
+            return *this;
+        }
+
+        RingIterator operator++(int) noexcept
+        {
+            RingIterator tmp = *this;
+            ++p;
+            return tmp;
+        }
+
+        friend
+        bool operator==(const RingIterator&, const RingIterator&) = default;
+
+    private:
+        const T* data = nullptr;
+        std::size_t mask = 0;
+        std::size_t p = 0; // the position, not reduced
+    };
+
+
+    template <typename T>
+    struct RingRange
+    {
+        RingIterator<T> f;
+        RingIterator<T> l;
+        std::size_t n = 0;
+
+        [[nodiscard]]
+        RingIterator<T> begin() const noexcept
+        {
+            return f;
+        }
+
+        [[nodiscard]]
+        RingIterator<T> end() const noexcept
+        {
+            return l;
+        }
+
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return n;
+        }
+    };
+
+
+
+    // push and push_n are called by one thread, pop, pop_n, readable and consume by one thread.
+    template <typename T>
+        requires default_constructible<T> && movable<T>
+    class SpscRingBuffer
+    {
+    public:
+        // capacity is rounded up to a power of 2.
+        // Precondition: capacity > 0
+        explicit SpscRingBuffer(std::size_t capacity) : mask(std::bit_ceil(capacity) - 1)
+        {
+            slots.resize(mask + 1);
+            data = slots.raw_data();
+        }
+
+        SpscRingBuffer(const SpscRingBuffer&) = delete;
+        SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+
+        [[nodiscard]]
+        std::size_t capacity() const noexcept
+        {
+            return mask + 1;
+        }
+
+        // Exact when called by the producer or the consumer while the other one waits.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return producer.tail.load(std::memory_order_acquire) - consumer.head.load(std::memory_order_acquire);
+        }
+
+
+        // Producer: appends x, returns false if the queue is full.
+        bool push(const T& x)
+        {
+            std::size_t t = producer.tail.load(std::memory_order_relaxed);
+            if (t - producer.head == capacity())
+            {
+                producer.head = consumer.head.load(std::memory_order_acquire);
+                if (t - producer.head == capacity()) return false;
+            }
+            data[t & mask] = x;
+            producer.tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Producer: appends the first k of the n elements of [f, f + n) that fit, returns k.
+        template <typename I>
+        std::size_t push_n(I f, std::size_t n)
+        {
+            std::size_t t = producer.tail.load(std::memory_order_relaxed);
+            if (capacity() - (t - producer.head) < n)
+            {
+                producer.head = consumer.head.load(std::memory_order_acquire);
+            }
+            std::size_t k = std::min(n, capacity() - (t - producer.head));
+            for (std::size_t i = 0; i < k; ++i, ++f) data[(t + i) & mask] = *f;
+            producer.tail.store(t + k, std::memory_order_release);
+            return k;
+        }
+
+
+        // Consumer: moves the first element to x, returns false if the queue is empty.
+        bool pop(T& x)
+        {
+            std::size_t h = consumer.head.load(std::memory_order_relaxed);
+            if (h == consumer.tail)
+            {
+                consumer.tail = producer.tail.load(std::memory_order_acquire);
+                if (h == consumer.tail) return false;
+            }
+            x = std::move(data[h & mask]);
+            consumer.head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer: moves up to n first elements to [out, out + k), returns k.
+        template <typename O>
+        std::size_t pop_n(O out, std::size_t n)
+        {
+            std::size_t h = consumer.head.load(std::memory_order_relaxed);
+            RingRange<T> r = readable(n);
+            for (std::size_t i = 0; i < r.size(); ++i, ++out) *out = std::move(data[(h + i) & mask]);
+            consume(r.size());
+            return r.size();
+        }
+
+        // Consumer: the first elements, at most n, without copying them. They stay in the queue
+        // until consume.
+        [[nodiscard]]
+        RingRange<T> readable(std::size_t n = ~std::size_t{0})
+        {
+            std::size_t h = consumer.head.load(std::memory_order_relaxed);
+            if (consumer.tail - h < n)
+            {
+                consumer.tail = producer.tail.load(std::memory_order_acquire);
+            }
+            std::size_t k = std::min(n, consumer.tail - h);
+            return {RingIterator<T>(data, mask, h), RingIterator<T>(data, mask, h + k), k};
+        }
+
+        // Consumer: removes the first k elements.
+        // Precondition: k <= readable().size()
+        void consume(std::size_t k) noexcept
+        {
+            consumer.head.store(consumer.head.load(std::memory_order_relaxed) + k, std::memory_order_release);
+        }
+
+    private:
+        struct alignas(64) producer_side
+        {
+            std::atomic<std::size_t> tail{0};
+            std::size_t head = 0; // copy of consumer.head
+        };
+
+        struct alignas(64) consumer_side
+        {
+            std::atomic<std::size_t> head{0};
+            std::size_t tail = 0; // copy of producer.tail
+        };
+
+        producer_side producer;
+        consumer_side consumer;
+        alignas(64) std::size_t mask;
+        T* data = nullptr;
+        Vector<T> slots;
+    };
+
+
+
+    template <typename T>
+        requires default_constructible<T> && movable<T>
+    class MpmcRingBuffer
+    {
+    public:
+        // capacity is rounded up to a power of 2, at least 2.
+        explicit MpmcRingBuffer(std::size_t capacity)
+            : mask(std::bit_ceil(std::max(capacity, std::size_t{2})) - 1), cells(std::make_unique<cell[]>(mask + 1))
+        {
+            for (std::size_t i = 0; i <= mask; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+        MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+
+        [[nodiscard]]
+        std::size_t capacity() const noexcept
+        {
+            return mask + 1;
+        }
+
+        // Appends x, returns false if the queue is full.
+        bool push(const T& x)
+        {
+            return push_n(&x, 1) == 1;
+        }
+
+        // Appends the first k of the n elements of [f, f + n) with consecutive positions, k as
+        // large as the free slots allow; returns k, 0 if the queue is full.
+        template <typename I>
+        std::size_t push_n(I f, std::size_t n)
+        {
+            std::size_t p = tail.load(std::memory_order_relaxed);
+            std::size_t k = claim(tail, p, n, 0);
+            for (std::size_t i = 0; i < k; ++i, ++f)
+            {
+                cell& c = cells[(p + i) & mask];
+                c.value = *f;
+                c.sequence.store(p + i + 1, std::memory_order_release);
+            }
+            return k;
+        }
+
+
+        // Moves the first element to x, returns false if the queue is empty.
+        bool pop(T& x)
+        {
+            return pop_n(&x, 1) == 1;
+        }
+
+        // Moves up to n first elements to [out, out + k), returns k, 0 if the queue is empty.
+        template <typename O>
+        std::size_t pop_n(O out, std::size_t n)
+        {
+            std::size_t p = head.load(std::memory_order_relaxed);
+            std::size_t k = claim(head, p, n, 1);
+            for (std::size_t i = 0; i < k; ++i, ++out)
+            {
+                cell& c = cells[(p + i) & mask];
+                *out = std::move(c.value);
+                c.sequence.store(p + i + mask + 1, std::memory_order_release);
+            }
+            return k;
+        }
+
+    private:
+        struct cell
+        {
+            std::atomic<std::size_t> sequence{0};
+            T value{};
+        };
+
+        // Claims up to n consecutive positions from p on, ready when the sequence of the slot of
+        // position q is q + ready: returns their number and the first one in p.
+        std::size_t claim(std::atomic<std::size_t>& counter, std::size_t& p, std::size_t n, std::size_t ready)
+        {
+            while (true)
+            {
+                std::size_t k = 0;
+                while (k < n && k <= mask && cells[(p + k) & mask].sequence.load(std::memory_order_acquire) == p + k + ready) ++k;
+                if (k == 0)
+                {
+                    std::size_t s = cells[p & mask].sequence.load(std::memory_order_acquire);
+                    // Behind p: full (producers) or empty (consumers). Else p is stale.
+                    if (static_cast<std::ptrdiff_t>(s - (p + ready)) < 0) return 0;
+                    p = counter.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (counter.compare_exchange_weak(p, p + k, std::memory_order_relaxed)) return k;
+            }
+        }
+
+
+        alignas(64) std::atomic<std::size_t> tail{0};
+        alignas(64) std::atomic<std::size_t> head{0};
+        alignas(64) std::size_t mask;
+        std::unique_ptr<cell[]> cells;
+    };
+} // namespace eop
+
+
+#endif
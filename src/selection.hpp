@@ -0,0 +1,500 @@
+#ifndef SELECTION_HPP
+#define SELECTION_HPP
+
+/*
+selection.hpp
+
+PURPOSE: stable selection on ranges.
+
+FUNCTIONS:
+    introselect:        unstable nth element, introselect with median of medians fallback.
+    introsort:          unstable sort, quicksort with heap sort fallback.
+    rank_sort:          stable sort of a small range by counting the ranks.
+    select_nth:         stable nth element.
+    partial_sort:       stable partial sort.
+
+CLASSES:
+    TopK:               the k first elements (stable order) of a stream.
+
+DESCRIPTION:
+Like Ordering::select_i_j the selection is stable: the element of rank k is the element that would
+be at position k after a stable sort, so among equivalent elements the first in the range comes
+first. After select_nth(f, l, k, r) the range is permuted such that f + k is the element of rank k,
+the elements of rank < k are in [f, f + k) and the others in [f + k + 1, l).
+
+introselect is quickselect on a 3 way partition (< pivot, equivalent to pivot, > pivot) with
+the pivot median of 3. After 2 log2(n) partitions the pivot is the median of the medians of the
+groups of 5 (Ordering::median_5), that gives linear time in the worst case.
+
+Stability: introselect moves the elements, so the initial positions are lost. If the equivalence
+of r is the equality (less<T> or greater<T> on an integral type) the equivalent elements are
+indistinguishable and introselect is directly stable. Otherwise the selection is done on the
+iterators of the range with the relation "r, then position", that is a total ordering, and
+the range is permuted at the end. This needs a buffer of n iterators and n values.
+
+Precondition: I is a random access iterator to lvalues (for example a pointer).
+
+*/
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "linear_ordering.hpp"
+#include "ordering_concepts.hpp"
+#include "pair.hpp"
+#include "relations.hpp"
+#include "vector.hpp"
+
+namespace eop
+{
+    // The equivalence of R is the equality of its domain. Not for the floating point types:
+    // -0.0 and 0.0 are equivalent but different values.
+    template <typename R>
+    constexpr bool equivalence_is_equality = false;
+
+    template <typename T>
+        requires std::integral<T>
+    constexpr bool equivalence_is_equality<less<T>> = true;
+
+    template <typename T>
+        requires std::integral<T>
+    constexpr bool equivalence_is_equality<greater<T>> = true;
+
+
+    struct Selection
+    {
+        static constexpr std::ptrdiff_t insertion_threshold = 16;
+        static constexpr std::ptrdiff_t rank_sort_threshold = 32;
+
+
+        //******************************** HELPERS ************************************
+
+        // Precondition: readable_bounded_range(f, l)
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        void insertion_sort(I f, I l, R r)
+        {
+            if (f == l) return;
+            for (I i = f + 1; i != l; ++i)
+            {
+                auto x = std::move(*i);
+                I j = i;
+                while (j != f && r(x, *(j - 1)))
+                {
+                    *j = std::move(*(j - 1));
+                    --j;
+                }
+                *j = std::move(x);
+            }
+        }
+
+
+        // Max heap in [f, f + n) under r. Sift the element at i down.
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        void sift_down(I f, std::ptrdiff_t n, std::ptrdiff_t i, R r)
+        {
+            auto x = std::move(f[i]);
+            while (true)
+            {
+                std::ptrdiff_t child = 2 * i + 1;
+                if (child >= n) break;
+                if (child + 1 < n && r(f[child], f[child + 1])) ++child;
+                if (!r(x, f[child])) break;
+                f[i] = std::move(f[child]);
+                i = child;
+            }
+            f[i] = std::move(x);
+        }
+
+
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        void heap_sort(I f, I l, R r)
+        {
+            std::ptrdiff_t n = l - f;
+            for (std::ptrdiff_t i = n / 2; i-- > 0; ) sift_down(f, n, i, r);
+            while (n > 1)
+            {
+                --n;
+                std::swap(f[0], f[n]);
+                sift_down(f, n, std::ptrdiff_t{0}, r);
+            }
+        }
+
+
+        // Iterator in {i0, ..., i4} of the median of their 5 values.
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        I median_5(I i0, I i1, I i2, I i3, I i4, R r)
+        {
+            const auto& m = Ordering::median_5(*i0, *i1, *i2, *i3, *i4, r);
+            if (&m == &*i0) return i0;
+            if (&m == &*i1) return i1;
+            if (&m == &*i2) return i2;
+            if (&m == &*i3) return i3;
+            return i4;
+        }
+
+
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        I median_3(I i0, I i1, I i2, R r)
+        {
+            const auto& m = Ordering::select_1_3(*i0, *i1, *i2, r);
+            if (&m == &*i0) return i0;
+            if (&m == &*i1) return i1;
+            return i2;
+        }
+
+
+        // Return {m0, m1} such that [f, m0) < pivot, [m0, m1) equivalent to pivot, [m1, l) > pivot.
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        Pair<I, I> partition_3_way(I f, I l, I pivot, R r)
+        {
+            auto p = *pivot;
+            I i = f;
+            while (i != l)
+            {
+                if (r(*i, p))
+                {
+                    std::swap(*f, *i);
+                    ++f;
+                    ++i;
+                }
+                else if (r(p, *i))
+                {
+                    --l;
+                    std::swap(*i, *l);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+            return {f, l};
+        }
+
+
+        // The medians of the groups of 5 are moved to the beginning, the pivot is their median.
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        I median_of_medians(I f, I l, R r)
+        {
+            std::ptrdiff_t groups = (l - f) / 5;
+            for (std::ptrdiff_t i = 0; i < groups; ++i)
+            {
+                I g = f + 5 * i;
+                std::swap(f[i], *median_5(g, g + 1, g + 2, g + 3, g + 4, r));
+            }
+            I nth = f + groups / 2;
+            introselect(f, f + groups, groups / 2, r, 0);
+            return nth;
+        }
+
+        //******************************** HELPERS ************************************
+
+
+        // Unstable: among equivalent elements any can be selected.
+        // Precondition: readable_bounded_range(f, l) && 0 <= k < l - f
+        // Postcondition: !r(*(f + k), x) for x in [f, f + k) and !r(x, *(f + k)) for x in [f + k + 1, l)
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        void introselect(I f, I l, std::ptrdiff_t k, R r, int depth)
+        {
+            I nth = f + k;
+            while (l - f > insertion_threshold)
+            {
+                I pivot;
+                if (depth > 0)
+                {
+                    --depth;
+                    pivot = median_3(f, f + (l - f) / 2, l - 1, r);
+                }
+                else
+                {
+                    pivot = median_of_medians(f, l, r);
+                }
+                Pair<I, I> m = partition_3_way(f, l, pivot, r);
+                if (nth < m.first) l = m.first;
+                else if (nth < m.second) return;
+                else f = m.second;
+            }
+            insertion_sort(f, l, r);
+        }
+
+
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        void introselect(I f, I l, std::ptrdiff_t k, R r)
+        {
+            introselect(f, l, k, r, 2 * std::bit_width(static_cast<std::size_t>(l - f)));
+        }
+
+
+        // Unstable. The recursion is on the smaller side of the partition, the loop on the other,
+        // so the stack is O(log(n)); after depth partitions the rest is heap sorted.
+        // Precondition: readable_bounded_range(f, l)
+        // Postcondition: increasing_range(f, l, r)
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        void introsort(I f, I l, R r, int depth)
+        {
+            while (l - f > insertion_threshold)
+            {
+                if (depth == 0)
+                {
+                    heap_sort(f, l, r);
+                    return;
+                }
+                --depth;
+                Pair<I, I> m = partition_3_way(f, l, median_3(f, f + (l - f) / 2, l - 1, r), r);
+                if (m.first - f < l - m.second)
+                {
+                    introsort(f, m.first, r, depth);
+                    f = m.second;
+                }
+                else
+                {
+                    introsort(m.second, l, r, depth);
+                    l = m.first;
+                }
+            }
+            insertion_sort(f, l, r);
+        }
+
+
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static constexpr
+        void introsort(I f, I l, R r)
+        {
+            introsort(f, l, r, 2 * std::bit_width(static_cast<std::size_t>(l - f)));
+        }
+
+
+        // The rank of f[i] is the number of elements before it that are not greater plus the number
+        // of elements after it that are smaller. n^2 comparisons, but the result of a comparison
+        // is added, not branched on: on random data insertion_sort mispredicts the end of each
+        // insertion, rank_sort is faster up to about rank_sort_threshold elements.
+        // Precondition: readable_bounded_range(f, l) && writable_weak_range(o, l - f)
+        // Precondition: [o, o + (l - f)) and [f, l) don't overlap
+        // Postcondition: [o, o + (l - f)) is the stable sort of [f, l)
+        template <std::random_access_iterator I, std::random_access_iterator O, weak_ordering_relation R>
+        static constexpr
+        void rank_sort(I f, I l, O o, R r)
+        {
+            std::ptrdiff_t n = l - f;
+            for (std::ptrdiff_t i = 0; i < n; ++i)
+            {
+                std::ptrdiff_t rank = 0;
+                for (std::ptrdiff_t j = 0; j < i; ++j) rank += !r(f[i], f[j]);
+                for (std::ptrdiff_t j = i + 1; j < n; ++j) rank += r(f[j], f[i]);
+                o[rank] = f[i];
+            }
+        }
+
+
+        // Apply the positions: the element at position i becomes *p[i].
+        template <std::random_access_iterator I>
+        static
+        void permute(I f, const Vector<I>& p)
+        {
+            using T = std::iter_value_t<I>;
+            Vector<T> buffer;
+            buffer.reserve(p.size());
+            for (std::size_t i = 0; i < p.size(); ++i) buffer.emplace_back(std::move(*p[i]));
+            for (std::size_t i = 0; i < p.size(); ++i) f[i] = std::move(buffer[i]);
+        }
+
+
+        template <std::random_access_iterator I>
+        static
+        Vector<I> positions(I f, I l)
+        {
+            Vector<I> p;
+            p.reserve(static_cast<std::size_t>(l - f));
+            for (I i = f; i != l; ++i) p.emplace_back(i);
+            return p;
+        }
+
+
+        // Total ordering on the iterators: r on the values, then the position.
+        template <typename I, weak_ordering_relation R>
+        struct stable_relation
+        {
+            R r;
+
+            constexpr
+            bool operator()(const I& i, const I& j) const
+            {
+                if (r(*i, *j)) return true;
+                if (r(*j, *i)) return false;
+                return i < j;
+            }
+        };
+
+
+        // Precondition: readable_bounded_range(f, l) && 0 <= k < l - f
+        // Postcondition: f + k is the element of rank k of the stable sort, [f, f + k) are the
+        // elements of smaller rank and [f + k + 1, l) the elements of larger rank.
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static
+        I select_nth(I f, I l, std::ptrdiff_t k, R r)
+        {
+            if constexpr (equivalence_is_equality<R>)
+            {
+                introselect(f, l, k, r);
+            }
+            else
+            {
+                Vector<I> p = positions(f, l);
+                stable_relation<I, R> s{r};
+                introselect(p.raw_data(), p.raw_data() + p.size(), k, s);
+                permute(f, p);
+            }
+            return f + k;
+        }
+
+
+        // Precondition: readable_bounded_range(f, l) && f <= m <= l
+        // Postcondition: [f, m) are the m - f first elements of the stable sort, in that order.
+        template <std::random_access_iterator I, weak_ordering_relation R>
+        static
+        void partial_sort(I f, I m, I l, R r)
+        {
+            if (f == m) return;
+            if constexpr (equivalence_is_equality<R>)
+            {
+                if (m != l) introselect(f, l, (m - f) - 1, r);
+                heap_sort(f, m, r);
+            }
+            else
+            {
+                Vector<I> p = positions(f, l);
+                stable_relation<I, R> s{r};
+                I* pf = p.raw_data();
+                if (m != l) introselect(pf, pf + p.size(), (m - f) - 1, s);
+                heap_sort(pf, pf + (m - f), s);
+                permute(f, p);
+            }
+        }
+    };
+
+
+
+    // The k first elements of a stream in the stable order under r: the k smallest for less,
+    // the k largest for greater. Equivalent elements are ordered by arrival.
+    // The elements are kept in a max heap of k elements (the root is the k-th), so each push
+    // is a comparison with the root and, if the new element enters, O(log(k)).
+    template <typename T, weak_ordering_relation R>
+        requires regular<T> && std::same_as<domain_t<R>, T>
+    class TopK
+    {
+    public:
+        using entry = Pair<T, std::uint64_t>;
+
+        explicit TopK(std::size_t k, R r = R{}) : capacity(k), relation(r)
+        {
+            heap.reserve(k);
+        }
+
+
+        void push(const T& x)
+        {
+            entry e{x, count};
+            ++count;
+            if (capacity == 0) return;
+            entry_relation s{relation};
+            if (heap.size() < capacity)
+            {
+                heap.emplace_back(e);
+                sift_up(heap.size() - 1);
+            }
+            else if (s(e, heap[0]))
+            {
+                heap[0] = e;
+                Selection::sift_down(heap.raw_data(), static_cast<std::ptrdiff_t>(heap.size()), std::ptrdiff_t{0}, s);
+            }
+        }
+
+
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return heap.size();
+        }
+
+
+        // Number of elements pushed.
+        [[nodiscard]]
+        std::uint64_t pushed() const noexcept
+        {
+            return count;
+        }
+
+
+        // The last of the k first elements (the k-th percentile boundary).
+        // Precondition: size() > 0
+        [[nodiscard]]
+        const T& back() const
+        {
+            return heap[0].first;
+        }
+
+
+        // The kept elements in the stable order.
+        [[nodiscard]]
+        Vector<T> sorted() const
+        {
+            Vector<entry> h = heap;
+            Selection::heap_sort(h.raw_data(), h.raw_data() + h.size(), entry_relation{relation});
+            Vector<T> result;
+            result.reserve(h.size());
+            for (std::size_t i = 0; i < h.size(); ++i) result.emplace_back(h[i].first);
+            return result;
+        }
+
+
+    private:
+        // r, then the arrival: a total ordering.
+        struct entry_relation
+        {
+            R r;
+
+            bool operator()(const entry& a, const entry& b) const
+            {
+                if (r(a.first, b.first)) return true;
+                if (r(b.first, a.first)) return false;
+                return a.second < b.second;
+            }
+        };
+
+        void sift_up(std::size_t i)
+        {
+            entry_relation s{relation};
+            entry x = heap[i];
+            while (i > 0)
+            {
+                std::size_t parent = (i - 1) / 2;
+                if (!s(heap[parent], x)) break;
+                heap[i] = heap[parent];
+                i = parent;
+            }
+            heap[i] = x;
+        }
+
+        Vector<entry> heap;
+        std::size_t capacity;
+        std::uint64_t count = 0;
+        R relation;
+    };
+} // namespace eop
+
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+// Helpers of the tests and benchmarks.
+
+#include <chrono>
+
+
+// Milliseconds of a call of fun().
+template <typename Fun>
+double time_ms(Fun fun)
+{
+    auto start = std::chrono::steady_clock::now();
+    fun();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+
+#endif
@@ -0,0 +1,125 @@
+// Benchmark the iterative traversals of bifurcate_coordinates.hpp (traverse_step with the
+// predecessor links, constant space) against the recursive ones on a balanced tree and on
+// degenerate trees (a path alternating left and right successors).
+// The recursive versions need a stack frame per level: they are run on a degenerate tree of
+// 10^4 levels, the iterative ones also on 10^6 levels.
+
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "../bifurcate_coordinates.hpp"
+#include "bench.hpp"
+
+
+struct node
+{
+    node* left = nullptr;
+    node* right = nullptr;
+    node* parent = nullptr;
+};
+
+
+struct coordinate
+{
+    using weight_type = std::size_t;
+
+    node* p = nullptr;
+
+    bool empty() const { return p == nullptr; }
+    bool has_left_successor() const { return p->left != nullptr; }
+    bool has_right_successor() const { return p->right != nullptr; }
+    bool has_predecessor() const { return p->parent != nullptr; }
+    coordinate left_successor() const { return {p->left}; }
+    coordinate right_successor() const { return {p->right}; }
+    coordinate predecessor() const { return {p->parent}; }
+
+    friend
+    bool operator==(const coordinate&, const coordinate&) = default;
+};
+
+
+// Counts the visits and the sum of the heights of the pre visits.
+struct counter
+{
+    std::size_t visits = 0;
+    std::size_t pre = 0;
+
+    int operator()(eop::visit v, coordinate)
+    {
+        ++visits;
+        pre += v == eop::visit::pre;
+        return 0;
+    }
+};
+
+
+// Complete tree of n nodes in heap order, the root is nodes[0].
+std::vector<node> balanced(std::size_t n)
+{
+    std::vector<node> nodes(n);
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        node& parent = nodes[(i - 1) / 2];
+        (i % 2 == 1 ? parent.left : parent.right) = &nodes[i];
+        nodes[i].parent = &parent;
+    }
+    return nodes;
+}
+
+
+std::vector<node> degenerate(std::size_t n)
+{
+    std::vector<node> nodes(n);
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        (i % 2 == 1 ? nodes[i - 1].left : nodes[i - 1].right) = &nodes[i];
+        nodes[i].parent = &nodes[i - 1];
+    }
+    return nodes;
+}
+
+
+bool bench(const std::string& name, std::vector<node>& nodes, std::size_t expected_height, bool recursive)
+{
+    using namespace eop;
+
+    coordinate root{nodes.data()};
+    std::size_t n = nodes.size();
+    std::size_t w = 0;
+    std::size_t h = 0;
+    counter c;
+    std::cout << name << ", " << n << " nodes, height " << expected_height << std::endl;
+
+    bool ok = true;
+    std::cout << "    weight: " << time_ms([&]() { w = weight(root); }) << " ms" << std::endl;
+    std::cout << "    height: " << time_ms([&]() { h = height(root); }) << " ms" << std::endl;
+    std::cout << "    traverse: " << time_ms([&]() { c = traverse(root, counter{}); }) << " ms" << std::endl;
+    ok = ok && w == n && h == expected_height && c.visits == 3 * n && c.pre == n;
+    ok = ok && reachable(root, coordinate{&nodes[n - 1]}) && !reachable(coordinate{&nodes[n - 1]}, root);
+
+    if (recursive)
+    {
+        std::cout << "    weight_recursive: " << time_ms([&]() { w = weight_recursive(root); }) << " ms" << std::endl;
+        std::cout << "    height_recursive: " << time_ms([&]() { h = height_recursive(root); }) << " ms" << std::endl;
+        std::cout << "    traverse_nonempty: " << time_ms([&]() { c = traverse_nonempty(root, counter{}); }) << " ms" << std::endl;
+        ok = ok && w == n && h == expected_height && c.visits == 3 * n && c.pre == n;
+    }
+    return ok;
+}
+
+
+int main()
+{
+    std::vector<node> b = balanced((std::size_t{1} << 20) - 1);
+    std::vector<node> d_small = degenerate(10'000);
+    std::vector<node> d_large = degenerate(1'000'000);
+
+    bool ok = true;
+    ok = bench("balanced", b, 20, true) && ok;
+    ok = bench("degenerate", d_small, 10'000, true) && ok;
+    ok = bench("degenerate", d_large, 1'000'000, false) && ok;
+    std::cout << (ok ? "bifurcate traversal: ok" : "bifurcate traversal: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
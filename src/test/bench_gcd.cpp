@@ -0,0 +1,133 @@
+// Benchmark the GCD variants on uniformly random 32 and 64 bits inputs, and Lehmer GCD on
+// multi-limb BigInteger against the Euclidean algorithm with the BigInteger remainder.
+
+
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../big_integer_gcd.hpp"
+#include "../division.hpp"
+#include "bench.hpp"
+
+
+template <typename I>
+I euclidean_gcd(I a, I b)
+{
+    while (b != I{0})
+    {
+        I r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+
+// Every variant must agree with std::gcd, the sum of the results is the check.
+template <typename I, typename Gcd>
+bool run(const std::string& name, const std::vector<I>& a, const std::vector<I>& b, Gcd gcd, std::uint64_t expected)
+{
+    std::uint64_t check = 0;
+    double t = time_ms([&]()
+    {
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            check += static_cast<std::uint64_t>(gcd(a[i], b[i]));
+        }
+    });
+    std::cout << "    " << name << ": " << t << " ms" << std::endl;
+    return check == expected;
+}
+
+
+template <typename I>
+bool bench_builtin(const std::string& type, std::size_t n, std::mt19937_64& g)
+{
+    using namespace eop;
+
+    // Nonzero inputs, the subtractive variants require a > 0 && b > 0.
+    std::vector<I> a(n);
+    std::vector<I> b(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = static_cast<I>(g()) | I{1} << (sizeof(I) * 8 - 2);
+        b[i] = static_cast<I>(g()) | I{1};
+    }
+
+    std::uint64_t expected = 0;
+    for (std::size_t i = 0; i < n; ++i) expected += std::gcd(a[i], b[i]);
+
+    std::cout << type << ", " << n << " pairs" << std::endl;
+    bool ok = true;
+    ok = run("std::gcd", a, b, [](I x, I y) { return std::gcd(x, y); }, expected) && ok;
+    ok = run("euclidean (%)", a, b, [](I x, I y) { return euclidean_gcd(x, y); }, expected) && ok;
+    ok = run("subtractive_gcd_nonzero", a, b, [](I x, I y) { return GCD::subtractive_gcd_nonzero(x, y); }, expected) && ok;
+    ok = run("subtractive_gcd", a, b, [](I x, I y) { return GCD::subtractive_gcd(x, y); }, expected) && ok;
+    ok = run("fast_subtractive_gcd", a, b, [](I x, I y) { return GCD::fast_subtractive_gcd(x, y); }, expected) && ok;
+    ok = run("stein_gcd", a, b, [](I x, I y) { return GCD::stein_gcd(x, y); }, expected) && ok;
+
+    // extended_gcd needs a signed type, the inputs are reduced to stay nonnegative.
+    using S = std::make_signed_t<I>;
+    std::vector<S> sa(n);
+    std::vector<S> sb(n);
+    std::uint64_t expected_signed = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        sa[i] = static_cast<S>(a[i] >> 1);
+        sb[i] = static_cast<S>(b[i] >> 1);
+        expected_signed += static_cast<std::uint64_t>(std::gcd(sa[i], sb[i]));
+    }
+    ok = run("stein_gcd (signed)", sa, sb, [](S x, S y) { return GCD::stein_gcd(x, y); }, expected_signed) && ok;
+    ok = run("extended_gcd (signed)", sa, sb, [](S x, S y) { return GCD::extended_gcd(x, y).first; }, expected_signed) && ok;
+    return ok;
+}
+
+
+bool bench_big(std::size_t limbs, std::size_t n, std::mt19937_64& g)
+{
+    using namespace eop;
+
+    std::vector<BigInteger> a(n);
+    std::vector<BigInteger> b(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        for (std::size_t j = 0; j < limbs; ++j)
+        {
+            a[i] = (a[i] << 64) + BigInteger{g()};
+            b[i] = (b[i] << 64) + BigInteger{g()};
+        }
+    }
+
+    std::vector<BigInteger> r_euclid(n);
+    std::vector<BigInteger> r_lehmer(n);
+    std::cout << "BigInteger " << 64 * limbs << " bits, " << n << " pairs" << std::endl;
+    double t_euclid = time_ms([&]()
+    {
+        for (std::size_t i = 0; i < n; ++i) r_euclid[i] = euclidean_gcd(a[i], b[i]);
+    });
+    double t_lehmer = time_ms([&]()
+    {
+        for (std::size_t i = 0; i < n; ++i) r_lehmer[i] = BigIntegerGCD::lehmer_gcd(a[i], b[i]);
+    });
+    std::cout << "    euclidean (%): " << t_euclid << " ms" << std::endl;
+    std::cout << "    lehmer_gcd: " << t_lehmer << " ms" << std::endl;
+    return r_euclid == r_lehmer;
+}
+
+
+int main()
+{
+    std::mt19937_64 g(42);
+
+    bool ok = true;
+    ok = bench_builtin<std::uint32_t>("uint32", 1 << 20, g) && ok;
+    ok = bench_builtin<std::uint64_t>("uint64", 1 << 20, g) && ok;
+    ok = bench_big(4, 1 << 12, g) && ok;
+    ok = bench_big(32, 1 << 8, g) && ok;
+
+    return ok ? 0 : 1;
+}
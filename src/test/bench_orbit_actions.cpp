@@ -0,0 +1,82 @@
+// Benchmark OrbitAct against OrbitTrf on a 4KB state.
+// The orbit is driven by the first word, but every comparison and copy touches the whole state.
+
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+#include "../orbit_transformations.hpp"
+#include "../orbit_actions.hpp"
+#include "bench.hpp"
+
+
+struct State
+{
+    std::array<std::uint64_t, 512> words{};
+
+    friend
+    bool operator==(const State&, const State&) = default;
+};
+
+
+constexpr std::uint64_t M = 1'000'003;
+
+constexpr
+std::uint64_t step(std::uint64_t x)
+{
+    return (x * x + 7) % M;
+}
+
+
+State make_state(std::uint64_t seed)
+{
+    State s;
+    s.words[0] = seed % M;
+    for (std::size_t i = 1; i < s.words.size(); ++i)
+    {
+        s.words[i] = i * 0x9e3779b97f4a7c15ull;
+    }
+    return s;
+}
+
+
+int main()
+{
+    using namespace eop;
+
+    auto trf = [](State s) -> State { s.words[0] = step(s.words[0]); return s; };
+    auto act = [](State& s) -> void { s.words[0] = step(s.words[0]); };
+
+    constexpr int runs = 16;
+
+    std::uint64_t check_trf = 0;
+    double t_trf = time_ms([&]()
+    {
+        for (int i = 0; i < runs; ++i)
+        {
+            auto r = OrbitTrf::orbit_structure_nonterminating_orbit(make_state(i), trf);
+            check_trf += r.first + r.second;
+        }
+    });
+
+    std::uint64_t check_act = 0;
+    State y;
+    State slow;
+    double t_act = time_ms([&]()
+    {
+        for (int i = 0; i < runs; ++i)
+        {
+            State x = make_state(i);
+            auto r = OrbitAct::orbit_structure_nonterminating_orbit(x, act, y, slow);
+            check_act += r.first + r.second;
+        }
+    });
+
+    std::cout << "orbit_structure_nonterminating_orbit on " << sizeof(State) << " bytes state, "
+              << runs << " runs" << std::endl;
+    std::cout << "OrbitTrf: " << t_trf << " ms" << std::endl;
+    std::cout << "OrbitAct: " << t_act << " ms" << std::endl;
+
+    return check_trf == check_act ? 0 : 1;
+}
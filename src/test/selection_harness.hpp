@@ -0,0 +1,119 @@
+#ifndef SELECTION_HARNESS_HPP
+#define SELECTION_HARNESS_HPP
+
+#include <array>
+
+#include "../linear_ordering.hpp"
+
+
+// Exhaustive verification.
+// The inputs are all the assignments of keys in [0, n) to the n positions: n^n inputs that
+// contain every permutation and every pattern of ties. For each input the selected element is
+// compared with the element of rank k of the stable sort (by key, then by position): the same key
+// is the order, the same position is the stability. The relation counts its calls, the maximum
+// over all the inputs is the worst case number of comparisons of the network.
+
+
+struct element
+{
+    int key;
+    int index;
+
+    friend
+    bool operator==(const element&, const element&) = default;
+};
+
+
+struct verification
+{
+    bool order;
+    bool stable;
+    int max_comparisons;
+};
+
+
+template <int N>
+constexpr std::array<element, N> make_input(int code)
+{
+    std::array<element, N> a{};
+    for (int i = 0; i < N; ++i)
+    {
+        a[i] = element{code % N, i};
+        code = code / N;
+    }
+    return a;
+}
+
+
+// Element of rank k of the stable insertion sort, by increasing key or by decreasing key if reverse.
+template <int N>
+constexpr element stable_rank(std::array<element, N> a, int k, bool reverse)
+{
+    for (int i = 1; i < N; ++i)
+    {
+        element x = a[i];
+        int j = i;
+        while (j > 0 && (reverse ? a[j - 1].key < x.key : x.key < a[j - 1].key))
+        {
+            a[j] = a[j - 1];
+            --j;
+        }
+        a[j] = x;
+    }
+    return a[k];
+}
+
+
+template <int N, int K, typename Select>
+constexpr verification verify(Select select, bool reverse)
+{
+    int inputs = 1;
+    for (int i = 0; i < N; ++i) inputs = inputs * N;
+
+    verification v{true, true, 0};
+    for (int code = 0; code < inputs; ++code)
+    {
+        const std::array<element, N> a = make_input<N>(code);
+        int comparisons = 0;
+        auto r = [&comparisons, reverse](const element& x, const element& y) -> bool
+        {
+            ++comparisons;
+            return reverse ? y.key < x.key : x.key < y.key;
+        };
+
+        const element& result = select(a, r);
+        element expected = stable_rank<N>(a, K, reverse);
+        v.order = v.order && result.key == expected.key;
+        v.stable = v.stable && result.index == expected.index;
+        if (v.max_comparisons < comparisons) v.max_comparisons = comparisons;
+    }
+    return v;
+}
+
+
+template <int N, int K, typename Select>
+constexpr verification verify_both(Select select)
+{
+    verification x = verify<N, K>(select, false);
+    verification y = verify<N, K>(select, true);
+    return verification{x.order && y.order, x.stable && y.stable,
+                        x.max_comparisons < y.max_comparisons ? y.max_comparisons : x.max_comparisons};
+}
+
+
+// The selections of Ordering on the array of the elements of an input.
+
+constexpr auto select_0_2 = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_0_2(a[0], a[1], r); };
+constexpr auto select_1_2 = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_1_2(a[0], a[1], r); };
+constexpr auto select_0_2_indexed = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_0_2<0, 1>(a[0], a[1], r); };
+constexpr auto select_1_2_indexed = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_1_2<0, 1>(a[0], a[1], r); };
+constexpr auto select_0_3 = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_0_3(a[0], a[1], a[2], r); };
+constexpr auto select_1_3 = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_1_3(a[0], a[1], a[2], r); };
+constexpr auto select_2_3 = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_2_3(a[0], a[1], a[2], r); };
+constexpr auto select_1_4 = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_1_4(a[0], a[1], a[2], a[3], r); };
+constexpr auto select_2_4 = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_2_4(a[0], a[1], a[2], a[3], r); };
+constexpr auto select_1_4_indexed = [](const auto& a, auto r) -> const element& { return eop::Ordering::select_1_4<0, 1, 2, 3>(a[0], a[1], a[2], a[3], r); };
+constexpr auto median_5 = [](const auto& a, auto r) -> const element& { return eop::Ordering::median_5(a[0], a[1], a[2], a[3], a[4], r); };
+
+
+#endif
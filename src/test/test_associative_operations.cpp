@@ -0,0 +1,145 @@
+// Check the addition chains (each element is the sum of 2 previous ones, the last one is n, the
+// optimal lengths of the first n) and power<N>, power_chain, power_sliding_window and power_many
+// against power for every n < 128 and for random large n, with the product of 2x2 matrices
+// modulo 2^64 (not commutative) and with the addition (the power is n a, exactly).
+
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <utility>
+
+#include "../associative_operations.hpp"
+
+
+using matrix = std::array<std::uint64_t, 4>;
+
+
+constexpr
+matrix multiply(matrix x, matrix y)
+{
+    return {x[0] * y[0] + x[1] * y[2], x[0] * y[1] + x[1] * y[3],
+            x[2] * y[0] + x[3] * y[2], x[2] * y[1] + x[3] * y[3]};
+}
+
+constexpr auto matrix_op = [](matrix x, matrix y) -> matrix { return multiply(x, y); };
+constexpr auto plus_op = [](std::uint64_t x, std::uint64_t y) -> std::uint64_t { return x + y; };
+
+
+// The lengths of the shortest addition chains of 1, ..., 32 (OEIS A003313).
+constexpr std::array<std::size_t, 33> shortest{0, 0, 1, 2, 2, 3, 3, 4, 3, 4, 4, 5, 4, 5, 5, 5, 4,
+                                              5, 5, 6, 5, 6, 6, 6, 5, 6, 6, 6, 6, 7, 6, 7, 5};
+
+
+constexpr
+bool valid(const eop::AdditionChain& c, std::uint64_t n)
+{
+    if (c.e[0] != 1 || c.back() != n || c.registers > eop::AdditionChain::max_length) return false;
+    for (std::size_t k = 1; k < c.length; ++k)
+    {
+        if (c.lhs[k] >= k || c.rhs[k] >= k || c.e[k] != c.e[c.lhs[k]] + c.e[c.rhs[k]]) return false;
+        if (c.slot[k] >= c.registers) return false;
+    }
+    return true;
+}
+
+
+static_assert(valid(eop::AdditionChain::make(127), 127) && eop::AdditionChain::make(127).operations() == 10);
+
+
+bool test_chains(std::mt19937_64& g)
+{
+    for (std::uint64_t n = 1; n < 128; ++n)
+    {
+        eop::AdditionChain c = eop::AdditionChain::make(n);
+        // Never longer than the binary method.
+        std::size_t binary = std::bit_width(n) - 1 + std::popcount(n) - 1;
+        if (!valid(c, n) || c.operations() > binary) return false;
+        if (n < shortest.size() && c.operations() != shortest[n]) return false;
+    }
+    for (int step = 0; step < 2000; ++step)
+    {
+        std::uint64_t n = g() >> (g() % 57);
+        if (n == 0) n = 1;
+        eop::AdditionChain c = eop::AdditionChain::make(n);
+        if (!valid(c, n)) return false;
+        for (int k = 1; k <= 6; ++k)
+        {
+            if (!valid(eop::AdditionChain::sliding_window(n, k), n)) return false;
+        }
+    }
+    return true;
+}
+
+
+matrix random_matrix(std::mt19937_64& g)
+{
+    return {g(), g(), g(), g()};
+}
+
+
+bool check(std::uint64_t n, std::mt19937_64& g)
+{
+    using eop::AssociativeOp;
+    matrix a = random_matrix(g);
+    matrix p = AssociativeOp::power(a, n, matrix_op);
+    eop::AdditionChain c = eop::AdditionChain::make(n);
+    if (AssociativeOp::power_chain(a, c, matrix_op) != p) return false;
+    if (AssociativeOp::power_sliding_window(a, n, matrix_op) != p) return false;
+    if (AssociativeOp::power_sliding_window<1>(a, n, matrix_op) != p ||
+        AssociativeOp::power_sliding_window<3>(a, n, matrix_op) != p ||
+        AssociativeOp::power_sliding_window<6>(a, n, matrix_op) != p) return false;
+    matrix b = random_matrix(g);
+    std::array<matrix, 3> many = AssociativeOp::power_many(std::array<matrix, 3>{a, b, a}, n, matrix_op);
+    if (many[0] != p || many[1] != AssociativeOp::power(b, n, matrix_op) || many[2] != p) return false;
+
+    std::uint64_t x = g();
+    return AssociativeOp::power(x, n, plus_op) == n * x && AssociativeOp::power_chain(x, c, plus_op) == n * x &&
+           AssociativeOp::power_sliding_window(x, n, plus_op) == n * x;
+}
+
+
+// power<N> for N = 1, ..., 127, and N = M, ..., for some larger M.
+template <std::uint64_t M, std::uint64_t ...N>
+bool check_compile_time(std::mt19937_64& g, std::integer_sequence<std::uint64_t, N...>)
+{
+    auto one = [&g]<std::uint64_t n>(std::integral_constant<std::uint64_t, n>)
+    {
+        matrix a = random_matrix(g);
+        std::uint64_t x = g();
+        return eop::AssociativeOp::power<n>(a, matrix_op) == eop::AssociativeOp::power(a, n, matrix_op) &&
+               eop::AssociativeOp::power<n>(x, plus_op) == n * x;
+    };
+    return (one(std::integral_constant<std::uint64_t, M + N>{}) && ...);
+}
+
+
+bool test_powers(std::mt19937_64& g)
+{
+    for (std::uint64_t n = 1; n < 128; ++n)
+    {
+        if (!check(n, g)) return false;
+    }
+    for (int step = 0; step < 2000; ++step)
+    {
+        std::uint64_t n = g() >> (g() % 64);
+        if (!check(n == 0 ? 1 : n, g)) return false;
+    }
+    if (!check(~std::uint64_t{0}, g) || !check(std::uint64_t{1} << 63, g)) return false;
+
+    return check_compile_time<1>(g, std::make_integer_sequence<std::uint64_t, 127>{}) &&
+           check_compile_time<1'000'000>(g, std::make_integer_sequence<std::uint64_t, 4>{}) &&
+           check_compile_time<(std::uint64_t{1} << 63) + 12'345>(g, std::make_integer_sequence<std::uint64_t, 2>{});
+}
+
+
+int main()
+{
+    std::mt19937_64 g(28);
+
+    bool ok = test_chains(g) && test_powers(g);
+    std::cout << (ok ? "associative operations: ok" : "associative operations: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
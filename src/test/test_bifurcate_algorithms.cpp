@@ -0,0 +1,163 @@
+// Check for_each, bifurcate_isomorphic, bifurcate_equivalent and bifurcate_compare against the
+// sequences of visits of traverse on random trees and on their modified copies, the fingerprints,
+// and time the comparison of equal and of different large trees with and without fingerprints.
+
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../bifurcate_algorithms.hpp"
+#include "../pooled_tree.hpp"
+#include "bench.hpp"
+
+
+using tree = eop::PooledTree<int>;
+using coordinate = tree::coordinate;
+
+
+struct hash
+{
+    std::size_t operator()(const int& x) const
+    {
+        return std::hash<int>{}(x);
+    }
+};
+
+
+// A random tree of n nodes of values in [0, m), and its nodes in the order of insertion.
+std::pair<tree, std::vector<coordinate>> random_tree(std::size_t n, int m, std::mt19937& g)
+{
+    tree t;
+    std::vector<coordinate> nodes;
+    if (n == 0) return {std::move(t), nodes};
+    nodes.push_back(t.make_root(static_cast<int>(g() % m)));
+    while (nodes.size() < n)
+    {
+        coordinate c = nodes[g() % nodes.size()];
+        int x = static_cast<int>(g() % m);
+        if (g() % 2 == 0 && !c.has_left_successor()) nodes.push_back(t.insert_left(c, x));
+        else if (!c.has_right_successor()) nodes.push_back(t.insert_right(c, x));
+    }
+    return {std::move(t), nodes};
+}
+
+
+// Copies the successors of c as the successors of d.
+void copy_successors(coordinate c, tree& t, coordinate d)
+{
+    if (c.has_left_successor()) copy_successors(c.left_successor(), t, t.insert_left(d, *c.left_successor()));
+    if (c.has_right_successor()) copy_successors(c.right_successor(), t, t.insert_right(d, *c.right_successor()));
+}
+
+
+// Copies the tree of c in the empty tree t.
+void copy(coordinate c, tree& t)
+{
+    if (!c.empty()) copy_successors(c, t, t.make_root(*c));
+}
+
+
+// The visits of traverse, with the value at the pre visits: -visit so that a successor is greater
+// than a missing one.
+std::vector<std::pair<int, int>> tokens(coordinate c)
+{
+    std::vector<std::pair<int, int>> s;
+    if (c.empty()) return s;
+    auto proc = [&s](eop::visit v, coordinate x)
+    {
+        s.emplace_back(-static_cast<int>(v), v == eop::visit::pre ? *x : 0);
+        return 0;
+    };
+    eop::traverse(c, proc);
+    return s;
+}
+
+
+bool test_random(std::mt19937& g)
+{
+    using namespace eop;
+
+    for (int k = 0; k < 2000; ++k)
+    {
+        std::size_t n = g() % 40;
+        int m = 1 + static_cast<int>(g() % 4);
+        auto [a, a_nodes] = random_tree(n, m, g);
+        auto [b, b_nodes] = random_tree(g() % 4 == 0 ? n : g() % 40, m, g);
+        tree c;
+        copy(a.root(), c);
+
+        std::vector<std::pair<int, int>> ta = tokens(a.root());
+        std::vector<std::pair<int, int>> tb = tokens(b.root());
+        std::vector<std::pair<int, int>> tc = tokens(c.root());
+        if (ta != tc) return false;
+
+        auto shape = [](std::vector<std::pair<int, int>> s)
+        {
+            for (auto& x : s) x.second = 0;
+            return s;
+        };
+        if (bifurcate_isomorphic(a.root(), b.root()) != (shape(ta) == shape(tb))) return false;
+        if (bifurcate_equivalent(a.root(), b.root(), eop::equal<int>{}) != (ta == tb)) return false;
+        if (bifurcate_compare(a.root(), b.root(), eop::less<int>{}) != std::lexicographical_compare(ta.begin(), ta.end(), tb.begin(), tb.end())) return false;
+        if (!bifurcate_isomorphic(a.root(), c.root()) || !bifurcate_equivalent(a.root(), c.root(), eop::equal<int>{})) return false;
+        if (bifurcate_compare(a.root(), c.root(), eop::less<int>{}) || bifurcate_compare(c.root(), a.root(), eop::less<int>{})) return false;
+
+        auto fa = bifurcate_fingerprint(a.root(), hash{});
+        auto fb = bifurcate_fingerprint(b.root(), hash{});
+        auto fc = bifurcate_fingerprint(c.root(), hash{});
+        if (fa != fc || fa.weight != n) return false;
+        if (bifurcate_equivalent(a.root(), fa, b.root(), fb, eop::equal<int>{}) != (ta == tb)) return false;
+        if (bifurcate_isomorphic(a.root(), fa, b.root(), fb) != (shape(ta) == shape(tb))) return false;
+
+        int sum = 0;
+        for_each(a.root(), [&sum](int x) { sum += x; return 0; });
+        int expected = 0;
+        for (coordinate x : a_nodes) expected += *x;
+        if (sum != expected) return false;
+    }
+    return true;
+}
+
+
+bool bench(std::mt19937& g)
+{
+    using namespace eop;
+
+    auto [a, nodes] = random_tree(1 << 22, 1 << 30, g);
+    tree b;
+    copy(a.root(), b);
+    // The difference is in the last node in pre order of b.
+    coordinate last = b.root();
+    while (last.has_left_successor() || last.has_right_successor())
+    {
+        last = last.has_right_successor() ? last.right_successor() : last.left_successor();
+    }
+    auto fa = bifurcate_fingerprint(a.root(), hash{});
+    auto fb = bifurcate_fingerprint(b.root(), hash{});
+
+    bool equal_trees = false;
+    bool different_trees = true;
+    bool different_fingerprints = true;
+    std::cout << "compare, " << a.size() << " nodes" << std::endl;
+    std::cout << "    fingerprint: " << time_ms([&]() { fb = bifurcate_fingerprint(b.root(), hash{}); }) << " ms" << std::endl;
+    std::cout << "    equal trees: " << time_ms([&]() { equal_trees = bifurcate_equivalent(a.root(), fa, b.root(), fb, eop::equal<int>{}); }) << " ms" << std::endl;
+    ++*last;
+    std::cout << "    different trees: " << time_ms([&]() { different_trees = bifurcate_equivalent(a.root(), b.root(), eop::equal<int>{}); }) << " ms" << std::endl;
+    fb = bifurcate_fingerprint(b.root(), hash{});
+    std::cout << "    different trees, fingerprints: " << time_ms([&]() { different_fingerprints = bifurcate_equivalent(a.root(), fa, b.root(), fb, eop::equal<int>{}); }) << " ms" << std::endl;
+    return equal_trees && !different_trees && !different_fingerprints;
+}
+
+
+int main()
+{
+    std::mt19937 g(13);
+
+    bool ok = test_random(g) && bench(g);
+    std::cout << (ok ? "bifurcate algorithms: ok" : "bifurcate algorithms: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
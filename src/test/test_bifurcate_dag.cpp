@@ -0,0 +1,213 @@
+// Check BifurcateDag on expression trees with repeated subtrees: the weights and heights of the
+// nodes against the unfolded trees and the memoized functions, the sharing of the equal subtrees,
+// the moves (the moved-from dags are empty and usable), is_dag on dags and on a cycle, and time
+// weight on the tree, on the dag unfolded and memoized.
+
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../bifurcate_coordinates.hpp"
+#include "../bifurcate_dag.hpp"
+#include "../pooled_tree.hpp"
+#include "bench.hpp"
+
+
+using tree = eop::PooledTree<int>;
+using dag = eop::BifurcateDag<int>;
+
+static_assert(eop::bifurcate_coordinate<dag::coordinate>);
+
+
+// Copies the successors of c as the successors of d.
+void copy_successors(tree::coordinate c, tree& t, tree::coordinate d)
+{
+    if (c.has_left_successor()) copy_successors(c.left_successor(), t, t.insert_left(d, *c.left_successor()));
+    if (c.has_right_successor()) copy_successors(c.right_successor(), t, t.insert_right(d, *c.right_successor()));
+}
+
+
+// A perfect tree of height h with values in [0, 2) in the empty tree t.
+void random_perfect(tree& t, int h, std::mt19937& g)
+{
+    std::vector<tree::coordinate> level{t.make_root(static_cast<int>(g() % 2))};
+    for (int k = 1; k < h; ++k)
+    {
+        std::vector<tree::coordinate> next;
+        for (tree::coordinate c : level)
+        {
+            next.push_back(t.insert_left(c, static_cast<int>(g() % 2)));
+            next.push_back(t.insert_right(c, static_cast<int>(g() % 2)));
+        }
+        level = next;
+    }
+}
+
+
+// Operators (values in [10, 14)) down to the height of the operands, the operands are copies of
+// a few random perfect trees.
+void expression(tree& t, tree::coordinate c, int h, const std::vector<tree>& operands, std::mt19937& g)
+{
+    int operand_height = static_cast<int>(eop::height(operands[0].root()));
+    for (bool left : {true, false})
+    {
+        if (h - 1 == operand_height)
+        {
+            tree::coordinate o = operands[g() % operands.size()].root();
+            tree::coordinate d = left ? t.insert_left(c, *o) : t.insert_right(c, *o);
+            copy_successors(o, t, d);
+        }
+        else
+        {
+            tree::coordinate d = left ? t.insert_left(c, 10 + static_cast<int>(g() % 4)) : t.insert_right(c, 10 + static_cast<int>(g() % 4));
+            expression(t, d, h - 1, operands, g);
+        }
+    }
+}
+
+
+// A node with pointer successors, to make a cycle.
+struct node
+{
+    node* left = nullptr;
+    node* right = nullptr;
+};
+
+
+struct coordinate
+{
+    using weight_type = std::size_t;
+
+    node* p = nullptr;
+
+    bool empty() const { return p == nullptr; }
+    bool has_left_successor() const { return p->left != nullptr; }
+    bool has_right_successor() const { return p->right != nullptr; }
+    coordinate left_successor() const { return {p->left}; }
+    coordinate right_successor() const { return {p->right}; }
+
+    friend
+    bool operator==(const coordinate&, const coordinate&) = default;
+};
+
+
+struct coordinate_hash
+{
+    std::size_t operator()(coordinate c) const
+    {
+        return std::hash<node*>{}(c.p);
+    }
+};
+
+
+bool test_is_dag()
+{
+    std::vector<node> nodes(4);
+    // 0 -> 1, 2; 1 -> 3; 2 -> 3: a dag, not a tree.
+    nodes[0] = {&nodes[1], &nodes[2]};
+    nodes[1] = {&nodes[3], nullptr};
+    nodes[2] = {nullptr, &nodes[3]};
+    coordinate c{nodes.data()};
+    bool ok = eop::is_dag(c, coordinate_hash{}) && eop::weight_memoized(c, coordinate_hash{}) == 5 &&
+              eop::height_memoized(c, coordinate_hash{}) == 3;
+    // 3 -> 0: a cycle.
+    nodes[3].left = &nodes[0];
+    return ok && !eop::is_dag(c, coordinate_hash{}) && eop::is_dag(coordinate{}, coordinate_hash{});
+}
+
+
+bool test_expression(std::mt19937& g)
+{
+    using namespace eop;
+
+    std::vector<tree> operands(20);
+    for (tree& o : operands) random_perfect(o, 5, g);
+    tree t;
+    expression(t, t.make_root(10), 20, operands, g);
+
+    dag d;
+    dag::coordinate r;
+    std::cout << "intern, " << t.size() << " nodes: " << time_ms([&]() { r = d.intern(t.root()); }) << " ms" << std::endl;
+    std::cout << "    " << d.size() << " distinct nodes, " << double(t.size()) / double(d.size()) << "x less" << std::endl;
+
+    std::size_t w_tree = 0;
+    std::size_t w_unfolded = 0;
+    std::size_t w_memoized = 0;
+    std::size_t w_node = 0;
+    std::cout << "weight" << std::endl;
+    std::cout << "    tree: " << time_ms([&]() { w_tree = weight(t.root()); }) << " ms" << std::endl;
+    std::cout << "    dag unfolded: " << time_ms([&]() { w_unfolded = weight_recursive(r); }) << " ms" << std::endl;
+    std::cout << "    dag memoized: " << time_ms([&]() { w_memoized = weight_memoized(r); }) << " ms" << std::endl;
+    std::cout << "    dag node: " << time_ms([&]() { w_node = d.weight(r); }) << " ms" << std::endl;
+    bool ok = w_tree == t.size() && w_unfolded == w_tree && w_memoized == w_tree && w_node == w_tree;
+    ok = ok && d.height(r) == height(t.root()) && height_memoized(r) == d.height(r) && is_dag(r);
+
+    // A copy is the same node, the equal operands are shared.
+    std::size_t n = d.size();
+    tree u;
+    copy_successors(t.root(), u, u.make_root(*t.root()));
+    ok = ok && d.intern(u.root()) == r && d.size() == n;
+    for (const tree& o : operands)
+    {
+        dag::coordinate c = d.intern(o.root());
+        ok = ok && d.weight(c) == 31 && d.height(c) == 5;
+    }
+    return ok && d.size() == n;
+}
+
+
+bool test_make()
+{
+    dag d;
+    dag::coordinate a = d.make(1);
+    dag::coordinate b = d.make(1);
+    dag::coordinate c = d.make(2, a, b);
+    dag::coordinate e = d.make(2, b, a);
+    dag::coordinate f = d.make(2, a);
+    return a == b && c == e && c != f && d.size() == 3 && d.weight(c) == 3 && d.weight(f) == 2 &&
+           d.height(c) == 2 && d.weight(dag::coordinate{}) == 0 && *c.left_successor() == 1;
+}
+
+
+
+// The moved-to dag has the nodes and the coordinates stay valid, the moved-from dag is empty and
+// usable.
+bool test_move()
+{
+    dag d;
+    dag::coordinate a = d.make(1);
+    dag::coordinate c = d.make(2, a, a);
+    for (int x = 0; x < 100; ++x) d.make(x, c);
+
+    dag e(std::move(d));
+    if (e.size() != 102 || e.make(2, a, a) != c || e.weight(c) != 3 || *c.left_successor() != 1) return false;
+    if (d.size() != 0) return false;
+    for (int x = 0; x < 100; ++x) d.make(x);
+    if (d.size() != 100 || d.make(7) != d.make(7) || d.size() != 100) return false;
+
+    dag f;
+    f.make(5);
+    f = std::move(e);
+    if (f.size() != 102 || f.make(2, a, a) != c || e.size() != 0) return false;
+    dag::coordinate b = e.make(3);
+    if (e.size() != 1 || e.make(3) != b || e.weight(e.make(4, b, b)) != 3) return false;
+
+    // Moved back and forth, and to itself through a reference.
+    e = std::move(d);
+    d = std::move(f);
+    dag& g = d;
+    d = std::move(g);
+    return d.size() == 102 && d.make(2, a, a) == c && e.size() == 100 && f.size() == 0 && f.make(1) != a;
+}
+
+int main()
+{
+    std::mt19937 g(17);
+
+    bool ok = test_make() && test_move() && test_is_dag() && test_expression(g);
+    std::cout << (ok ? "bifurcate dag: ok" : "bifurcate dag: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+// Check BidirectionalBifurcateIterator on random binary search trees and on subtrees: the in order
+// sequence forward and backward, and find_if, count_if, reduce and lower_bound of algorithms.hpp on
+// the iterators. Time the iteration against traverse and against the copy to a vector.
+
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../algorithms.hpp"
+#include "../bifurcate_coordinates.hpp"
+#include "../pooled_tree.hpp"
+#include "bench.hpp"
+
+
+using tree = eop::PooledTree<int>;
+using coordinate = tree::coordinate;
+using tree_iterator = eop::BidirectionalBifurcateIterator<coordinate>;
+
+static_assert(eop::bidirectional_iterator<tree_iterator>);
+
+
+void insert(tree& t, int x)
+{
+    if (t.empty())
+    {
+        t.make_root(x);
+        return;
+    }
+    coordinate c = t.root();
+    while (true)
+    {
+        if (x < *c)
+        {
+            if (!c.has_left_successor())
+            {
+                t.insert_left(c, x);
+                return;
+            }
+            c = c.left_successor();
+        }
+        else
+        {
+            if (!c.has_right_successor())
+            {
+                t.insert_right(c, x);
+                return;
+            }
+            c = c.right_successor();
+        }
+    }
+}
+
+
+struct in_order
+{
+    std::vector<int>* values;
+
+    int operator()(eop::visit v, coordinate c)
+    {
+        if (v == eop::visit::in) values->push_back(*c);
+        return 0;
+    }
+};
+
+
+// The in order values of the tree of c, forward with the iterators, then backward.
+bool check_range(coordinate c)
+{
+    std::vector<int> expected;
+    eop::traverse(c, in_order{&expected});
+
+    std::vector<int> forward;
+    tree_iterator f(c);
+    tree_iterator l = tree_iterator::end(c);
+    for (tree_iterator i = f; i != l; ++i) forward.push_back(*i);
+
+    std::vector<int> backward;
+    for (tree_iterator i = l; i != f;) backward.push_back(*--i);
+    std::reverse(backward.begin(), backward.end());
+    return forward == expected && backward == expected;
+}
+
+
+bool test_random(std::mt19937& g)
+{
+    using namespace eop;
+
+    for (int n : {0, 1, 2, 3, 10, 100, 10'000})
+    {
+        tree t;
+        std::vector<int> keys(n);
+        for (int& k : keys) k = static_cast<int>(g() % 1000);
+        for (int k : keys) insert(t, k);
+        std::sort(keys.begin(), keys.end());
+
+        if (!check_range(t.root())) return false;
+        if (n == 0) continue;
+        if (t.root().has_left_successor() && !check_range(t.root().left_successor())) return false;
+        if (t.root().has_right_successor() && !check_range(t.root().right_successor())) return false;
+
+        tree_iterator f(t.root());
+        tree_iterator l = tree_iterator::end(t.root());
+        auto even = [](int x) { return x % 2 == 0; };
+        if (find_if(f, l, even) == l ? !std::none_of(keys.begin(), keys.end(), even) : *find_if(f, l, even) != *std::find_if(keys.begin(), keys.end(), even)) return false;
+        if (count_if(f, l, even) != static_cast<std::size_t>(std::count_if(keys.begin(), keys.end(), even))) return false;
+
+        auto plus = [](std::int64_t a, std::int64_t b) { return a + b; };
+        auto widen = [](int x) { return static_cast<std::int64_t>(x); };
+        std::int64_t sum = 0;
+        for (int k : keys) sum += k;
+        if (reduce(f, l, plus, widen, std::int64_t{0}) != sum) return false;
+
+        for (int a : {-1, 0, 500, 999, 1000})
+        {
+            tree_iterator i = lower_bound(f, l, a, less<int>{});
+            auto j = std::lower_bound(keys.begin(), keys.end(), a);
+            if ((i == l) != (j == keys.end())) return false;
+            if (i != l && *i != *j) return false;
+        }
+    }
+    return true;
+}
+
+
+struct sum
+{
+    std::int64_t total = 0;
+
+    int operator()(eop::visit v, coordinate c)
+    {
+        if (v == eop::visit::in) total += *c;
+        return 0;
+    }
+};
+
+
+bool bench(std::mt19937& g)
+{
+    tree t;
+    for (int i = 0; i < (1 << 20); ++i) insert(t, static_cast<int>(g()));
+
+    std::int64_t s_iterator = 0;
+    std::int64_t s_vector = 0;
+    sum s_traverse;
+    std::cout << "sum in order, " << t.size() << " nodes" << std::endl;
+    std::cout << "    iterator: " << time_ms([&]() {
+        tree_iterator l = tree_iterator::end(t.root());
+        for (tree_iterator i(t.root()); i != l; ++i) s_iterator += *i;
+    }) << " ms" << std::endl;
+    std::cout << "    traverse: " << time_ms([&]() { s_traverse = eop::traverse(t.root(), sum{}); }) << " ms" << std::endl;
+    std::cout << "    copy to a vector: " << time_ms([&]() {
+        std::vector<int> v;
+        v.reserve(t.size());
+        tree_iterator l = tree_iterator::end(t.root());
+        for (tree_iterator i(t.root()); i != l; ++i) v.push_back(*i);
+        for (int x : v) s_vector += x;
+    }) << " ms" << std::endl;
+    return s_iterator == s_traverse.total && s_vector == s_iterator;
+}
+
+
+int main()
+{
+    std::mt19937 g(19);
+
+    bool ok = test_random(g) && bench(g);
+    std::cout << (ok ? "bifurcate iterator: ok" : "bifurcate iterator: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
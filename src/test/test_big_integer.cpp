@@ -0,0 +1,299 @@
+// Check BigInteger: the arithmetic against __int128 on small values with signs, the transition
+// from the inline limbs to the Vector, the products across the Karatsuba and Toom-3 thresholds
+// against a product by single limbs, (a * b) / b == a and a == q * b + r with 0 <= |r| < |b|
+// for the long division (Knuth D) on random limbs and on limbs near 0 and 2^64, and the squares.
+// Check that BigInteger models integer and euclidean_monoid, and Fib::fibonacci, AssociativeOp::power
+// (with a BigInteger exponent), Remainder::remainder_nonnegative and GCD::fast_subtractive_gcd on it
+// against known values. Check the Vector members BigInteger relies on: resize, pop_back, clear,
+// operator[], capacity and the copy and the move.
+
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../associative_operations.hpp"
+#include "../big_integer.hpp"
+#include "../division.hpp"
+#include "../fibonacci.hpp"
+#include "../vector.hpp"
+
+
+using eop::BigInteger;
+using limb = BigInteger::limb;
+
+static_assert(eop::integer<BigInteger> && eop::euclidean_monoid<BigInteger>);
+
+
+BigInteger from_limbs(const eop::Vector<limb>& v)
+{
+    BigInteger r;
+    for (std::size_t i = v.size(); i-- > 0; ) r = (r << 64) + BigInteger{v[i]};
+    return r;
+}
+
+
+// n random limbs, the limbs are near 0 and 2^64 for the corrections of the quotient digits.
+BigInteger random_big(std::mt19937_64& g, std::size_t n, bool edges = false)
+{
+    eop::Vector<limb> v;
+    v.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (!edges)
+        {
+            v[i] = g();
+            continue;
+        }
+        switch (g() % 5)
+        {
+        case 0: v[i] = 0; break;
+        case 1: v[i] = 1; break;
+        case 2: v[i] = limb{1} << 63; break;
+        case 3: v[i] = ~limb{0}; break;
+        default: v[i] = ~limb{0} - g() % 4; break;
+        }
+    }
+    if (n > 0 && v[n - 1] == 0) v[n - 1] = 1;
+    BigInteger r = from_limbs(v);
+    return g() % 2 == 0 ? r : -r;
+}
+
+
+BigInteger from_int128(__int128 x)
+{
+    bool negative = x < 0;
+    unsigned __int128 m = negative ? -static_cast<unsigned __int128>(x) : static_cast<unsigned __int128>(x);
+    BigInteger r = (BigInteger{static_cast<limb>(m >> 64)} << 64) + BigInteger{static_cast<limb>(m)};
+    return negative ? -r : r;
+}
+
+
+BigInteger abs(const BigInteger& a)
+{
+    return a.is_negative() ? -a : a;
+}
+
+
+bool test_small(std::mt19937_64& g)
+{
+    for (int step = 0; step < 100'000; ++step)
+    {
+        // Operands of up to 62 bits, so that the products fit in an __int128.
+        __int128 x = static_cast<std::int64_t>(g()) >> (g() % 63 + 1);
+        __int128 y = static_cast<std::int64_t>(g()) >> (g() % 63 + 1);
+        BigInteger a = from_int128(x);
+        BigInteger b = from_int128(y);
+        if (a + b != from_int128(x + y) || a - b != from_int128(x - y) || a * b != from_int128(x * y)) return false;
+        if ((a < b) != (x < y) || (a == b) != (x == y)) return false;
+        if (y != 0 && (a / b != from_int128(x / y) || a % b != from_int128(x % y))) return false;
+        // 127 bit dividends.
+        __int128 z = x * y + (x < 0 ? -1 : 1) * static_cast<__int128>(g() >> 2);
+        if (y != 0 && (from_int128(z) / b != from_int128(z / y) || from_int128(z) % b != from_int128(z % y))) return false;
+    }
+    return BigInteger{std::int64_t{-5}}.to_string() == "-5" && BigInteger{}.to_string() == "0" &&
+           BigInteger{0}.is_zero() && !(-BigInteger{0}).is_negative() &&
+           (BigInteger{3} - BigInteger{3}).is_zero() && !(BigInteger{3} - BigInteger{3}).is_negative();
+}
+
+
+// 2^128 needs 3 limbs, one more than the inline limbs.
+bool test_inline_to_heap()
+{
+    BigInteger x = (BigInteger{~limb{0}} << 64) + BigInteger{~limb{0}};
+    bool ok = x.size() == BigInteger::inline_capacity && x.bit_width() == 128;
+    BigInteger y = x + BigInteger{1};
+    ok = ok && y.size() == 3 && y.bit_width() == 129 && y.to_string() == "340282366920938463463374607431768211456";
+    ok = ok && y - BigInteger{1} == x && (y - BigInteger{1}).size() == 2 && (y >> 1) == (BigInteger{1} << 127);
+    // From the heap back to one limb, then growing again in the same object.
+    BigInteger z = y;
+    z = z - x;
+    ok = ok && z == BigInteger{1} && z.size() == 1;
+    z = z << 200;
+    ok = ok && z.size() == 4 && (z >> 200) == BigInteger{1};
+    ok = ok && x * x == (y << 128) - (y << 1) + BigInteger{1};
+    ok = ok && (y * y) / y == y && y % x == BigInteger{1} && y / x == BigInteger{1};
+    return ok;
+}
+
+
+// The product by the limbs of the smaller operand, each with the schoolbook product of one limb.
+BigInteger reference_product(const BigInteger& a, const BigInteger& b)
+{
+    const BigInteger& x = a.size() < b.size() ? a : b;
+    const BigInteger& y = a.size() < b.size() ? b : a;
+    BigInteger r;
+    BigInteger m = abs(y);
+    for (std::size_t i = 0; i < x.size(); ++i) r = r + ((m * BigInteger{x[i]}) << static_cast<int>(64 * i));
+    return x.is_negative() != y.is_negative() ? -r : r;
+}
+
+
+bool test_products(std::mt19937_64& g)
+{
+    constexpr std::size_t k = BigInteger::karatsuba_threshold;
+    constexpr std::size_t t = BigInteger::toom3_threshold;
+    for (std::size_t n : {std::size_t{1}, std::size_t{2}, std::size_t{3}, k - 1, k, k + 1, 2 * k + 1, t - 1, t, t + 1, 2 * t + 7})
+    {
+        for (std::size_t m : {std::size_t{1}, std::size_t{3}, k - 1, k, k + 1, t - 1, t, t + 1, 3 * t})
+        {
+            bool edges = (n + m) % 2 == 0;
+            BigInteger a = random_big(g, n, edges);
+            BigInteger b = random_big(g, m, edges);
+            BigInteger p = a * b;
+            if (p != reference_product(a, b) || p != b * a || p.size() < n + m - 1) return false;
+            if (p / b != a || p / a != b || !(p % b).is_zero()) return false;
+            // Distributivity across the thresholds.
+            BigInteger c = random_big(g, m, edges);
+            if (a * (b + c) != p + a * c) return false;
+        }
+        // The squares are products of an object with itself.
+        BigInteger a = random_big(g, n, n % 2 == 0);
+        BigInteger b = a;
+        BigInteger s = a * a;
+        if (s != a * b || s.is_negative() || s / a != a) return false;
+    }
+    return true;
+}
+
+
+bool test_division(std::mt19937_64& g)
+{
+    for (int step = 0; step < 3000; ++step)
+    {
+        std::size_t n = 1 + g() % 40;
+        std::size_t m = 1 + g() % (n + 2);
+        bool edges = step % 2 == 0;
+        BigInteger a = random_big(g, n, edges);
+        BigInteger b = random_big(g, m, edges);
+        auto qr = BigInteger::quotient_remainder(a, b);
+        BigInteger q = qr.first;
+        BigInteger r = qr.second;
+        // Truncated division: the remainder has the sign of a.
+        if (q * b + r != a || abs(r) >= abs(b) || (!r.is_zero() && r.is_negative() != a.is_negative())) return false;
+        if (a / b != q || a % b != r) return false;
+        if (!q.is_zero() && q.is_negative() != (a.is_negative() != b.is_negative())) return false;
+        // The quotient digits of (a * b + r) / b are the limbs of a.
+        BigInteger c = abs(a) * abs(b) + abs(r);
+        if (c / abs(b) != abs(a) || c % abs(b) != abs(r)) return false;
+    }
+    // The dividend has the most significant bit set, the divisor has it cleared.
+    BigInteger a = (BigInteger{~limb{0}} << 192) + (BigInteger{limb{1} << 63} << 64);
+    BigInteger b = (BigInteger{limb{1}} << 64) + BigInteger{~limb{0}};
+    auto qr = BigInteger::quotient_remainder(a, b);
+    return qr.first * b + qr.second == a && qr.second < b && BigInteger{7} / a == BigInteger{} && BigInteger{-7} % a == BigInteger{-7};
+}
+
+
+bool test_vector()
+{
+    eop::Vector<int> v;
+    bool ok = v.size() == 0 && v.capacity() == 0;
+    v.resize(5);
+    ok = ok && v.size() == 5 && v.capacity() >= 5 && v[0] == 0 && v[4] == 0;
+    for (int i = 0; i < 5; ++i) v[i] = i + 1;
+    v.emplace_back(6);
+    ok = ok && v.size() == 6 && v[5] == 6 && v.back() == 6;
+    // capacity is the number of allocated elements, not the size.
+    std::size_t c = v.capacity();
+    v.reserve(100);
+    ok = ok && c >= 6 && v.capacity() == 100 && v.size() == 6 && v[2] == 3;
+    v.pop_back();
+    ok = ok && v.size() == 5 && v.back() == 5;
+    // Growing again value initializes the elements after the old size.
+    v.resize(7);
+    ok = ok && v.size() == 7 && v[5] == 0 && v[6] == 0 && v[4] == 5;
+    v.resize(3);
+    ok = ok && v.size() == 3 && v.capacity() == 100;
+    const eop::Vector<int>& w = v;
+    ok = ok && w[2] == 3 && w.raw_data() == v.raw_data();
+
+    // The copy allocates the size, not the capacity of the source, and is independent of it.
+    eop::Vector<int> copy = v;
+    ok = ok && copy.size() == 3 && copy.capacity() == 3 && copy[0] == 1 && copy[2] == 3 && copy.raw_data() != v.raw_data();
+    copy[0] = 10;
+    ok = ok && v[0] == 1;
+    copy = copy;
+    ok = ok && copy.size() == 3 && copy[0] == 10;
+    copy = v;
+    ok = ok && copy[0] == 1;
+
+    // The moved from vector is empty and usable.
+    eop::Vector<int> moved = std::move(v);
+    ok = ok && moved.size() == 3 && moved.capacity() == 100 && moved[2] == 3;
+    ok = ok && v.size() == 0 && v.capacity() == 0;
+    v.emplace_back(42);
+    ok = ok && v.size() == 1 && v[0] == 42;
+    eop::Vector<int> other;
+    other = std::move(moved);
+    ok = ok && other.size() == 3 && moved.size() == 0 && moved.capacity() == 0;
+
+    other.clear();
+    ok = ok && other.size() == 0 && other.capacity() == 100 && other.begin() == other.end();
+    other.emplace_back(7);
+    ok = ok && other.size() == 1 && other[0] == 7;
+
+    // Elements that are not trivially copyable.
+    eop::Vector<std::string> s;
+    s.resize(2);
+    s[1] = "abc";
+    s.emplace_back("def");
+    eop::Vector<std::string> t = s;
+    s.pop_back();
+    ok = ok && s.size() == 2 && t.size() == 3 && t[0].empty() && t[1] == "abc" && t[2] == "def";
+    return ok;
+}
+
+
+// The generic algorithms on BigInteger against known values: the Fibonacci numbers, the powers
+// (with a BigInteger exponent), the remainder and gcd(F(m), F(n)) = F(gcd(m, n)).
+bool test_generic()
+{
+    using namespace eop;
+
+    BigInteger f0{0};
+    BigInteger f1{1};
+    for (int n = 0; n < 300; ++n)
+    {
+        if (Fib::fibonacci(BigInteger{n}) != f0) return false;
+        BigInteger f = f0 + f1;
+        f0 = f1;
+        f1 = f;
+    }
+    if (Fib::fibonacci(BigInteger{1000}).to_string() !=
+        "43466557686937456435688527675040625802564660517371780402481729089536555417949051890403879840079"
+        "25516929592259308032263477520968962323987332247116164299644090653318793829896964992851600370447"
+        "6137795166849228875") return false;
+
+    auto multiply = [](BigInteger a, BigInteger b) -> BigInteger { return a * b; };
+    if (AssociativeOp::power(BigInteger{3}, 200, multiply).to_string() !=
+        "265613988875874769338781322035779626829233452653394495974574961739092490901302182994384699044001") return false;
+    // 12345678901234567890^(10^20 + 3) mod 2^127 - 1.
+    static const BigInteger m = (BigInteger{1} << 127) - BigInteger{1};
+    auto multiply_mod = [](BigInteger a, BigInteger b) -> BigInteger { return a * b % m; };
+    BigInteger n = BigInteger{100'000'000'000'000'000ull} * BigInteger{1000} + BigInteger{3};
+    if (AssociativeOp::power(BigInteger{12'345'678'901'234'567'890ull}, n, multiply_mod).to_string() !=
+        "158284098517028644956530548522111850836") return false;
+
+    // (10^40 + 7) mod (2^64 + 13).
+    BigInteger a = AssociativeOp::power(BigInteger{10}, 40, multiply) + BigInteger{7};
+    BigInteger b = (BigInteger{1} << 64) + BigInteger{13};
+    if (Remainder::remainder_nonnegative(a, b).to_string() != "12741837920208574398") return false;
+    if (Remainder::remainder_nonnegative(b, a) != b || Remainder::remainder_nonnegative(a, a) != BigInteger{0}) return false;
+
+    return GCD::fast_subtractive_gcd(Fib::fibonacci(BigInteger{1000}), Fib::fibonacci(BigInteger{750})) == Fib::fibonacci(BigInteger{250}) &&
+           GCD::fast_subtractive_gcd(Fib::fibonacci(BigInteger{997}), Fib::fibonacci(BigInteger{1000})) == BigInteger{1} &&
+           GCD::fast_subtractive_gcd(a, BigInteger{0}) == a;
+}
+
+
+int main()
+{
+    std::mt19937_64 g(31);
+
+    bool ok = test_vector() && test_small(g) && test_inline_to_heap() && test_products(g) && test_division(g) &&
+              test_generic();
+    std::cout << (ok ? "big integer: ok" : "big integer: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+// Check BranchFreeOrdering with the exhaustive harness of test_stability_order_select.cpp: on all
+// the n^n inputs of 2 to 5 keys every branch-free selection returns the key of Ordering::select_*
+// and of the stable sort, for int, float and std::int16_t keys. Check median_5_batch and
+// median_5_filter (SIMD lanes and the scalar tail) against the scalar median_5 on random lanes.
+
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "../branch_free_ordering.hpp"
+#include "../linear_ordering.hpp"
+#include "selection_harness.hpp"
+
+
+// On every input of N keys, the branch-free selection of the keys converted to T is the key of
+// the element selected by Ordering and of the element of rank K of the stable sort.
+template <int N, int K, typename T, typename BranchFree, typename Select>
+constexpr bool agree(BranchFree branch_free, Select select)
+{
+    int inputs = 1;
+    for (int i = 0; i < N; ++i) inputs = inputs * N;
+
+    auto r = [](const element& x, const element& y) -> bool { return x.key < y.key; };
+    for (int code = 0; code < inputs; ++code)
+    {
+        const std::array<element, N> a = make_input<N>(code);
+        std::array<T, N> keys{};
+        for (int i = 0; i < N; ++i) keys[i] = static_cast<T>(a[i].key);
+        T x = branch_free(keys);
+        if (x != static_cast<T>(select(a, r).key) || x != static_cast<T>(stable_rank<N>(a, K, false).key)) return false;
+    }
+    return true;
+}
+
+
+using eop::BranchFreeOrdering;
+
+template <typename T>
+constexpr bool agree_all()
+{
+    return agree<2, 0, T>([](const auto& k) { return BranchFreeOrdering::select_0_2(k[0], k[1]); }, select_0_2) &&
+           agree<2, 1, T>([](const auto& k) { return BranchFreeOrdering::select_1_2(k[0], k[1]); }, select_1_2) &&
+           agree<3, 0, T>([](const auto& k) { return BranchFreeOrdering::select_0_3(k[0], k[1], k[2]); }, select_0_3) &&
+           agree<3, 1, T>([](const auto& k) { return BranchFreeOrdering::select_1_3(k[0], k[1], k[2]); }, select_1_3) &&
+           agree<3, 2, T>([](const auto& k) { return BranchFreeOrdering::select_2_3(k[0], k[1], k[2]); }, select_2_3) &&
+           agree<4, 1, T>([](const auto& k) { return BranchFreeOrdering::select_1_4(k[0], k[1], k[2], k[3]); }, select_1_4) &&
+           agree<4, 2, T>([](const auto& k) { return BranchFreeOrdering::select_2_4(k[0], k[1], k[2], k[3]); }, select_2_4) &&
+           agree<5, 2, T>([](const auto& k) { return BranchFreeOrdering::median_5(k[0], k[1], k[2], k[3], k[4]); }, median_5);
+}
+
+static_assert(agree_all<int>(), "branch-free selections on int");
+static_assert(agree_all<float>(), "branch-free selections on float");
+static_assert(agree_all<std::int16_t>(), "branch-free selections on int16");
+
+
+template <typename T>
+T random_value(std::mt19937& g)
+{
+    // Few distinct values: many ties.
+    if (g() % 4 == 0) return static_cast<T>(g() % 4);
+    if constexpr (std::is_floating_point_v<T>) return static_cast<T>(std::uniform_real_distribution<double>(-1e6, 1e6)(g));
+    else return static_cast<T>(g());
+}
+
+
+template <typename T>
+bool test_simd(std::mt19937& g)
+{
+    auto scalar = [](T a, T b, T c, T d, T e) { return eop::Ordering::median_5(a, b, c, d, e, eop::less<T>{}); };
+    for (std::size_t n : {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 1000, 1003})
+    {
+        std::vector<std::vector<T>> x(5, std::vector<T>(n));
+        for (auto& v : x)
+        {
+            for (T& y : v) y = random_value<T>(g);
+        }
+        std::vector<T> out(n + 1, T{42});
+        BranchFreeOrdering::median_5_batch(x[0].data(), x[1].data(), x[2].data(), x[3].data(), x[4].data(), n, out.data());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (out[i] != scalar(x[0][i], x[1][i], x[2][i], x[3][i], x[4][i])) return false;
+        }
+        if (out[n] != T{42}) return false;
+
+        if (n < 5) continue;
+        out.assign(n - 3, T{42});
+        BranchFreeOrdering::median_5_filter(x[0].data(), n, out.data());
+        for (std::size_t i = 0; i + 4 < n; ++i)
+        {
+            const T* w = x[0].data() + i;
+            if (out[i] != scalar(w[0], w[1], w[2], w[3], w[4])) return false;
+        }
+        if (out[n - 4] != T{42}) return false;
+    }
+    return true;
+}
+
+
+int main()
+{
+    std::mt19937 g(36);
+
+    bool ok = test_simd<float>(g) && test_simd<double>(g) && test_simd<std::int32_t>(g) &&
+              test_simd<std::int16_t>(g) && test_simd<std::int64_t>(g);
+    std::cout << (ok ? "branch free ordering: ok" : "branch free ordering: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
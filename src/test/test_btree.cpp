@@ -0,0 +1,276 @@
+// Check BTreeSet and BTreeMap against std::set and std::map under random insertions and erasures:
+// the iterators forward and backward, find, lower_bound, upper_bound, select, rank, the bulk load
+// and the moves (the moved-from trees are empty and usable), with the vector search (int) and with
+// a relation (the greater keys first). Time the lookups and the insertions of 10^7 keys against a
+// sorted vector and std::set.
+
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../btree.hpp"
+#include "bench.hpp"
+
+
+using set_type = eop::BTreeSet<int>;
+using map_type = eop::BTreeMap<int, std::int64_t>;
+
+static_assert(eop::bidirectional_iterator<set_type::iterator>);
+static_assert(eop::bidirectional_iterator<map_type::iterator>);
+
+
+struct greater
+{
+    bool operator()(std::string a, std::string b) const
+    {
+        return b < a;
+    }
+};
+
+using string_set = eop::BTree<std::string, void, greater>;
+
+
+// The elements of t forward and backward, and the order statistics.
+template <typename T, typename S>
+bool check(const T& t, const S& expected)
+{
+    if (t.size() != expected.size()) return false;
+    auto j = expected.begin();
+    std::size_t k = 0;
+    for (auto i = t.begin(); i != t.end(); ++i, ++j, ++k)
+    {
+        if (i.key() != *j || t.select(k) != i || t.rank(*j) != k) return false;
+    }
+    if (j != expected.end()) return false;
+    auto i = t.end();
+    for (auto r = expected.rbegin(); r != expected.rend(); ++r)
+    {
+        if ((--i).key() != *r) return false;
+    }
+    return i == t.begin();
+}
+
+
+template <typename K, typename V>
+std::vector<K> keys(const std::map<K, V>& m)
+{
+    std::vector<K> v;
+    for (const auto& [k, x] : m) v.push_back(k);
+    return v;
+}
+
+
+bool test_random(std::mt19937& g)
+{
+    for (int range : {10, 1000, 100'000})
+    {
+        set_type t;
+        std::set<int> s;
+        map_type u;
+        std::map<int, std::int64_t> m;
+        for (int step = 0; step < 200'000; ++step)
+        {
+            int x = static_cast<int>(g() % range) - range / 2;
+            if (g() % 3 != 0)
+            {
+                auto p = t.insert(x);
+                if (p.second != s.insert(x).second || *p.first != x) return false;
+                u[x] += x;
+                m[x] += x;
+            }
+            else
+            {
+                if (t.erase(x) != (s.erase(x) == 1)) return false;
+                if (u.erase(x) != (m.erase(x) == 1)) return false;
+            }
+            if (step % 20'000 == 0 && (!check(t, s) || !check(u, keys(m)))) return false;
+        }
+        if (!check(t, s) || !check(u, keys(m))) return false;
+
+        for (const auto& [k, x] : m)
+        {
+            auto i = u.find(k);
+            if (i == u.end() || i.value() != x || (*i).second != x) return false;
+        }
+        for (int a = -range / 2 - 1; a <= range / 2 + 1; a += 1 + range / 100)
+        {
+            auto l = s.lower_bound(a);
+            auto h = s.upper_bound(a);
+            auto i = t.lower_bound(a);
+            auto j = t.upper_bound(a);
+            if ((i == t.end()) != (l == s.end()) || (i != t.end() && *i != *l)) return false;
+            if ((j == t.end()) != (h == s.end()) || (j != t.end() && *j != *h)) return false;
+            if (t.contains(a) != (s.count(a) == 1)) return false;
+        }
+
+        // Erase everything through the iterators.
+        while (!t.empty()) t.erase(t.select(g() % t.size()));
+        if (t.begin() != t.end() || t.height() != 0) return false;
+    }
+    return true;
+}
+
+
+bool test_relation(std::mt19937& g)
+{
+    string_set t;
+    std::set<std::string, std::greater<std::string>> s;
+    for (int step = 0; step < 50'000; ++step)
+    {
+        std::string x = std::to_string(g() % 5000);
+        if (g() % 3 != 0)
+        {
+            if (t.insert(x).second != s.insert(x).second) return false;
+        }
+        else if (t.erase(x) != (s.erase(x) == 1))
+        {
+            return false;
+        }
+    }
+    return check(t, s);
+}
+
+
+bool test_bulk(std::mt19937& g)
+{
+    for (std::size_t n : {0, 1, 62, 63, 64, 65, 127, 128, 4095, 4096, 4097, 100'000, 1'000'000})
+    {
+        std::vector<int> v(n);
+        for (std::size_t i = 0; i < n; ++i) v[i] = 3 * static_cast<int>(i);
+        set_type t;
+        t.assign_sorted_n(v.data(), n);
+        std::set<int> s(v.begin(), v.end());
+        if (!check(t, s)) return false;
+
+        std::vector<eop::Pair<int, std::int64_t>> w;
+        for (int x : v) w.push_back({x, 2 * x});
+        map_type u;
+        u.assign_sorted_n(w.data(), n);
+        for (int x : v) if (u[x] != 2 * x) return false;
+
+        // The tree stays balanced under modifications.
+        for (int k = 0; k < 1000 && n > 0; ++k)
+        {
+            int x = static_cast<int>(g() % (3 * n));
+            if (g() % 2 == 0)
+            {
+                t.insert(x);
+                s.insert(x);
+            }
+            else
+            {
+                t.erase(x);
+                s.erase(x);
+            }
+        }
+        if (!check(t, s)) return false;
+    }
+    return true;
+}
+
+
+// The moved-to tree has the elements and the iterators stay valid, the moved-from tree is empty
+// and usable.
+bool test_move(std::mt19937& g)
+{
+    set_type t;
+    std::set<int> s;
+    for (int k = 0; k < 10'000; ++k)
+    {
+        int x = static_cast<int>(g() % 100'000);
+        t.insert(x);
+        s.insert(x);
+    }
+    auto i = t.select(t.size() / 2);
+    int x = *i;
+
+    set_type u(std::move(t));
+    if (!check(u, s) || *i != x || u.select(u.size() / 2) != i) return false;
+    if (!t.empty() || t.begin() != t.end() || t.contains(x) || !check(t, std::set<int>{})) return false;
+    for (int y : {3, 1, 2}) t.insert(y);
+    if (!check(t, std::set<int>{1, 2, 3})) return false;
+
+    set_type v;
+    v.insert(7);
+    v = std::move(u);
+    if (!check(v, s) || *i != x) return false;
+    if (!u.empty() || u.begin() != u.end() || u.erase(x)) return false;
+    u.insert(5);
+    if (!check(u, std::set<int>{5})) return false;
+
+    // Moved back and forth, and to itself through a reference.
+    u = std::move(t);
+    t = std::move(v);
+    set_type& w = t;
+    t = std::move(w);
+    return check(t, s) && check(u, std::set<int>{1, 2, 3}) && v.empty() && !v.contains(x);
+}
+
+
+bool bench(std::mt19937& g)
+{
+    constexpr std::size_t n = 10'000'000;
+    constexpr std::size_t lookups = 5'000'000;
+    constexpr std::size_t inserts = 200'000;
+    std::vector<int> v(n);
+    for (int& x : v) x = static_cast<int>(g() >> 1);
+    std::vector<int> q(lookups);
+    for (int& x : q) x = v[g() % n];
+    std::vector<int> w(inserts);
+    for (int& x : w) x = static_cast<int>(g() >> 1);
+
+    set_type t;
+    std::set<int> s;
+    std::vector<int> sorted;
+    std::cout << "build, " << n << " random keys" << std::endl;
+    std::cout << "    btree insert: " << time_ms([&]() { for (int x : v) t.insert(x); }) << " ms" << std::endl;
+    std::cout << "    std::set insert: " << time_ms([&]() { for (int x : v) s.insert(x); }) << " ms" << std::endl;
+    std::cout << "    vector sort: " << time_ms([&]() {
+        sorted = v;
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    }) << " ms" << std::endl;
+    set_type b;
+    std::cout << "    btree bulk load of the vector: " << time_ms([&]() { b.assign_sorted_n(sorted.data(), sorted.size()); }) << " ms" << std::endl;
+    std::cout << "    btree height: " << t.height() << ", bulk loaded: " << b.height() << std::endl;
+
+    std::size_t found_tree = 0;
+    std::size_t found_set = 0;
+    std::size_t found_vector = 0;
+    std::cout << "lookups, " << lookups << " present keys" << std::endl;
+    std::cout << "    btree: " << time_ms([&]() { for (int x : q) found_tree += t.contains(x); }) << " ms" << std::endl;
+    std::cout << "    std::set: " << time_ms([&]() { for (int x : q) found_set += s.count(x); }) << " ms" << std::endl;
+    std::cout << "    sorted vector: " << time_ms([&]() { for (int x : q) found_vector += std::binary_search(sorted.begin(), sorted.end(), x); }) << " ms" << std::endl;
+
+    std::cout << "mixed, " << inserts << " insertions and erasures" << std::endl;
+    std::cout << "    btree: " << time_ms([&]() { for (int x : w) { t.insert(x); t.erase(x ^ 1); } }) << " ms" << std::endl;
+    std::cout << "    std::set: " << time_ms([&]() { for (int x : w) { s.insert(x); s.erase(x ^ 1); } }) << " ms" << std::endl;
+    std::cout << "    sorted vector (1/100 of them): " << time_ms([&]() {
+        for (std::size_t i = 0; i < inserts / 100; ++i)
+        {
+            int x = w[i];
+            auto j = std::lower_bound(sorted.begin(), sorted.end(), x);
+            if (j == sorted.end() || *j != x) sorted.insert(j, x);
+            j = std::lower_bound(sorted.begin(), sorted.end(), x ^ 1);
+            if (j != sorted.end() && *j == (x ^ 1)) sorted.erase(j);
+        }
+    }) << " ms" << std::endl;
+    return found_tree == lookups && found_set == lookups && found_vector == lookups && t.size() == s.size();
+}
+
+
+int main()
+{
+    std::mt19937 g(23);
+
+    bool ok = test_random(g) && test_relation(g) && test_bulk(g) && test_move(g) && bench(g);
+    std::cout << (ok ? "btree: ok" : "btree: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
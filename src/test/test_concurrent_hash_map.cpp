@@ -0,0 +1,236 @@
+// Check ConcurrentHashMap against std::unordered_map in one thread, with optimistic reads (integers)
+// and locked reads (strings); then with threads: readers never see a value that wasn't inserted
+// while writers insert and erase the same keys, and get_or_compute as a shared memo table of
+// Collatz lengths. Time the throughput of 90% finds and 10% insertions or erasures against
+// std::unordered_map behind a mutex, for 1 to 64 threads.
+
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../concurrent_hash_map.hpp"
+#include "bench.hpp"
+
+
+using map_type = eop::ConcurrentHashMap<std::int64_t, std::int64_t>;
+using string_map = eop::ConcurrentHashMap<std::string, std::string>;
+
+static_assert(map_type::optimistic);
+static_assert(!string_map::optimistic);
+
+
+template <typename M, typename Key>
+bool test_sequential(std::mt19937& g, std::size_t shards, Key key)
+{
+    for (int range : {10, 1000, 100'000})
+    {
+        M t(shards);
+        std::unordered_map<decltype(key(0)), decltype(key(0))> m;
+        for (int step = 0; step < 200'000; ++step)
+        {
+            auto x = key(static_cast<int>(g() % range));
+            auto v = key(static_cast<int>(g() % 1000));
+            if (g() % 3 != 0)
+            {
+                auto p = t.insert_or_get(x, v);
+                auto q = m.emplace(x, v);
+                if (p.second != q.second || p.first != q.first->second) return false;
+            }
+            else if (t.erase(x) != (m.erase(x) == 1))
+            {
+                return false;
+            }
+            auto y = t.find(x);
+            auto j = m.find(x);
+            if (y.has_value() != (j != m.end()) || (y.has_value() && *y != j->second)) return false;
+        }
+        if (t.size() != m.size()) return false;
+        for (int k = 0; k < range; ++k)
+        {
+            auto y = t.find(key(k));
+            auto j = m.find(key(k));
+            if (y.has_value() != (j != m.end()) || (y.has_value() && *y != j->second)) return false;
+        }
+    }
+    return true;
+}
+
+
+// The writers insert (x, 3 x) and erase x for x in a small range, the readers check every value found.
+bool test_readers_writers(std::size_t threads)
+{
+    map_type t(4);
+    constexpr std::int64_t range = 512;
+    std::atomic<bool> stop{false};
+    std::atomic<bool> ok{true};
+    std::atomic<std::size_t> found{0};
+    std::vector<std::thread> workers;
+    for (std::size_t k = 0; k < threads; ++k)
+    {
+        workers.emplace_back([&, k]()
+        {
+            std::mt19937 g(static_cast<unsigned>(k));
+            if (k % 2 == 0)
+            {
+                for (int step = 0; step < 200'000; ++step)
+                {
+                    std::int64_t x = g() % range;
+                    if (g() % 2 == 0) t.insert_or_get(x, 3 * x);
+                    else t.erase(x);
+                }
+                stop = true;
+            }
+            else
+            {
+                std::size_t n = 0;
+                while (!stop)
+                {
+                    std::int64_t x = g() % range;
+                    auto y = t.find(x);
+                    if (y.has_value() && *y != 3 * x) ok = false;
+                    n += y.has_value();
+                }
+                found += n;
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    return ok && t.size() <= range;
+}
+
+
+std::int64_t collatz(std::int64_t x)
+{
+    std::int64_t n = 0;
+    for (; x != 1; ++n) x = x % 2 == 0 ? x / 2 : 3 * x + 1;
+    return n;
+}
+
+
+bool test_memo(std::size_t threads)
+{
+    map_type memo;
+    std::atomic<bool> ok{true};
+    std::vector<std::thread> workers;
+    for (std::size_t k = 0; k < threads; ++k)
+    {
+        workers.emplace_back([&, k]()
+        {
+            std::mt19937 g(static_cast<unsigned>(100 + k));
+            for (int step = 0; step < 100'000; ++step)
+            {
+                std::int64_t x = 1 + g() % 20'000;
+                if (memo.get_or_compute(x, collatz) != collatz(x)) ok = false;
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    return ok && memo.size() <= 20'000;
+}
+
+
+struct locked_map
+{
+    std::mutex mutex;
+    std::unordered_map<std::int64_t, std::int64_t> m;
+
+    bool find(std::int64_t x)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return m.find(x) != m.end();
+    }
+
+    void insert(std::int64_t x)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        m.emplace(x, x);
+    }
+
+    void erase(std::int64_t x)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        m.erase(x);
+    }
+};
+
+
+// Millions of operations per second of threads doing 90% finds, 5% insertions and 5% erasures
+// of keys in [0, range).
+template <typename Find, typename Insert, typename Erase>
+double throughput(std::size_t threads, std::size_t operations, std::int64_t range, Find find, Insert insert, Erase erase)
+{
+    std::atomic<std::size_t> found{0};
+    double ms = time_ms([&]()
+    {
+        std::vector<std::thread> workers;
+        for (std::size_t k = 0; k < threads; ++k)
+        {
+            workers.emplace_back([&, k]()
+            {
+                std::mt19937_64 g(k);
+                std::size_t n = 0;
+                for (std::size_t i = 0; i < operations / threads; ++i)
+                {
+                    std::uint64_t r = g();
+                    std::int64_t x = static_cast<std::int64_t>(r % range);
+                    unsigned p = static_cast<unsigned>(r >> 54) % 100;
+                    if (p < 90) n += find(x);
+                    else if (p < 95) insert(x);
+                    else erase(x);
+                }
+                found += n;
+            });
+        }
+        for (std::thread& w : workers) w.join();
+    });
+    return found > 0 ? double(operations) / ms / 1000.0 : 0.0;
+}
+
+
+void bench()
+{
+    constexpr std::size_t operations = 8'000'000;
+    constexpr std::int64_t range = 1 << 20;
+    std::size_t cores = std::thread::hardware_concurrency();
+    std::cout << "throughput, 90% finds, " << range << " keys, " << cores << " cores, millions of operations per second" << std::endl;
+    for (std::size_t threads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        map_type t;
+        locked_map u;
+        for (std::int64_t x = 0; x < range; x += 2)
+        {
+            t.insert_or_get(x, x);
+            u.insert(x);
+        }
+        double a = throughput(threads, operations, range,
+                              [&](std::int64_t x) { return t.find(x).has_value(); },
+                              [&](std::int64_t x) { t.insert_or_get(x, x); },
+                              [&](std::int64_t x) { t.erase(x); });
+        double b = throughput(threads, operations, range,
+                              [&](std::int64_t x) { return u.find(x); },
+                              [&](std::int64_t x) { u.insert(x); },
+                              [&](std::int64_t x) { u.erase(x); });
+        std::cout << "    " << threads << " threads: concurrent map " << a << ", locked std::unordered_map " << b << std::endl;
+    }
+}
+
+
+int main()
+{
+    std::mt19937 g(31);
+
+    bool ok = test_sequential<map_type>(g, 1, [](int x) { return std::int64_t{x}; }) &&
+              test_sequential<map_type>(g, 64, [](int x) { return std::int64_t{x}; }) &&
+              test_sequential<string_map>(g, 16, [](int x) { return std::to_string(x); }) &&
+              test_readers_writers(4) && test_memo(8);
+    if (ok) bench();
+    std::cout << (ok ? "concurrent hash map: ok" : "concurrent hash map: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
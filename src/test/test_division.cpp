@@ -0,0 +1,127 @@
+// Check the quotients and the remainders of Remainder against / and % for 32 and 64 bit, signed
+// and unsigned integers, including quotients that don't fit in an int (60351427375 / 4), and of
+// Divider for the divisors 1, the powers of 2, max - 1, max and random divisors.
+
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+#include "../division.hpp"
+
+
+static_assert(std::same_as<eop::quotient_type_t<std::int64_t>, std::int64_t>);
+static_assert(std::same_as<eop::quotient_type_t<std::uint32_t>, std::uint32_t>);
+
+
+template <typename T>
+bool check_quotient_remainder(T a, T b)
+{
+    auto p = eop::Remainder::quotient_remainder_nonnegative(a, b);
+    auto q = eop::Remainder::quotient_remainder_nonnegative_iterative(a, b);
+    return p.first == a / b && p.second == a % b && q.first == a / b && q.second == a % b &&
+           eop::Remainder::remainder_nonnegative(a, b) == a % b &&
+           eop::Remainder::remainder_nonnegative_iterative(a, b) == a % b;
+}
+
+
+// a is nonnegative, b is positive with a random number of bits, so the quotients have any size.
+template <typename T>
+bool test_random(std::mt19937_64& g)
+{
+    constexpr T max = std::numeric_limits<T>::max();
+    constexpr int bits = std::numeric_limits<T>::digits;
+    for (int step = 0; step < 200'000; ++step)
+    {
+        T a = static_cast<T>(g() & max);
+        T b = static_cast<T>(g() & max) >> (g() % bits);
+        if (b == 0) b = 1;
+        if (!check_quotient_remainder(a, b)) return false;
+    }
+    // The edges.
+    for (T a : {T{0}, T{1}, T{2}, T(max - 1), max})
+    {
+        for (T b : {T{1}, T{2}, T{3}, T(max / 2), T(max - 1), max})
+        {
+            if (!check_quotient_remainder(a, b)) return false;
+        }
+    }
+    // Small quotients for slow_quotient.
+    for (int step = 0; step < 10'000; ++step)
+    {
+        T b = static_cast<T>(g() & max) >> (g() % 4 + 1);
+        if (b == 0) b = 1;
+        T a = static_cast<T>(b * T(g() % 2) + static_cast<T>(g() % b));
+        if (eop::Remainder::slow_quotient(a, b) != a / b || eop::Remainder::slow_remainder(a, b) != a % b) return false;
+    }
+    return true;
+}
+
+
+bool test_large_quotient()
+{
+    std::int64_t a = 60'351'427'375;
+    auto p = eop::Remainder::quotient_remainder_nonnegative(a, std::int64_t{4});
+    auto q = eop::Remainder::quotient_remainder_nonnegative_iterative(std::uint64_t(a), std::uint64_t{4});
+    return p.first == 15'087'856'843 && p.second == 3 && q.first == 15'087'856'843 && q.second == 3;
+}
+
+
+template <typename T>
+bool check_divider(T d, std::mt19937_64& g)
+{
+    constexpr T max = std::numeric_limits<T>::max();
+    eop::Divider<T> x(d);
+    auto check = [&](T n)
+    {
+        auto p = x.quotient_remainder(n);
+        return n / x == n / d && n % x == n % d && p.first == n / d && p.second == n % d;
+    };
+    for (T n : {T{0}, T{1}, T(d - 1), d, T(d + 1), T(2 * d), T(max - 1), max})
+    {
+        if (!check(n)) return false;
+    }
+    for (int step = 0; step < 1000; ++step)
+    {
+        // Numerators of any size, and near the multiples of d.
+        T n = static_cast<T>(g()) >> (g() % std::numeric_limits<T>::digits);
+        T k = d == 1 ? static_cast<T>(g()) : static_cast<T>(g()) % (max / d + 1);
+        if (!check(n) || !check(static_cast<T>(k * d)) || !check(static_cast<T>(k * d - 1))) return false;
+    }
+    return true;
+}
+
+
+template <typename T>
+bool test_divider(std::mt19937_64& g)
+{
+    constexpr T max = std::numeric_limits<T>::max();
+    bool ok = check_divider(T{1}, g) && check_divider(T{3}, g) && check_divider(T{7}, g) &&
+              check_divider(T(max - 1), g) && check_divider(max, g) && check_divider(T(max / 2), g) &&
+              check_divider(T(max / 2 + 1), g);
+    for (int k = 1; k < std::numeric_limits<T>::digits; ++k)
+    {
+        ok = ok && check_divider(T(T{1} << k), g) && check_divider(T((T{1} << k) + 1), g) &&
+             check_divider(T((T{1} << k) - 1), g);
+    }
+    for (int step = 0; step < 2000 && ok; ++step)
+    {
+        T d = static_cast<T>(g()) >> (g() % std::numeric_limits<T>::digits);
+        ok = check_divider(d == 0 ? T{1} : d, g);
+    }
+    return ok;
+}
+
+
+int main()
+{
+    std::mt19937_64 g(34);
+
+    bool ok = test_large_quotient() && test_random<std::int32_t>(g) && test_random<std::uint32_t>(g) &&
+              test_random<std::int64_t>(g) && test_random<std::uint64_t>(g) &&
+              test_divider<std::uint32_t>(g) && test_divider<std::uint64_t>(g);
+    std::cout << (ok ? "division: ok" : "division: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+// Check gcd_batch and remainder_batch against GCD::stein_gcd, std::gcd and % for 32 and 64 bit,
+// signed and unsigned elements: every length from 0 to 40 and 1003 (not multiples of the lanes),
+// with zeros, equal operands, powers of 2, the largest values and random values of any size. The
+// elements after the range are not written.
+
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../division_batch.hpp"
+
+
+template <typename T>
+T random_element(std::mt19937_64& g)
+{
+    constexpr T max = std::numeric_limits<T>::max();
+    switch (g() % 8)
+    {
+    case 0: return T{0};
+    case 1: return max;
+    case 2: return static_cast<T>(T{1} << (g() % std::numeric_limits<T>::digits));
+    case 3: return static_cast<T>(g() % 16);
+    default: return static_cast<T>(static_cast<T>(g()) & max) >> (g() % std::numeric_limits<T>::digits);
+    }
+}
+
+
+template <typename T>
+bool check(std::size_t n, std::mt19937_64& g)
+{
+    constexpr T sentinel = T{17};
+    std::vector<T> a(n);
+    std::vector<T> b(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = random_element<T>(g);
+        // Equal operands, and operands that differ only in the lowest bit.
+        switch (g() % 6)
+        {
+        case 0: b[i] = a[i]; break;
+        case 1: b[i] = static_cast<T>(a[i] & ~T{1}); break;
+        default: b[i] = random_element<T>(g); break;
+        }
+    }
+    std::vector<T> out(n + 1, sentinel);
+    eop::DivisionBatch::gcd_batch(a.data(), b.data(), n, out.data());
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (out[i] != eop::GCD::stein_gcd(a[i], b[i]) || out[i] != std::gcd(a[i], b[i])) return false;
+    }
+    if (out[n] != sentinel) return false;
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (b[i] == 0) b[i] = 1;
+    }
+    out.assign(n + 1, sentinel);
+    eop::DivisionBatch::remainder_batch(a.data(), b.data(), n, out.data());
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (out[i] != a[i] % b[i]) return false;
+    }
+    return out[n] == sentinel;
+}
+
+
+template <typename T>
+bool test_type(std::mt19937_64& g)
+{
+    for (int k = 0; k < 50; ++k)
+    {
+        for (std::size_t n = 0; n <= 40; ++n)
+        {
+            if (!check<T>(n, g)) return false;
+        }
+        if (!check<T>(1003, g)) return false;
+    }
+    return true;
+}
+
+
+int main()
+{
+    std::mt19937_64 g(33);
+
+    bool ok = test_type<std::uint32_t>(g) && test_type<std::uint64_t>(g) && test_type<std::int32_t>(g) &&
+              test_type<std::int64_t>(g);
+    std::cout << (ok ? "division batch: ok" : "division batch: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// Check GCD::extended_gcd: d = gcd(a, b) (std::gcd) and a x + b y == d computed without overflow,
+// with |x| <= b / d and |y| <= a / d, for 32 and 64 bits and BigInteger: zero arguments, a == b,
+// one dividing the other, consecutive Fibonacci numbers, shared factors and random values.
+// Check BigIntegerGCD::lehmer_gcd against GCD::fast_subtractive_gcd and extended_gcd on
+// BigIntegers of 1 to 12 limbs with a known gcd of 1 to 6 limbs, a single limb b, zero, a == b,
+// b dividing a, powers of 2 and consecutive Fibonacci numbers.
+
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include "../big_integer.hpp"
+#include "../big_integer_gcd.hpp"
+#include "../division.hpp"
+
+
+using eop::BigInteger;
+using eop::GCD;
+
+
+template <typename I>
+bool check_extended(I a, I b)
+{
+    auto e = GCD::extended_gcd(a, b);
+    I d = e.first;
+    I x = e.second;
+    I y = e.third;
+    if (d != std::gcd(a, b)) return false;
+    if (static_cast<__int128>(a) * x + static_cast<__int128>(b) * y != d) return false;
+    if (d == I{0}) return x == I{1} && y == I{0};
+    // The coefficients of the Euclidean algorithm are the smallest, of opposite signs.
+    auto abs = [](I z) { return z < I{0} ? -z : z; };
+    return abs(x) <= std::max(I{1}, b / d) && abs(y) <= std::max(I{1}, a / d) && !(x > I{0} && y > I{0});
+}
+
+
+template <typename I>
+bool test_extended(std::mt19937_64& g)
+{
+    constexpr I max = std::numeric_limits<I>::max();
+    for (I a : {I{0}, I{1}, I{2}, I{12}, max - 1, max})
+    {
+        for (I b : {I{0}, I{1}, I{2}, I{18}, max - 1, max})
+        {
+            if (!check_extended(a, b)) return false;
+        }
+    }
+    // Consecutive Fibonacci numbers: the longest sequences of quotients.
+    I f0 = 0;
+    I f1 = 1;
+    while (f1 <= max - f0)
+    {
+        if (!check_extended(f1, f0) || !check_extended(f0, f1)) return false;
+        I f = f0 + f1;
+        f0 = f1;
+        f1 = f;
+    }
+    for (int k = 0; k < 100'000; ++k)
+    {
+        I a = static_cast<I>(g() & static_cast<std::uint64_t>(max)) >> (g() % std::numeric_limits<I>::digits);
+        I b = static_cast<I>(g() & static_cast<std::uint64_t>(max)) >> (g() % std::numeric_limits<I>::digits);
+        if (!check_extended(a, b) || !check_extended(a, a) || !check_extended(a, I{0}) || !check_extended(I{0}, b)) return false;
+        // A shared factor, and one dividing the other.
+        I c = static_cast<I>(1 + g() % 1000);
+        if (a <= max / c && b <= max / c && !check_extended(static_cast<I>(a * c), static_cast<I>(b * c))) return false;
+        if (a <= max / c && !check_extended(static_cast<I>(a * c), a)) return false;
+    }
+    return true;
+}
+
+
+BigInteger random_big(std::mt19937_64& g, std::size_t limbs)
+{
+    BigInteger r;
+    for (std::size_t i = 0; i < limbs; ++i) r = (r << 64) + BigInteger{g()};
+    return r;
+}
+
+
+// The gcd of lehmer_gcd, of fast_subtractive_gcd and of extended_gcd with its coefficients.
+bool check_big(const BigInteger& a, const BigInteger& b)
+{
+    BigInteger d = eop::BigIntegerGCD::lehmer_gcd(a, b);
+    if (d != GCD::fast_subtractive_gcd(a, b) || d != eop::BigIntegerGCD::lehmer_gcd(b, a)) return false;
+    auto e = GCD::extended_gcd(a, b);
+    return e.first == d && a * e.second + b * e.third == d;
+}
+
+
+bool test_big(std::mt19937_64& g)
+{
+    // Consecutive Fibonacci numbers up to about 2^700.
+    BigInteger f0{0};
+    BigInteger f1{1};
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (i % 50 == 0 && !check_big(f1, f0)) return false;
+        BigInteger f = f0 + f1;
+        f0 = f1;
+        f1 = f;
+    }
+    if (!check_big(f1, f0) || eop::BigIntegerGCD::lehmer_gcd(f1, f0) != BigInteger{1}) return false;
+
+    for (int k = 0; k < 300; ++k)
+    {
+        // A known gcd c: a = c u and b = c v with u and v coprime.
+        BigInteger c = random_big(g, 1 + g() % 6);
+        if (c.is_zero()) c = BigInteger{1};
+        BigInteger u = random_big(g, 1 + g() % 6);
+        BigInteger v = random_big(g, 1 + g() % 6);
+        BigInteger w = eop::BigIntegerGCD::lehmer_gcd(u, v);
+        if (!w.is_zero())
+        {
+            u = u / w;
+            v = v / w;
+        }
+        BigInteger a = c * u;
+        BigInteger b = c * v;
+        if (!check_big(a, b)) return false;
+        if (!u.is_zero() && !v.is_zero() && eop::BigIntegerGCD::lehmer_gcd(a, b) != c) return false;
+
+        // A single limb b, zero, a == b, b dividing a and powers of 2.
+        BigInteger s{g() | 1};
+        if (!check_big(a, s) || !check_big(a, BigInteger{g() % 4}) || !check_big(a, BigInteger{0})) return false;
+        if (!check_big(a, a) || !check_big(a * b, b) || !check_big(c, c * s)) return false;
+        int i = static_cast<int>(g() % 700);
+        int j = static_cast<int>(g() % 700);
+        BigInteger p = (BigInteger{1} << i) * s;
+        BigInteger q = BigInteger{1} << j;
+        if (!check_big(p, q) || eop::BigIntegerGCD::lehmer_gcd(p, q) != (BigInteger{1} << std::min(i, j))) return false;
+    }
+    return true;
+}
+
+
+int main()
+{
+    std::mt19937_64 g(32);
+
+    bool ok = test_extended<std::int32_t>(g) && test_extended<std::int64_t>(g) && test_big(g);
+    std::cout << (ok ? "gcd: ok" : "gcd: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+// Check HashSet and HashMap against std::unordered_map under random insertions and erasures, with
+// a good hash and with a hash of 4 values (long probe sequences, deleted slots), string keys,
+// reserve, the iteration and the lookups in a constant table. Time the lookups of present and
+// absent keys against a binary search in a sorted Vector and std::unordered_map.
+
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../hash_table.hpp"
+#include "bench.hpp"
+
+
+using map_type = eop::HashMap<std::int64_t, std::int64_t>;
+
+static_assert(eop::forward_iterator<map_type::iterator>);
+static_assert(eop::forward_iterator<eop::HashSet<int>::iterator>);
+static_assert(eop::forward_iterator<map_type::const_iterator>);
+static_assert(std::is_same_v<decltype(std::declval<map_type::const_iterator>().value()), const std::int64_t&>);
+static_assert(std::is_convertible_v<map_type::iterator, map_type::const_iterator>);
+static_assert(!std::is_convertible_v<map_type::const_iterator, map_type::iterator>);
+
+
+struct bad_hash
+{
+    std::size_t operator()(std::int64_t x) const
+    {
+        return static_cast<std::size_t>(x & 3);
+    }
+};
+
+
+template <typename T, typename M>
+bool same_elements(const T& t, const M& m)
+{
+    if (t.size() != m.size()) return false;
+    std::size_t k = 0;
+    for (auto i = t.begin(); i != t.end(); ++i, ++k)
+    {
+        auto j = m.find(i.key());
+        if (j == m.end() || j->second != i.value() || (*i).second != j->second) return false;
+    }
+    return k == m.size();
+}
+
+
+template <typename H>
+bool test_random(std::mt19937& g)
+{
+    for (std::int64_t range : {10, 1000, 100'000})
+    {
+        eop::HashMap<std::int64_t, std::int64_t, H> t;
+        std::unordered_map<std::int64_t, std::int64_t> m;
+        std::size_t steps = std::is_same_v<H, bad_hash> && range > 1000 ? 20'000 : 200'000;
+        for (std::size_t step = 0; step < steps; ++step)
+        {
+            std::int64_t x = static_cast<std::int64_t>(g() % range) - range / 2;
+            if (g() % 3 != 0)
+            {
+                auto p = t.insert(x, 2 * x);
+                if (p.second != m.emplace(x, 2 * x).second || p.first.key() != x) return false;
+                t[x] += 1;
+                m[x] += 1;
+            }
+            else if (t.erase(x) != (m.erase(x) == 1))
+            {
+                return false;
+            }
+            if (step % 20'000 == 0 && !same_elements(t, m)) return false;
+        }
+        if (!same_elements(t, m)) return false;
+        // The lookups in a constant table, and its iterators compared with the others.
+        const auto& c = t;
+        for (std::int64_t x = -range / 2 - 2; x < range / 2 + 2; x += 1 + range / 1000)
+        {
+            if (c.contains(x) != (m.count(x) == 1)) return false;
+            auto i = c.find(x);
+            if (i != t.find(x) || (i != c.end() && (i.key() != x || i.value() != m[x]))) return false;
+        }
+        if (c.begin() != t.begin() || t.end() != c.end()) return false;
+        // At most 7/8 full.
+        if (8 * t.size() > 7 * t.capacity()) return false;
+        while (!t.empty()) t.erase(t.begin());
+        if (t.begin() != t.end()) return false;
+    }
+    return true;
+}
+
+
+bool test_strings(std::mt19937& g)
+{
+    eop::HashSet<std::string> t;
+    std::unordered_set<std::string> s;
+    for (int step = 0; step < 50'000; ++step)
+    {
+        std::string x = "key " + std::to_string(g() % 5000);
+        if (g() % 3 != 0)
+        {
+            if (t.insert(x).second != s.insert(x).second) return false;
+        }
+        else if (t.erase(x) != (s.erase(x) == 1))
+        {
+            return false;
+        }
+    }
+    std::size_t k = 0;
+    for (auto i = t.begin(); i != t.end(); ++i, ++k)
+    {
+        if (s.count(*i) != 1) return false;
+    }
+    return k == s.size() && t.size() == s.size();
+}
+
+
+bool test_reserve()
+{
+    eop::HashSet<int> t;
+    t.reserve(1000);
+    std::size_t c = t.capacity();
+    for (int x = 0; x < 1000; ++x) t.insert(x);
+    bool ok = t.capacity() == c && t.size() == 1000;
+    // Erasures and insertions of other keys don't grow the table.
+    for (int x = 1000; x < 100'000; ++x)
+    {
+        t.erase(x - 1000);
+        t.insert(x);
+    }
+    ok = ok && t.capacity() == c && t.size() == 1000 && t.contains(99'999) && !t.contains(98'999);
+    t.clear();
+    return ok && t.empty() && t.begin() == t.end() && !t.contains(0);
+}
+
+
+bool bench(std::mt19937_64& g)
+{
+    constexpr std::size_t n = 1'000'000;
+    constexpr std::size_t lookups = 10'000'000;
+    std::vector<std::int64_t> keys(n);
+    for (auto& x : keys) x = static_cast<std::int64_t>(g());
+    std::vector<std::int64_t> present(lookups);
+    std::vector<std::int64_t> absent(lookups);
+    for (auto& x : present) x = keys[g() % n];
+    for (auto& x : absent) x = static_cast<std::int64_t>(g());
+
+    map_type t;
+    std::unordered_map<std::int64_t, std::int64_t> u;
+    eop::Vector<std::int64_t> v;
+    std::cout << "build, " << n << " random keys" << std::endl;
+    std::cout << "    hash map: " << time_ms([&]() { for (auto x : keys) t.insert(x, x); }) << " ms" << std::endl;
+    std::cout << "    std::unordered_map: " << time_ms([&]() { for (auto x : keys) u.emplace(x, x); }) << " ms" << std::endl;
+    std::cout << "    sorted Vector: " << time_ms([&]() {
+        for (auto x : keys) v.emplace_back(x);
+        std::sort(v.raw_data(), v.raw_data() + v.size());
+    }) << " ms" << std::endl;
+
+    std::size_t found_table = 0;
+    std::size_t found_unordered = 0;
+    std::size_t found_vector = 0;
+    for (const auto* name : {"present", "absent"})
+    {
+        const std::vector<std::int64_t>& q = name[0] == 'p' ? present : absent;
+        std::cout << "lookups, " << lookups << " " << name << " keys" << std::endl;
+        std::cout << "    hash map: " << time_ms([&]() { for (auto x : q) found_table += t.contains(x); }) << " ms" << std::endl;
+        std::cout << "    std::unordered_map: " << time_ms([&]() { for (auto x : q) found_unordered += u.count(x); }) << " ms" << std::endl;
+        std::cout << "    sorted Vector: " << time_ms([&]() {
+            for (auto x : q) found_vector += std::binary_search(v.raw_data(), v.raw_data() + v.size(), x);
+        }) << " ms" << std::endl;
+    }
+    return found_table == found_unordered && found_vector == found_table && found_table >= lookups;
+}
+
+
+int main()
+{
+    std::mt19937 g(29);
+    std::mt19937_64 g64(29);
+
+    bool ok = test_random<std::hash<std::int64_t>>(g) && test_random<bad_hash>(g) && test_strings(g) &&
+              test_reserve() && bench(g64);
+    std::cout << (ok ? "hash table: ok" : "hash table: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+// Check the implicit trees against the traversals of bifurcate_coordinates.hpp, the van Emde Boas
+// positions, and time root to leaf searches in a binary search tree stored breadth first and in the
+// van Emde Boas layout.
+
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../bifurcate_coordinates.hpp"
+#include "../implicit_tree.hpp"
+#include "bench.hpp"
+
+
+static_assert(eop::bidirectional_bifurcate<eop::ImplicitTreeCoordinate<int>>);
+static_assert(eop::bidirectional_bifurcate<eop::VanEmdeBoasCoordinate<int>>);
+
+
+// The positions of the perfect tree of height h are a permutation of [0, 2^h - 1).
+constexpr
+bool is_permutation(int h)
+{
+    std::size_t n = (std::size_t{1} << h) - 1;
+    std::vector<bool> seen(n, false);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        std::size_t p = eop::van_emde_boas_position(i, h);
+        if (p >= n || seen[p]) return false;
+        seen[p] = true;
+    }
+    return true;
+}
+
+static_assert(is_permutation(1) && is_permutation(2) && is_permutation(3) && is_permutation(4) && is_permutation(7));
+// Height 4: the top tree of height 2 (0, 1, 2), then the 4 bottom trees of height 2.
+static_assert(eop::van_emde_boas_position(3, 4) == 3 && eop::van_emde_boas_position(7, 4) == 4 &&
+              eop::van_emde_boas_position(8, 4) == 5 && eop::van_emde_boas_position(5, 4) == 9);
+
+
+// Appends the values in pre order.
+template <typename C>
+struct pre_order
+{
+    std::vector<int>* values;
+
+    int operator()(eop::visit v, C c)
+    {
+        if (v == eop::visit::pre) values->push_back(*c);
+        return 0;
+    }
+};
+
+
+bool test_traversals()
+{
+    using namespace eop;
+
+    for (int n = 0; n < 300; ++n)
+    {
+        Vector<int> v;
+        for (int i = 0; i < n; ++i) v.emplace_back(i);
+        ImplicitTreeCoordinate<int> c(v);
+        VanEmdeBoasTree<int> t(v);
+        VanEmdeBoasCoordinate<int> d = t.root();
+
+        std::size_t h = static_cast<std::size_t>(std::bit_width(static_cast<unsigned>(n)));
+        if (weight(c) != std::size_t(n) || weight(d) != std::size_t(n)) return false;
+        if (height(c) != h || height(d) != h || height_recursive(c) != h) return false;
+        if (n == 0)
+        {
+            if (!c.empty() || !d.empty()) return false;
+            continue;
+        }
+
+        std::vector<int> a;
+        std::vector<int> b;
+        traverse(c, pre_order<ImplicitTreeCoordinate<int>>{&a});
+        traverse(d, pre_order<VanEmdeBoasCoordinate<int>>{&b});
+        if (a != b || a.size() != std::size_t(n)) return false;
+    }
+    return true;
+}
+
+
+// The in order values of the tree are increasing: the breadth first array is filled by an in
+// order traversal.
+template <typename C>
+struct fill_in_order
+{
+    std::vector<std::uint32_t>* values;
+    std::uint32_t* next;
+
+    int operator()(eop::visit v, C c)
+    {
+        if (v == eop::visit::in) (*values)[c.index()] = (*next)++;
+        return 0;
+    }
+};
+
+
+// Sum of the values in pre order.
+template <typename C>
+struct sum
+{
+    std::uint64_t total = 0;
+
+    int operator()(eop::visit v, C c)
+    {
+        if (v == eop::visit::pre) total += *c;
+        return 0;
+    }
+};
+
+
+// Number of keys found, descending from the root.
+template <typename C>
+std::size_t search(C root, const std::vector<std::uint32_t>& keys)
+{
+    std::size_t found = 0;
+    for (std::uint32_t k : keys)
+    {
+        C c = root;
+        while (true)
+        {
+            std::uint32_t x = *c;
+            if (x == k)
+            {
+                ++found;
+                break;
+            }
+            if (k < x)
+            {
+                if (!c.has_left_successor()) break;
+                c = c.left_successor();
+            }
+            else
+            {
+                if (!c.has_right_successor()) break;
+                c = c.right_successor();
+            }
+        }
+    }
+    return found;
+}
+
+
+bool bench_search()
+{
+    using namespace eop;
+
+    const std::size_t n = (std::size_t{1} << 24) - 1;
+    std::vector<std::uint32_t> values(n);
+    std::uint32_t next = 0;
+    Vector<std::uint32_t> shape;
+    shape.resize(n);
+    traverse(ImplicitTreeCoordinate<std::uint32_t>(shape), fill_in_order<ImplicitTreeCoordinate<std::uint32_t>>{&values, &next});
+    Vector<std::uint32_t> v;
+    v.reserve(n);
+    for (std::uint32_t x : values) v.emplace_back(x);
+    VanEmdeBoasTree<std::uint32_t> t(v);
+
+    std::mt19937 g(3);
+    std::vector<std::uint32_t> keys(1 << 20);
+    for (std::uint32_t& k : keys) k = static_cast<std::uint32_t>(g() % n);
+
+    std::size_t found_bfs = 0;
+    std::size_t found_veb = 0;
+    double t_bfs = time_ms([&]() { found_bfs = search(ImplicitTreeCoordinate<std::uint32_t>(v), keys); });
+    double t_veb = time_ms([&]() { found_veb = search(t.root(), keys); });
+    std::cout << "search, " << n << " nodes, " << keys.size() << " keys" << std::endl;
+    std::cout << "    breadth first: " << t_bfs << " ms" << std::endl;
+    std::cout << "    van Emde Boas: " << t_veb << " ms" << std::endl;
+
+    using bfs = ImplicitTreeCoordinate<std::uint32_t>;
+    using veb = VanEmdeBoasCoordinate<std::uint32_t>;
+    sum<bfs> s_bfs;
+    sum<veb> s_veb;
+    t_bfs = time_ms([&]() { s_bfs = traverse(bfs(v), sum<bfs>{}); });
+    t_veb = time_ms([&]() { s_veb = traverse(t.root(), sum<veb>{}); });
+    std::cout << "traverse, " << n << " nodes" << std::endl;
+    std::cout << "    breadth first: " << t_bfs << " ms" << std::endl;
+    std::cout << "    van Emde Boas: " << t_veb << " ms" << std::endl;
+    return found_bfs == keys.size() && found_veb == keys.size() && s_bfs.total == s_veb.total;
+}
+
+
+int main()
+{
+    bool ok = test_traversals() && bench_search();
+    std::cout << (ok ? "implicit tree: ok" : "implicit tree: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+// Check kitamasa, matrix_power and evaluate_many of LinearRecurrence against the recurrence
+// computed term by term, for K = 1, 2, 3, 8, 13 and 40 (one block, several and partial blocks of
+// the matrix product), without modulus (modulo 2^64) and with the moduli 10^9 + 7 and 2^64 - 59
+// (the sums overflow), for n < K, for every n up to a few K and for random n.
+
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../fibonacci.hpp"
+#include "../linear_recurrence.hpp"
+
+
+using u64 = std::uint64_t;
+
+
+// a(0), ..., a(n_max) by the definition.
+template <std::size_t K>
+std::vector<u64> brute_force(const eop::LinearRecurrence<K, u64>& r, std::size_t n_max)
+{
+    auto reduce = [&r](unsigned __int128 x) { return r.modulus == 0 ? static_cast<u64>(x) : static_cast<u64>(x % r.modulus); };
+    std::vector<u64> a(r.a.begin(), r.a.end());
+    for (std::size_t n = K; n <= n_max; ++n)
+    {
+        unsigned __int128 s = 0;
+        for (std::size_t j = 0; j < K; ++j)
+        {
+            s = reduce(s + reduce(static_cast<unsigned __int128>(r.c[j]) * a[n - 1 - j]));
+        }
+        a.push_back(static_cast<u64>(s));
+    }
+    return a;
+}
+
+
+template <std::size_t K>
+bool check(u64 modulus, std::mt19937_64& g)
+{
+    eop::LinearRecurrence<K, u64> r;
+    r.modulus = modulus;
+    for (std::size_t j = 0; j < K; ++j)
+    {
+        r.c[j] = modulus == 0 ? g() : g() % modulus;
+        r.a[j] = modulus == 0 ? g() : g() % modulus;
+    }
+    // Some coefficients at the edges.
+    if (modulus != 0) r.c[K - 1] = modulus - 1;
+    if (K > 1) r.c[0] = 0;
+
+    constexpr std::size_t n_max = 3000;
+    std::vector<u64> a = brute_force(r, n_max);
+    for (std::size_t n = 0; n <= n_max; n = n < 4 * K + 64 ? n + 1 : n + 1 + g() % 97)
+    {
+        if (r.kitamasa(n) != a[n]) return false;
+        if (K <= 13 && r.matrix_power(n) != a[n]) return false;
+    }
+    if (K == 40 && (r.matrix_power(n_max) != a[n_max] || r.matrix_power(K) != a[K] || r.matrix_power(K - 1) != a[K - 1])) return false;
+
+    // evaluate_many with the indices in any order, repeated, below K and 0.
+    std::vector<u64> ns{0, K - 1, K, K + 1, n_max, 1, 2 * K, n_max, 1024, 1023};
+    for (int k = 0; k < 100; ++k) ns.push_back(g() % (n_max + 1));
+    std::vector<u64> out(ns.size());
+    if (r.evaluate_many(ns.data(), ns.data() + ns.size(), out.data()) != out.data() + out.size()) return false;
+    for (std::size_t i = 0; i < ns.size(); ++i)
+    {
+        if (out[i] != a[ns[i]]) return false;
+    }
+    // All the indices below K: no squares are computed.
+    std::vector<u64> small{0, K - 1};
+    r.evaluate_many(small.data(), small.data() + 2, out.data());
+    if (out[0] != a[0] || out[1] != a[K - 1]) return false;
+    // The largest indices, kitamasa and evaluate_many agree.
+    u64 n = ~u64{0} - g() % 1000;
+    r.evaluate_many(&n, &n + 1, out.data());
+    return out[0] == r.kitamasa(n) && (K > 13 || r.matrix_power(n) == out[0]);
+}
+
+
+template <std::size_t ...K>
+bool check_orders(std::mt19937_64& g)
+{
+    constexpr u64 p = 1'000'000'007;
+    constexpr u64 q = ~u64{0} - 58;
+    return ((check<K>(0, g) && check<K>(p, g) && check<K>(q, g)) && ...);
+}
+
+
+// Fibonacci: K = 2, c = {1, 1}.
+bool test_fibonacci()
+{
+    eop::LinearRecurrence<2, u64> r{{1, 1}, {0, 1}};
+    for (u64 n = 0; n < 94; ++n)
+    {
+        if (r.kitamasa(n) != eop::Fib::fibonacci(n) || r.matrix_power(n) != eop::Fib::fibonacci(n)) return false;
+    }
+    return r.kitamasa(93) == 12'200'160'415'121'876'738ull;
+}
+
+
+int main()
+{
+    std::mt19937_64 g(30);
+
+    bool ok = test_fibonacci() && check_orders<1, 2, 3, 8, 13, 40>(g);
+    std::cout << (ok ? "linear recurrence: ok" : "linear recurrence: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
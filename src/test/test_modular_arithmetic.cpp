@@ -0,0 +1,134 @@
+// Check Montgomery, MontgomeryMultiply<U> and ModularMultiply<m> against the product and the
+// remainder of unsigned __int128: the inverse, the conversions, the products and the powers (with
+// power and power_many) for random odd moduli near 2^32 and 2^64 and for the edge moduli 3,
+// 2^32 - 1, 2^32 + 1, 2^63 + 1, 2^64 - 59 and 2^64 - 1. For 128 bits: the same moduli, and
+// Fermat's little theorem for the prime 2^127 - 1.
+
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+#include "../associative_operations.hpp"
+#include "../modular_arithmetic.hpp"
+
+
+using u64 = std::uint64_t;
+using u128 = unsigned __int128;
+
+
+u64 multiply_mod(u64 a, u64 b, u64 m)
+{
+    return static_cast<u64>(static_cast<u128>(a) * b % m);
+}
+
+
+u64 power_mod(u64 a, u64 n, u64 m)
+{
+    u64 r = 1 % m;
+    for (; n != 0; n = n / 2)
+    {
+        if (n % 2 == 1) r = multiply_mod(r, a, m);
+        a = multiply_mod(a, a, m);
+    }
+    return r;
+}
+
+
+// Op is MontgomeryMultiply<U> or ModularMultiply<m> for a modulus m < 2^64. The operands are
+// 0, 1, m - 1, m / 2 and random.
+template <typename U, typename Op>
+bool check_modulus(const Op& op, u64 m, std::mt19937_64& g)
+{
+    if (static_cast<U>(m * eop::Montgomery::inverse(U{m})) != U{1}) return false;
+    if (op.from_montgomery(op.identity()) != U{1}) return false;
+    std::array<u64, 5> edges{0, 1, m - 1, m / 2, g() % m};
+    for (int step = 0; step < 2000; ++step)
+    {
+        u64 a = step < 25 ? edges[step % 5] : g() % m;
+        u64 b = step < 25 ? edges[step / 5] : g() % m;
+        U x = op.to_montgomery(U{a});
+        U y = op.to_montgomery(U{b});
+        if (x >= m || op.from_montgomery(x) != U{a}) return false;
+        if (op.from_montgomery(op(x, y)) != U{multiply_mod(a, b, m)}) return false;
+        if (step % 20 != 0) continue;
+
+        u64 n = g() >> (g() % 64);
+        if (n == 0) n = 1;
+        U p = eop::AssociativeOp::power(x, n, op);
+        if (op.from_montgomery(p) != U{power_mod(a, n, m)}) return false;
+        std::array<U, 3> many = eop::AssociativeOp::power_many(std::array<U, 3>{x, y, x}, n, op);
+        if (many[0] != p || many[2] != p || op.from_montgomery(many[1]) != U{power_mod(b, n, m)}) return false;
+    }
+    return true;
+}
+
+
+template <typename U>
+bool check_runtime_modulus(u64 m, std::mt19937_64& g)
+{
+    return check_modulus<U>(eop::MontgomeryMultiply<U>{U{m}}, m, g);
+}
+
+
+bool test_runtime_moduli(std::mt19937_64& g)
+{
+    constexpr u64 two_32 = u64{1} << 32;
+    for (u64 m : {u64{3}, two_32 - 1, two_32 + 1, (u64{1} << 63) + 1, ~u64{0} - 58, ~u64{0}})
+    {
+        if (!check_runtime_modulus<u64>(m, g) || !check_runtime_modulus<u128>(m, g)) return false;
+    }
+    for (int step = 0; step < 200; ++step)
+    {
+        // Within 2^20 of 2^32, and within 2^40 of 2^64.
+        u64 near_32 = (two_32 + (g() % (u64{1} << 21)) - (u64{1} << 20)) | 1;
+        u64 near_64 = (~u64{0} - g() % (u64{1} << 40)) | 1;
+        if (!check_runtime_modulus<u64>(near_32, g) || !check_runtime_modulus<u64>(near_64, g)) return false;
+        if (step % 10 == 0 && (!check_runtime_modulus<u128>(near_32, g) || !check_runtime_modulus<u128>(near_64, g))) return false;
+    }
+    return true;
+}
+
+
+template <u64 ...m>
+bool check_compile_time_moduli(std::mt19937_64& g)
+{
+    return (check_modulus<u64>(eop::ModularMultiply<m>{}, m, g) && ...);
+}
+
+
+// a^(p - 1) = 1 mod p for the prime p = 2^127 - 1, and the product of 128 bit values is associative.
+bool test_128_bits(std::mt19937_64& g)
+{
+    constexpr u128 p = (u128{1} << 127) - 1;
+    eop::MontgomeryMultiply<u128> op{p};
+    for (int step = 0; step < 50; ++step)
+    {
+        u128 a = ((static_cast<u128>(g()) << 64) | g()) % p;
+        u128 b = ((static_cast<u128>(g()) << 64) | g()) % p;
+        u128 c = ((static_cast<u128>(g()) << 64) | g()) % p;
+        if (a == 0) a = 1;
+        u128 x = op.to_montgomery(a);
+        u128 y = op.to_montgomery(b);
+        u128 z = op.to_montgomery(c);
+        if (op.from_montgomery(x) != a || op(op(x, y), z) != op(x, op(y, z))) return false;
+        // p - 1 = 2 (2^63 - 1) (2^63 + 1), the exponents fit in 64 bits.
+        u128 f = eop::AssociativeOp::power(eop::AssociativeOp::power(op(x, x), (u64{1} << 63) - 1, op), (u64{1} << 63) + 1, op);
+        if (op.from_montgomery(f) != 1) return false;
+    }
+    return true;
+}
+
+
+int main()
+{
+    std::mt19937_64 g(29);
+
+    bool ok = test_runtime_moduli(g) &&
+              check_compile_time_moduli<3, (u64{1} << 32) - 1, (u64{1} << 32) + 1, (u64{1} << 32) + 15,
+                                        (u64{1} << 63) + 1, ~u64{0} - 58, ~u64{0}>(g) &&
+              test_128_bits(g);
+    std::cout << (ok ? "modular arithmetic: ok" : "modular arithmetic: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
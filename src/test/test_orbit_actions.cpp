@@ -0,0 +1,285 @@
+// Check OrbitAct against OrbitTrf and against the orbit walked by brute force: collision point,
+// terminating, circular, connection point, orbit structure, intersect and convergent point
+// guarded, for terminating and non terminating orbits, with and without scratch states. The maps
+// are handles with cycles of every shape up to 12 + 12, lines ending at a terminal point and
+// random maps (total and partial) on up to 2000 points.
+
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../orbit_transformations.hpp"
+#include "../orbit_actions.hpp"
+
+
+// The orbit is driven by v, the payload is a function of v: an action writes the whole state.
+struct State
+{
+    int v = 0;
+    std::array<std::uint64_t, 8> payload{};
+
+    friend
+    bool operator==(const State&, const State&) = default;
+};
+
+
+State make_state(int v)
+{
+    State s;
+    s.v = v;
+    for (std::size_t i = 0; i < s.payload.size(); ++i)
+    {
+        s.payload[i] = static_cast<std::uint64_t>(v) * 0x9e3779b97f4a7c15ull + i;
+    }
+    return s;
+}
+
+
+// The map under test: v -> next[v], defined where defined[v].
+std::vector<int> next;
+std::vector<bool> defined;
+
+
+auto trf = [](State s) -> State { return make_state(next[s.v]); };
+auto act = [](State& s) -> void { s = make_state(next[s.v]); };
+auto p = [](State s) -> bool { return defined[s.v]; };
+
+
+struct Orbit
+{
+    bool terminating;
+    std::size_t m;
+    std::size_t n;
+    int connection;
+};
+
+
+// Walk the orbit of v until it reaches the terminal point or a point already visited.
+Orbit brute_force(int v)
+{
+    std::vector<std::size_t> seen(next.size(), ~std::size_t{0});
+    std::size_t i = 0;
+    while (defined[v] && seen[v] == ~std::size_t{0})
+    {
+        seen[v] = i++;
+        v = next[v];
+    }
+    if (!defined[v]) return {true, i, 0, v};
+    return {false, seen[v], i - seen[v] - 1, v};
+}
+
+
+bool reachable(int from, int to)
+{
+    for (std::size_t i = 0; i <= next.size(); ++i)
+    {
+        if (from == to) return true;
+        if (!defined[from]) return false;
+        from = next[from];
+    }
+    return false;
+}
+
+
+bool check_one(int a)
+{
+    using namespace eop;
+
+    const State x = make_state(a);
+    const Orbit o = brute_force(a);
+    State y;
+    State slow;
+
+    State t = x;
+    if (OrbitAct::terminating(t, act, p) != o.terminating || OrbitTrf::terminating(x, trf, p) != o.terminating) return false;
+    if (OrbitAct::circular(x, act, p) != OrbitTrf::circular(x, trf, p)) return false;
+    if (OrbitAct::circular(x, act, p, y, slow) != (!o.terminating && o.m == 0)) return false;
+
+    t = x;
+    OrbitAct::collision_point(t, act, p);
+    if (t != OrbitTrf::collision_point(x, trf, p)) return false;
+    t = x;
+    OrbitAct::collision_point(t, act, p, slow);
+    if (t != OrbitTrf::collision_point(x, trf, p)) return false;
+
+    t = x;
+    OrbitAct::connection_point(t, act, p);
+    if (t != OrbitTrf::connection_point(x, trf, p) || t != make_state(o.connection)) return false;
+    t = x;
+    OrbitAct::connection_point(t, act, p, y, slow);
+    if (t != make_state(o.connection)) return false;
+
+    auto r = OrbitTrf::orbit_structure(x, trf, p);
+    t = x;
+    auto s = OrbitAct::orbit_structure(t, act, p);
+    if (s.first != r.first || s.second != r.second || t != r.third) return false;
+    t = x;
+    s = OrbitAct::orbit_structure(t, act, p, y, slow);
+    if (s.first != o.m || s.second != o.n || t != make_state(o.connection)) return false;
+
+    t = x;
+    State u = make_state(o.connection);
+    if (OrbitAct::distance(t, u, act) != o.m || t != u) return false;
+
+    if (o.terminating) return true;
+
+    t = x;
+    OrbitAct::collision_point_nonterminating_orbit(t, act);
+    if (t != OrbitTrf::collision_point_nonterminating_orbit(x, trf)) return false;
+    t = x;
+    OrbitAct::collision_point_nonterminating_orbit(t, act, slow);
+    if (t != OrbitTrf::collision_point_nonterminating_orbit(x, trf)) return false;
+
+    if (OrbitAct::circular_nonterminating_orbit(x, act) != OrbitTrf::circular_nonterminating_orbit(x, trf)) return false;
+    if (OrbitAct::circular_nonterminating_orbit(x, act, y, slow) != (o.m == 0)) return false;
+
+    t = x;
+    OrbitAct::connection_point_nonterminating_orbit(t, act);
+    if (t != OrbitTrf::connection_point_nonterminating_orbit(x, trf)) return false;
+    t = x;
+    OrbitAct::connection_point_nonterminating_orbit(t, act, y, slow);
+    if (t != make_state(o.connection)) return false;
+
+    r = OrbitTrf::orbit_structure_nonterminating_orbit(x, trf);
+    t = x;
+    s = OrbitAct::orbit_structure_nonterminating_orbit(t, act);
+    if (s.first != r.first || s.second != r.second || t != r.third) return false;
+    t = x;
+    s = OrbitAct::orbit_structure_nonterminating_orbit(t, act, y, slow);
+    return s.first == o.m && s.second == o.n && t == make_state(o.connection);
+}
+
+
+bool check_pair(int a, int b)
+{
+    using namespace eop;
+
+    const State x0 = make_state(a);
+    const State x1 = make_state(b);
+    State y;
+    State slow;
+    State z;
+
+    // Intersect: the results and the collision points left in the arguments.
+    State s0 = x0;
+    State s1 = x1;
+    bool i = OrbitTrf::intersect(x0, x1, trf, p, p);
+    if (OrbitAct::intersect(s0, s1, act, p, p) != i) return false;
+    if (s0 != OrbitTrf::collision_point(x0, trf, p) || s1 != OrbitTrf::collision_point(x1, trf, p)) return false;
+    s0 = x0;
+    s1 = x1;
+    if (OrbitAct::intersect(s0, s1, act, p, p, y, slow) != i) return false;
+    // Both orbits are non terminating and share the cycle.
+    const Orbit o0 = brute_force(a);
+    const Orbit o1 = brute_force(b);
+    if (i != (!o0.terminating && !o1.terminating && reachable(b, o0.connection))) return false;
+
+    if (!o0.terminating && !o1.terminating)
+    {
+        i = OrbitTrf::intersect_nonterminating_orbit(x0, x1, trf);
+        s0 = x0;
+        s1 = x1;
+        if (OrbitAct::intersect_nonterminating_orbit(s0, s1, act) != i) return false;
+        if (s0 != OrbitTrf::collision_point_nonterminating_orbit(x0, trf)) return false;
+        s0 = x0;
+        s1 = x1;
+        if (OrbitAct::intersect_nonterminating_orbit(s0, s1, act, y, slow) != i) return false;
+    }
+
+    // A common point: the connection point of the first orbit, when reachable from the second.
+    const State c = make_state(o0.connection);
+    if (!reachable(b, o0.connection)) return true;
+    State e = OrbitTrf::convergent_point_guarded(x0, x1, c, trf);
+    s0 = x0;
+    s1 = x1;
+    OrbitAct::convergent_point_guarded(s0, s1, c, act);
+    if (s0 != e || s1 != e) return false;
+    s0 = x0;
+    s1 = x1;
+    OrbitAct::convergent_point_guarded(s0, s1, c, act, z);
+    return s0 == e && s1 == e && reachable(e.v, o0.connection);
+}
+
+
+// Handle of h points and cycle of c points: 0 -> 1 -> ... -> h + c - 1 -> h.
+bool test_handle_cycle()
+{
+    for (int h = 0; h <= 12; ++h)
+    {
+        for (int c = 1; c <= 12; ++c)
+        {
+            next.assign(h + c, 0);
+            defined.assign(h + c, true);
+            for (int v = 0; v < h + c; ++v) next[v] = v + 1 < h + c ? v + 1 : h;
+
+            const Orbit o = brute_force(0);
+            if (o.terminating || o.m != std::size_t(h) || o.n != std::size_t(c - 1) || o.connection != h) return false;
+            for (int a = 0; a < h + c; ++a)
+            {
+                if (!check_one(a)) return false;
+                for (int b = 0; b < h + c; ++b)
+                {
+                    if (!check_pair(a, b)) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+// Line of l + 1 points ending at the terminal point l.
+bool test_line()
+{
+    for (int l = 0; l <= 20; ++l)
+    {
+        next.assign(l + 1, l);
+        defined.assign(l + 1, true);
+        for (int v = 0; v < l; ++v) next[v] = v + 1;
+        defined[l] = false;
+
+        const Orbit o = brute_force(0);
+        if (!o.terminating || o.m != std::size_t(l) || o.n != 0 || o.connection != l) return false;
+        for (int a = 0; a <= l; ++a)
+        {
+            if (!check_one(a) || !check_pair(a, l) || !check_pair(0, a)) return false;
+        }
+    }
+    return true;
+}
+
+
+bool test_random(std::mt19937& g)
+{
+    for (int k = 0; k < 200; ++k)
+    {
+        const int n = 1 + g() % (k < 100 ? 30 : 2000);
+        // A third of the maps are total, the others have a few terminal points.
+        const int undefined = k % 3 == 0 ? 0 : 1 + g() % 4;
+        next.assign(n, 0);
+        defined.assign(n, true);
+        for (int& v : next) v = g() % n;
+        for (int j = 0; j < undefined; ++j) defined[g() % n] = false;
+
+        for (int j = 0; j < 20; ++j)
+        {
+            const int a = g() % n;
+            const int b = g() % 2 == 0 ? next[a] : int(g() % n);
+            if (!check_one(a) || !check_pair(a, b) || !check_pair(b, a)) return false;
+        }
+    }
+    return true;
+}
+
+
+int main()
+{
+    std::mt19937 g(26);
+
+    bool ok = test_handle_cycle() && test_line() && test_random(g);
+    std::cout << (ok ? "orbit actions: ok" : "orbit actions: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// Check parallel_reduce_tree against reduce_tree_nonempty with a non commutative operation on random
+// trees, parallel_for_each_tree, the exceptions of WorkStealingPool, and time the reduction of a
+// complete tree with 1 thread, 4 threads and the threads of the machine.
+
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../implicit_tree.hpp"
+#include "../parallel_bifurcate.hpp"
+#include "../pooled_tree.hpp"
+#include "bench.hpp"
+
+
+using tree = eop::PooledTree<std::uint64_t>;
+using coordinate = tree::coordinate;
+
+// 2x2 matrices modulo 2^64: the product is associative, not commutative.
+using matrix = std::array<std::uint64_t, 4>;
+
+
+matrix node_matrix(coordinate c)
+{
+    return {1, *c, c.index(), 1};
+}
+
+
+matrix product(matrix a, matrix b)
+{
+    return {a[0] * b[0] + a[1] * b[2], a[0] * b[1] + a[1] * b[3],
+            a[2] * b[0] + a[3] * b[2], a[2] * b[1] + a[3] * b[3]};
+}
+
+
+// A random tree of n nodes: each node is added as a missing successor of a random node.
+tree random_tree(std::size_t n, std::mt19937_64& g)
+{
+    tree t;
+    std::vector<coordinate> nodes;
+    nodes.push_back(t.make_root(g()));
+    while (nodes.size() < n)
+    {
+        coordinate c = nodes[g() % nodes.size()];
+        if (g() % 2 == 0 && !c.has_left_successor()) nodes.push_back(t.insert_left(c, g()));
+        else if (!c.has_right_successor()) nodes.push_back(t.insert_right(c, g()));
+    }
+    return t;
+}
+
+
+bool test_reduce(std::mt19937_64& g)
+{
+    using namespace eop;
+
+    WorkStealingPool pool(4);
+    auto fun = node_matrix;
+    auto op = product;
+    for (std::size_t n : {1, 2, 3, 10, 100, 10'000, 100'000})
+    {
+        tree t = random_tree(n, g);
+        matrix serial = reduce_tree_nonempty(t.root(), fun, op);
+        for (int grain_depth : {0, 1, 2, 5, 20})
+        {
+            if (parallel_reduce_tree(t.root(), fun, op, grain_depth, pool) != serial) return false;
+        }
+        if (parallel_reduce_tree(t.root(), fun, op) != serial) return false;
+
+        std::atomic<std::uint64_t> sum = 0;
+        std::atomic<std::size_t> count = 0;
+        auto proc = [&](coordinate c) { sum += *c; ++count; return 0; };
+        parallel_for_each_tree(t.root(), proc, 6, pool);
+        std::uint64_t expected = 0;
+        for (std::size_t i = 0; i < n; ++i) expected += t.nodes()[static_cast<std::uint32_t>(i)].value;
+        if (sum != expected || count != n) return false;
+    }
+    return true;
+}
+
+
+bool test_exceptions()
+{
+    eop::WorkStealingPool pool(2);
+    int caught = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        try
+        {
+            pool.invoke([]() {}, [i]() { if (i % 2 == 0) throw std::runtime_error("g"); });
+        }
+        catch (const std::runtime_error&)
+        {
+            ++caught;
+        }
+    }
+    return caught == 50;
+}
+
+
+bool bench()
+{
+    using namespace eop;
+    using C = ImplicitTreeCoordinate<std::uint64_t>;
+
+    const std::size_t n = std::size_t{1} << 25;
+    Vector<std::uint64_t> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) v.emplace_back(i * 0x9e3779b97f4a7c15);
+    auto fun = [](C c) { return *c * *c + c.index(); };
+    auto op = [](std::uint64_t a, std::uint64_t b) { return a + b; };
+
+    std::uint64_t serial = 0;
+    std::cout << "reduce, " << n << " nodes" << std::endl;
+    std::cout << "    serial: " << time_ms([&]() { serial = reduce_tree_nonempty(C(v), fun, op); }) << " ms" << std::endl;
+    bool ok = true;
+    for (std::size_t threads : {std::size_t{1}, std::size_t{4}, WorkStealingPool::default_threads()})
+    {
+        WorkStealingPool pool(threads);
+        std::uint64_t x = 0;
+        double t = time_ms([&]() { x = parallel_reduce_tree(C(v), fun, op, default_grain_depth(pool), pool); });
+        std::cout << "    " << threads << " threads: " << t << " ms" << std::endl;
+        ok = ok && x == serial;
+    }
+    return ok;
+}
+
+
+int main()
+{
+    std::mt19937_64 g(7);
+
+    bool ok = test_reduce(g) && test_exceptions() && bench();
+    std::cout << (ok ? "parallel bifurcate: ok" : "parallel bifurcate: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// Check PooledTree with the traversals of bifurcate_coordinates.hpp on random binary search trees
+// and on a degenerate tree, the reuse of the erased nodes and the moves (the moved-from trees are
+// empty and usable), and compare the time to build and traverse a tree with a tree of nodes
+// allocated by new and linked by pointers.
+
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../bifurcate_coordinates.hpp"
+#include "../pooled_tree.hpp"
+#include "bench.hpp"
+
+
+using tree = eop::PooledTree<std::uint32_t>;
+using coordinate = tree::coordinate;
+
+static_assert(eop::bidirectional_bifurcate<coordinate>);
+static_assert(sizeof(eop::NodePool<std::uint32_t>::node) == 16);
+
+
+void insert(tree& t, std::uint32_t x)
+{
+    if (t.empty())
+    {
+        t.make_root(x);
+        return;
+    }
+    coordinate c = t.root();
+    while (true)
+    {
+        if (x < *c)
+        {
+            if (!c.has_left_successor())
+            {
+                t.insert_left(c, x);
+                return;
+            }
+            c = c.left_successor();
+        }
+        else
+        {
+            if (!c.has_right_successor())
+            {
+                t.insert_right(c, x);
+                return;
+            }
+            c = c.right_successor();
+        }
+    }
+}
+
+
+struct in_order
+{
+    std::vector<std::uint32_t>* values;
+
+    int operator()(eop::visit v, coordinate c)
+    {
+        if (v == eop::visit::in) values->push_back(*c);
+        return 0;
+    }
+};
+
+
+bool test_random(std::mt19937& g)
+{
+    using namespace eop;
+
+    tree t;
+    std::vector<std::uint32_t> keys(100'000);
+    for (std::uint32_t& k : keys) k = g();
+    for (std::uint32_t k : keys) insert(t, k);
+
+    std::vector<std::uint32_t> values;
+    traverse(t.root(), in_order{&values});
+    std::vector<std::uint32_t> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    if (values != sorted || t.size() != keys.size()) return false;
+    if (weight(t.root()) != keys.size() || weight_recursive(t.root()) != keys.size()) return false;
+    if (height(t.root()) != height_recursive(t.root())) return false;
+
+    // Erase the subtrees of the successors of the root, then insert again: the nodes are reused.
+    std::size_t chunks = t.nodes().number_of_chunks();
+    coordinate r = t.root();
+    if (r.has_left_successor()) t.erase(r.left_successor());
+    if (r.has_right_successor()) t.erase(r.right_successor());
+    if (t.size() != 1 || weight(t.root()) != 1) return false;
+    for (std::uint32_t k : keys) insert(t, k);
+    if (t.size() != keys.size() + 1 || t.nodes().number_of_chunks() != chunks) return false;
+
+    t.erase(t.root());
+    if (!t.empty() || t.size() != 0) return false;
+    insert(t, 1);
+    t.clear();
+    return t.empty() && t.nodes().number_of_chunks() == 0;
+}
+
+
+bool test_degenerate()
+{
+    using namespace eop;
+
+    tree t;
+    coordinate c = t.make_root(0u);
+    for (std::uint32_t i = 1; i < 1'000'000; ++i)
+    {
+        c = i % 2 == 1 ? t.insert_left(c, i) : t.insert_right(c, i);
+    }
+    bool ok = weight(t.root()) == 1'000'000 && height(t.root()) == 1'000'000;
+    t.erase(t.root());
+    return ok && t.size() == 0;
+}
+
+
+// The moved-to tree has the nodes and the coordinates stay valid, the moved-from tree is empty and
+// usable.
+bool test_move(std::mt19937& g)
+{
+    using namespace eop;
+
+    tree t;
+    std::vector<std::uint32_t> keys(1000);
+    for (std::uint32_t& k : keys) k = g();
+    for (std::uint32_t k : keys) insert(t, k);
+    std::sort(keys.begin(), keys.end());
+    coordinate r = t.root();
+    std::uint32_t x = *r;
+
+    tree u(std::move(t));
+    std::vector<std::uint32_t> values;
+    traverse(u.root(), in_order{&values});
+    if (values != keys || u.size() != keys.size() || u.root() != r || *r != x) return false;
+    if (!t.empty() || t.size() != 0 || !t.root().empty()) return false;
+    insert(t, 2);
+    insert(t, 1);
+    if (t.size() != 2 || *t.root() != 2 || *t.root().left_successor() != 1) return false;
+
+    tree v;
+    insert(v, 7);
+    v = std::move(u);
+    if (v.size() != keys.size() || v.root() != r || *r != x) return false;
+    if (!u.empty() || u.size() != 0 || !u.root().empty()) return false;
+    insert(u, 5);
+    if (u.size() != 1 || *u.root() != 5) return false;
+
+    // Moved back and forth, and to itself through a reference.
+    u = std::move(t);
+    t = std::move(v);
+    tree& w = t;
+    t = std::move(w);
+    return t.size() == keys.size() && t.root() == r && u.size() == 2 && v.empty() && v.size() == 0;
+}
+
+
+struct pointer_node
+{
+    std::uint32_t value;
+    pointer_node* left = nullptr;
+    pointer_node* right = nullptr;
+    pointer_node* parent = nullptr;
+};
+
+
+void insert(pointer_node*& root, std::uint32_t x)
+{
+    pointer_node* n = new pointer_node{x};
+    if (root == nullptr)
+    {
+        root = n;
+        return;
+    }
+    pointer_node* c = root;
+    while (true)
+    {
+        pointer_node*& next = x < c->value ? c->left : c->right;
+        if (next == nullptr)
+        {
+            next = n;
+            n->parent = c;
+            return;
+        }
+        c = next;
+    }
+}
+
+
+void destroy(pointer_node* n)
+{
+    if (n == nullptr) return;
+    destroy(n->left);
+    destroy(n->right);
+    delete n;
+}
+
+
+std::size_t pointer_weight(pointer_node* n)
+{
+    if (n == nullptr) return 0;
+    return pointer_weight(n->left) + pointer_weight(n->right) + 1;
+}
+
+
+bool bench(std::mt19937& g)
+{
+    std::vector<std::uint32_t> keys(1 << 22);
+    for (std::uint32_t& k : keys) k = g();
+
+    tree t;
+    pointer_node* p = nullptr;
+    std::size_t w_pooled = 0;
+    std::size_t w_pointer = 0;
+    std::cout << "random binary search tree, " << keys.size() << " nodes, node of " << sizeof(eop::NodePool<std::uint32_t>::node)
+              << " bytes (pointers: " << sizeof(pointer_node) << " + allocation)" << std::endl;
+    std::cout << "    pooled build: " << time_ms([&]() { for (std::uint32_t k : keys) insert(t, k); }) << " ms" << std::endl;
+    std::cout << "    pointer build: " << time_ms([&]() { for (std::uint32_t k : keys) insert(p, k); }) << " ms" << std::endl;
+    std::cout << "    pooled weight_recursive: " << time_ms([&]() { w_pooled = eop::weight_recursive(t.root()); }) << " ms" << std::endl;
+    std::cout << "    pointer weight: " << time_ms([&]() { w_pointer = pointer_weight(p); }) << " ms" << std::endl;
+    std::cout << "    pooled clear: " << time_ms([&]() { t.clear(); }) << " ms" << std::endl;
+    std::cout << "    pointer destroy: " << time_ms([&]() { destroy(p); }) << " ms" << std::endl;
+    return w_pooled == keys.size() && w_pointer == keys.size();
+}
+
+
+int main()
+{
+    std::mt19937 g(5);
+
+    bool ok = test_random(g) && test_degenerate() && test_move(g) && bench(g);
+    std::cout << (ok ? "pooled tree: ok" : "pooled tree: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+// Check the rank error of QuantileSketch on random and sorted streams, a sketch per thread merged
+// against a single sketch, the bound on the retained elements, and the time of push.
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../quantile_sketch.hpp"
+
+
+using sketch = eop::QuantileSketch<double, eop::less<double>>;
+
+
+// Largest |rank(quantile(q)) - q n| / n on the exact ranks of the sorted stream.
+double max_rank_error(const sketch& s, const std::vector<double>& sorted)
+{
+    double n = static_cast<double>(sorted.size());
+    double error = 0.0;
+    for (int i = 1; i < 100; ++i)
+    {
+        double q = i / 100.0;
+        double x = s.quantile(q);
+        double lower = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin());
+        double upper = static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), x) - sorted.begin());
+        double target = q * n;
+        double e = target < lower ? lower - target : (target > upper ? target - upper : 0.0);
+        error = std::max(error, e / n);
+
+        double r = static_cast<double>(s.rank(x));
+        error = std::max(error, std::abs(r - lower) / n);
+    }
+    return error;
+}
+
+
+bool test_single(std::mt19937_64& g)
+{
+    const std::size_t n = 1 << 22;
+    std::vector<double> a(n);
+    std::normal_distribution<double> d;
+    for (double& x : a) x = d(g);
+
+    sketch s;
+    auto start = std::chrono::steady_clock::now();
+    for (double x : a) s.push(x);
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / n;
+
+    std::vector<double> sorted = a;
+    std::sort(sorted.begin(), sorted.end());
+    double error = max_rank_error(s, sorted);
+    std::cout << "    random: " << ns << " ns/push, " << s.retained() << " retained, rank error " << error << std::endl;
+    if (s.minimum() != sorted.front() || s.maximum() != sorted.back()) return false;
+    if (s.count() != n || s.retained() > 4 * sketch::default_k) return false;
+
+    // Sorted input is the worst case of the deterministic compactors.
+    sketch t;
+    for (double x : sorted) t.push(x);
+    double error_sorted = max_rank_error(t, sorted);
+    std::cout << "    sorted: " << t.retained() << " retained, rank error " << error_sorted << std::endl;
+    return error < 0.02 && error_sorted < 0.02;
+}
+
+
+bool test_merge(std::mt19937_64& g)
+{
+    const std::size_t threads = 4;
+    const std::size_t n = 1 << 20;
+    std::vector<std::vector<double>> parts(threads, std::vector<double>(n));
+    std::exponential_distribution<double> d;
+    for (auto& part : parts)
+    {
+        for (double& x : part) x = d(g);
+    }
+
+    std::vector<sketch> sketches;
+    for (std::size_t i = 0; i < threads; ++i) sketches.emplace_back(sketch::default_k, eop::less<double>{}, g());
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back([&, i]() { for (double x : parts[i]) sketches[i].push(x); });
+    }
+    for (std::thread& w : workers) w.join();
+
+    sketch total;
+    for (const sketch& s : sketches) total.merge(s);
+
+    std::vector<double> sorted;
+    for (const auto& part : parts) sorted.insert(sorted.end(), part.begin(), part.end());
+    std::sort(sorted.begin(), sorted.end());
+    double error = max_rank_error(total, sorted);
+    std::cout << "    merged " << threads << " threads: " << total.retained() << " retained, rank error " << error << std::endl;
+    if (total.count() != threads * n || total.retained() > 4 * sketch::default_k) return false;
+    if (total.minimum() != sorted.front() || total.maximum() != sorted.back()) return false;
+
+    // Merge with itself doubles every weight.
+    sketch twice = total;
+    twice.merge(twice);
+    if (twice.count() != 2 * total.count()) return false;
+    return error < 0.02;
+}
+
+
+int main()
+{
+    std::mt19937_64 g(11);
+
+    std::cout << "quantile sketch, k = " << sketch::default_k << std::endl;
+    bool ok = test_single(g) && test_merge(g);
+    std::cout << (ok ? "quantile sketch: ok" : "quantile sketch: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
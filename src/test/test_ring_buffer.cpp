@@ -0,0 +1,221 @@
+// Check SpscRingBuffer and MpmcRingBuffer: the order and the completeness of the elements sent by
+// one producer to one consumer, one at a time and in batches, for_each and reduce of
+// algorithms.hpp on a readable range, and with 4 producers and 4 consumers the order of the
+// elements of each producer seen by each consumer. Time the messages per second.
+
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../algorithms.hpp"
+#include "../ring_buffer.hpp"
+#include "bench.hpp"
+
+
+static_assert(eop::forward_iterator<eop::RingIterator<int>>);
+
+
+bool test_spsc_sequential()
+{
+    eop::SpscRingBuffer<int> q(5);
+    bool ok = q.capacity() == 8;
+    for (int x = 0; x < 8; ++x) ok = ok && q.push(x);
+    ok = ok && !q.push(8) && q.size() == 8;
+    int y = -1;
+    ok = ok && q.pop(y) && y == 0;
+    ok = ok && q.push(8);
+
+    // The readable range wraps around the end of the array.
+    eop::RingRange<int> r = q.readable();
+    int sum = 0;
+    eop::for_each(r.begin(), r.end(), [&sum](int x) { sum += x; return 0; });
+    auto plus = [](std::int64_t a, std::int64_t b) { return a + b; };
+    auto widen = [](int x) { return static_cast<std::int64_t>(x); };
+    ok = ok && r.size() == 8 && sum == 36 && eop::reduce(r.begin(), r.end(), plus, widen, std::int64_t{0}) == 36;
+    q.consume(3);
+
+    std::vector<int> out(10);
+    ok = ok && q.pop_n(out.data(), 10) == 5 && out[0] == 4 && out[4] == 8 && !q.pop(y) && q.size() == 0;
+    std::vector<int> in{10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    ok = ok && q.push_n(in.data(), 10) == 8 && q.pop_n(out.data(), 2) == 2 && q.push_n(in.data() + 8, 2) == 2;
+    ok = ok && q.pop_n(out.data(), 10) == 8 && out[0] == 12 && out[7] == 19;
+    return ok;
+}
+
+
+// n integers in batches of at most b (b = 1: push and pop), the consumer checks the order.
+bool spsc(std::size_t n, std::size_t b, double& ms)
+{
+    eop::SpscRingBuffer<std::int64_t> q(1 << 14);
+    std::atomic<bool> ok{true};
+    ms = time_ms([&]()
+    {
+        std::thread producer([&]()
+        {
+            std::vector<std::int64_t> batch(b);
+            std::int64_t x = 0;
+            while (x < static_cast<std::int64_t>(n))
+            {
+                if (b == 1)
+                {
+                    while (!q.push(x)) std::this_thread::yield();
+                    ++x;
+                    continue;
+                }
+                std::size_t k = std::min<std::size_t>(b, n - static_cast<std::size_t>(x));
+                for (std::size_t i = 0; i < k; ++i) batch[i] = x + static_cast<std::int64_t>(i);
+                std::size_t sent = 0;
+                while (sent < k)
+                {
+                    std::size_t s = q.push_n(batch.data() + sent, k - sent);
+                    if (s == 0) std::this_thread::yield();
+                    sent += s;
+                }
+                x += static_cast<std::int64_t>(k);
+            }
+        });
+
+        std::int64_t expected = 0;
+        auto plus = [](std::int64_t a, std::int64_t c) { return a + c; };
+        auto identity = [](std::int64_t a) { return a; };
+        while (expected < static_cast<std::int64_t>(n))
+        {
+            if (b == 1)
+            {
+                std::int64_t y;
+                if (!q.pop(y))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (y != expected) ok = false;
+                ++expected;
+                continue;
+            }
+            eop::RingRange<std::int64_t> r = q.readable(b);
+            if (r.size() == 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            // The sum of consecutive integers from expected.
+            std::int64_t k = static_cast<std::int64_t>(r.size());
+            if (eop::reduce(r.begin(), r.end(), plus, identity, std::int64_t{0}) != k * expected + k * (k - 1) / 2) ok = false;
+            if (r.begin().source() != expected) ok = false;
+            q.consume(r.size());
+            expected += k;
+        }
+        producer.join();
+    });
+    return ok;
+}
+
+
+// producers threads send n / producers integers each, tagged with the producer in the high bits.
+// Each consumer checks that the integers of each producer are increasing.
+bool mpmc(std::size_t producers, std::size_t consumers, std::size_t n, std::size_t b, double& ms)
+{
+    eop::MpmcRingBuffer<std::uint64_t> q(1 << 14);
+    std::atomic<bool> ok{true};
+    std::atomic<std::size_t> received{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::size_t per_producer = n / producers;
+    ms = time_ms([&]()
+    {
+        std::vector<std::thread> threads;
+        for (std::size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]()
+            {
+                std::vector<std::uint64_t> batch(b);
+                std::size_t i = 0;
+                while (i < per_producer)
+                {
+                    std::size_t k = std::min(b, per_producer - i);
+                    for (std::size_t j = 0; j < k; ++j) batch[j] = (std::uint64_t{p} << 40) | (i + j);
+                    std::size_t sent = 0;
+                    while (sent < k)
+                    {
+                        std::size_t s = q.push_n(batch.data() + sent, k - sent);
+                        if (s == 0) std::this_thread::yield();
+                        sent += s;
+                    }
+                    i += k;
+                }
+            });
+        }
+        for (std::size_t c = 0; c < consumers; ++c)
+        {
+            threads.emplace_back([&]()
+            {
+                std::vector<std::uint64_t> last(producers, ~std::uint64_t{0});
+                std::vector<std::uint64_t> batch(b);
+                std::uint64_t s = 0;
+                while (received.load(std::memory_order_relaxed) < per_producer * producers)
+                {
+                    std::size_t k = q.pop_n(batch.data(), b);
+                    if (k == 0)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for (std::size_t j = 0; j < k; ++j)
+                    {
+                        std::uint64_t p = batch[j] >> 40;
+                        std::uint64_t x = batch[j] & ((std::uint64_t{1} << 40) - 1);
+                        if (last[p] != ~std::uint64_t{0} && x <= last[p]) ok = false;
+                        last[p] = x;
+                        s += x;
+                    }
+                    received += k;
+                }
+                sum += s;
+            });
+        }
+        for (std::thread& t : threads) t.join();
+    });
+    std::uint64_t m = per_producer;
+    return ok && received == per_producer * producers && sum == producers * (m * (m - 1) / 2);
+}
+
+
+bool test_mpmc_sequential()
+{
+    eop::MpmcRingBuffer<int> q(4);
+    bool ok = q.capacity() == 4;
+    std::vector<int> in{1, 2, 3, 4, 5, 6};
+    ok = ok && q.push_n(in.data(), 6) == 4 && !q.push(5);
+    int y = 0;
+    ok = ok && q.pop(y) && y == 1 && q.push(5);
+    std::vector<int> out(6);
+    ok = ok && q.pop_n(out.data(), 6) == 4 && out[0] == 2 && out[3] == 5 && !q.pop(y);
+    return ok;
+}
+
+
+int main()
+{
+    bool ok = test_spsc_sequential() && test_mpmc_sequential();
+
+    double ms = 0;
+    ok = ok && spsc(1'000'000, 1, ms) && spsc(1'000'003, 7, ms) && mpmc(4, 4, 400'000, 1, ms) && mpmc(3, 5, 600'000, 16, ms);
+
+    std::cout << "messages per second, one producer and one consumer, " << std::thread::hardware_concurrency() << " cores" << std::endl;
+    constexpr std::size_t n = 100'000'000;
+    for (std::size_t b : {1, 16, 256})
+    {
+        std::size_t m = b == 1 ? n / 4 : n;
+        ok = ok && spsc(m, b, ms);
+        std::cout << "    spsc, batches of " << b << ": " << double(m) / ms / 1000.0 << " million" << std::endl;
+        ok = ok && mpmc(1, 1, m, b, ms);
+        std::cout << "    mpmc, batches of " << b << ": " << double(m) / ms / 1000.0 << " million" << std::endl;
+    }
+    ok = ok && mpmc(4, 4, n / 4, 16, ms);
+    std::cout << "    mpmc, 4 producers and 4 consumers, batches of 16: " << double(n / 4) / ms / 1000.0 << " million" << std::endl;
+
+    std::cout << (ok ? "ring buffer: ok" : "ring buffer: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+// Check select_nth, partial_sort and TopK against a stable sort, on random data with many ties,
+// on the adversarial inputs of quickselect and on -0.0 and 0.0 (equivalent, not equal).
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../selection.hpp"
+
+
+static_assert(eop::equivalence_is_equality<eop::less<int>> && eop::equivalence_is_equality<eop::greater<unsigned char>>);
+static_assert(!eop::equivalence_is_equality<eop::less<double>> && !eop::equivalence_is_equality<eop::greater<float>>);
+
+
+struct element
+{
+    int key;
+    int index;
+
+    friend
+    bool operator==(const element&, const element&) = default;
+};
+
+
+constexpr auto key_less = [](const element& a, const element& b) -> bool
+{
+    return a.key < b.key;
+};
+
+
+std::vector<element> make_input(std::mt19937& g, int n, int keys)
+{
+    std::vector<element> a(n);
+    for (int i = 0; i < n; ++i) a[i] = element{static_cast<int>(g() % keys), i};
+    return a;
+}
+
+
+bool test_select_nth(std::mt19937& g)
+{
+    using namespace eop;
+
+    for (int n : {1, 2, 5, 16, 17, 100, 1000, 10000})
+    {
+        for (int keys : {1, 3, n})
+        {
+            std::vector<element> a = make_input(g, n, keys);
+            std::vector<element> sorted = a;
+            std::stable_sort(sorted.begin(), sorted.end(), key_less);
+
+            for (int k : {0, n / 3, n / 2, n - 1})
+            {
+                std::vector<element> b = a;
+                element* nth = Selection::select_nth(b.data(), b.data() + n, k, key_less);
+                if (!(*nth == sorted[k])) return false;
+                for (int i = 0; i < k; ++i)
+                {
+                    // Smaller rank: smaller key or same key and smaller index.
+                    if (key_less(*nth, b[i]) || (b[i].key == nth->key && b[i].index > nth->index)) return false;
+                }
+                for (int i = k + 1; i < n; ++i)
+                {
+                    if (key_less(b[i], *nth) || (b[i].key == nth->key && b[i].index < nth->index)) return false;
+                }
+
+                std::vector<element> c = a;
+                Selection::partial_sort(c.data(), c.data() + k + 1, c.data() + n, key_less);
+                if (!std::equal(c.begin(), c.begin() + k + 1, sorted.begin())) return false;
+            }
+            if (n <= 100)
+            {
+                std::vector<element> d(n);
+                Selection::rank_sort(a.data(), a.data() + n, d.data(), key_less);
+                if (d != sorted) return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+bool test_arithmetic(std::mt19937& g)
+{
+    using namespace eop;
+
+    // Organ pipe and sorted inputs, median of 3 killer: the median of medians fallback bounds the time.
+    const int n = 1 << 16;
+    std::vector<std::vector<int>> inputs(4, std::vector<int>(n));
+    for (int i = 0; i < n; ++i)
+    {
+        inputs[0][i] = i;
+        inputs[1][i] = n - i;
+        inputs[2][i] = i < n / 2 ? i : n - i;
+        inputs[3][i] = static_cast<int>(g() % 100);
+    }
+    for (auto& a : inputs)
+    {
+        std::vector<int> sorted = a;
+        std::sort(sorted.begin(), sorted.end());
+        for (int k : {0, n / 2, n * 99 / 100, n - 1})
+        {
+            std::vector<int> b = a;
+            if (*Selection::select_nth(b.data(), b.data() + n, k, less<int>{}) != sorted[k]) return false;
+        }
+        std::vector<int> c = a;
+        Selection::partial_sort(c.data(), c.data() + 100, c.data() + n, greater<int>{});
+        if (!std::equal(c.begin(), c.begin() + 100, sorted.rbegin())) return false;
+        std::vector<int> d = a;
+        Selection::introsort(d.data(), d.data() + n, less<int>{});
+        if (d != sorted) return false;
+    }
+    return true;
+}
+
+
+// -0.0 and 0.0 are equivalent under less<double>: the selection keeps the order of the stable sort,
+// seen in the signs.
+bool test_signed_zeros(std::mt19937& g)
+{
+    using namespace eop;
+
+    auto same = [](double x, double y) { return x == y && std::signbit(x) == std::signbit(y); };
+    for (int n : {2, 5, 17, 100, 1000})
+    {
+        std::vector<double> a(n);
+        for (double& x : a)
+        {
+            int v = static_cast<int>(g() % 5);
+            x = v == 0 ? -0.0 : v == 1 ? 0.0 : v - 3.0;
+        }
+        std::vector<double> sorted = a;
+        std::stable_sort(sorted.begin(), sorted.end(), less<double>{});
+        for (int k = 0; k < n; k = k + 1 + n / 20)
+        {
+            std::vector<double> b = a;
+            if (!same(*Selection::select_nth(b.data(), b.data() + n, k, less<double>{}), sorted[k])) return false;
+            std::vector<double> c = a;
+            Selection::partial_sort(c.data(), c.data() + k + 1, c.data() + n, less<double>{});
+            if (!std::equal(c.begin(), c.begin() + k + 1, sorted.begin(), same)) return false;
+        }
+    }
+    return true;
+}
+
+
+bool test_top_k(std::mt19937& g)
+{
+    using namespace eop;
+
+    std::vector<element> a = make_input(g, 10000, 50);
+    std::vector<element> sorted = a;
+    std::stable_sort(sorted.begin(), sorted.end(), key_less);
+
+    for (std::size_t k : {std::size_t{0}, std::size_t{1}, std::size_t{10}, std::size_t{1000}, std::size_t{20000}})
+    {
+        TopK<element, decltype(key_less)> top(k, key_less);
+        for (const element& x : a) top.push(x);
+        Vector<element> result = top.sorted();
+        std::size_t m = std::min(k, a.size());
+        if (result.size() != m) return false;
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            if (!(result[i] == sorted[i])) return false;
+        }
+    }
+    return true;
+}
+
+
+int main()
+{
+    std::mt19937 g(7);
+
+    bool ok = test_select_nth(g) && test_arithmetic(g) && test_signed_zeros(g) && test_top_k(g);
+    std::cout << (ok ? "selection: ok" : "selection: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
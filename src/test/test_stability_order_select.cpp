@@ -7,6 +7,7 @@
 
 #include "../type_concepts.hpp"
 #include "../linear_ordering.hpp"
+#include "selection_harness.hpp"
 
 
 template <typename T, size_t N> 
@@ -149,6 +150,34 @@ void test_select_5()
 }
 
 
+// Minimum worst case number of comparisons to select the element of rank k of n (Knuth 5.3.3):
+// V(0, n) = n - 1, V(1, 3) = 3, V(1, 4) = V(2, 4) = 4, V(2, 5) = 6.
+constexpr verification v_0_2 = verify_both<2, 0>(select_0_2);
+constexpr verification v_1_2 = verify_both<2, 1>(select_1_2);
+constexpr verification v_0_2_indexed = verify_both<2, 0>(select_0_2_indexed);
+constexpr verification v_1_2_indexed = verify_both<2, 1>(select_1_2_indexed);
+constexpr verification v_0_3 = verify_both<3, 0>(select_0_3);
+constexpr verification v_1_3 = verify_both<3, 1>(select_1_3);
+constexpr verification v_2_3 = verify_both<3, 2>(select_2_3);
+constexpr verification v_1_4 = verify_both<4, 1>(select_1_4);
+constexpr verification v_2_4 = verify_both<4, 2>(select_2_4);
+constexpr verification v_1_4_indexed = verify_both<4, 1>(select_1_4_indexed);
+constexpr verification v_2_5 = verify_both<5, 2>(median_5);
+
+static_assert(v_0_2.order && v_0_2.stable && v_0_2.max_comparisons == 1, "select_0_2");
+static_assert(v_1_2.order && v_1_2.stable && v_1_2.max_comparisons == 1, "select_1_2");
+static_assert(v_0_2_indexed.order && v_0_2_indexed.stable && v_0_2_indexed.max_comparisons == 1, "select_0_2<0, 1>");
+static_assert(v_1_2_indexed.order && v_1_2_indexed.stable && v_1_2_indexed.max_comparisons == 1, "select_1_2<0, 1>");
+static_assert(v_0_3.order && v_0_3.stable && v_0_3.max_comparisons == 2, "select_0_3");
+static_assert(v_1_3.order && v_1_3.stable && v_1_3.max_comparisons == 3, "select_1_3");
+static_assert(v_2_3.order && v_2_3.stable && v_2_3.max_comparisons == 2, "select_2_3");
+
+static_assert(v_1_4.order && v_1_4.stable && v_1_4.max_comparisons == 4, "select_1_4");
+static_assert(v_2_4.order && v_2_4.stable && v_2_4.max_comparisons == 4, "select_2_4");
+static_assert(v_1_4_indexed.order && v_1_4_indexed.stable && v_1_4_indexed.max_comparisons == 4, "select_1_4<0, 1, 2, 3>");
+static_assert(v_2_5.order && v_2_5.stable && v_2_5.max_comparisons == 6, "median_5");
+
+
 int main()
 {
     test_select_2();
@@ -0,0 +1,174 @@
+// Check that traverse_morris makes the visits of traverse_nonempty on random trees and restores the
+// links, also when the procedure throws, traverse a degenerate tree of 10^6 levels, and time it
+// against traverse_nonempty on a balanced tree.
+
+
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../bifurcate_coordinates.hpp"
+#include "bench.hpp"
+
+
+// Nodes without predecessor link.
+struct node
+{
+    node* left = nullptr;
+    node* right = nullptr;
+};
+
+
+struct coordinate
+{
+    using weight_type = std::size_t;
+
+    node* p = nullptr;
+
+    bool empty() const { return p == nullptr; }
+    bool has_left_successor() const { return p->left != nullptr; }
+    bool has_right_successor() const { return p->right != nullptr; }
+    coordinate left_successor() const { return {p->left}; }
+    coordinate right_successor() const { return {p->right}; }
+    void set_left_successor(coordinate c) const { p->left = c.p; }
+    void set_right_successor(coordinate c) const { p->right = c.p; }
+
+    friend
+    bool operator==(const coordinate&, const coordinate&) = default;
+};
+
+static_assert(eop::linked_bifurcate_coordinate<coordinate>);
+
+
+// Records the visits, throws at the visit number throw_at.
+struct recorder
+{
+    std::vector<std::pair<eop::visit, node*>>* visits;
+    std::size_t throw_at = std::size_t(-1);
+
+    int operator()(eop::visit v, coordinate c)
+    {
+        if (visits->size() == throw_at) throw std::runtime_error("visit");
+        visits->emplace_back(v, c.p);
+        return 0;
+    }
+};
+
+
+// A random tree of n nodes, nodes[0] is the root.
+std::vector<node> random_tree(std::size_t n, std::mt19937& g)
+{
+    std::vector<node> nodes(n);
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        while (true)
+        {
+            node& parent = nodes[g() % i];
+            node*& link = g() % 2 == 0 ? parent.left : parent.right;
+            if (link == nullptr)
+            {
+                link = &nodes[i];
+                break;
+            }
+        }
+    }
+    return nodes;
+}
+
+
+std::vector<std::pair<node*, node*>> links(const std::vector<node>& nodes)
+{
+    std::vector<std::pair<node*, node*>> l;
+    for (const node& x : nodes) l.emplace_back(x.left, x.right);
+    return l;
+}
+
+
+bool test_random(std::mt19937& g)
+{
+    for (std::size_t n : {1, 2, 3, 5, 10, 100, 1000, 100'000})
+    {
+        std::vector<node> nodes = random_tree(n, g);
+        std::vector<std::pair<node*, node*>> before = links(nodes);
+        coordinate root{nodes.data()};
+
+        std::vector<std::pair<eop::visit, node*>> expected;
+        std::vector<std::pair<eop::visit, node*>> visits;
+        (void)eop::traverse_nonempty(root, recorder{&expected});
+        eop::traverse_morris(root, recorder{&visits});
+        if (visits != expected || links(nodes) != before) return false;
+
+        visits.clear();
+        try
+        {
+            eop::traverse_morris(root, recorder{&visits, (3 * n) / 2});
+            return false;
+        }
+        catch (const std::runtime_error&)
+        {
+
+        }
+        if (links(nodes) != before) return false;
+    }
+    return true;
+}
+
+
+struct counter
+{
+    std::size_t visits = 0;
+    std::size_t pre = 0;
+
+    int operator()(eop::visit v, coordinate)
+    {
+        ++visits;
+        pre += v == eop::visit::pre;
+        return 0;
+    }
+};
+
+
+bool test_degenerate()
+{
+    const std::size_t n = 1'000'000;
+    std::vector<node> nodes(n);
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        (i % 2 == 1 ? nodes[i - 1].left : nodes[i - 1].right) = &nodes[i];
+    }
+    std::vector<std::pair<node*, node*>> before = links(nodes);
+    counter c = eop::traverse_morris(coordinate{nodes.data()}, counter{});
+    return c.visits == 3 * n && c.pre == n && links(nodes) == before;
+}
+
+
+bool bench()
+{
+    const std::size_t n = (std::size_t{1} << 20) - 1;
+    std::vector<node> nodes(n);
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        node& parent = nodes[(i - 1) / 2];
+        (i % 2 == 1 ? parent.left : parent.right) = &nodes[i];
+    }
+    coordinate root{nodes.data()};
+    counter a;
+    counter b;
+    std::cout << "balanced, " << n << " nodes" << std::endl;
+    std::cout << "    traverse_nonempty: " << time_ms([&]() { a = eop::traverse_nonempty(root, counter{}); }) << " ms" << std::endl;
+    std::cout << "    traverse_morris: " << time_ms([&]() { b = eop::traverse_morris(root, counter{}); }) << " ms" << std::endl;
+    return a.visits == b.visits && a.pre == b.pre;
+}
+
+
+int main()
+{
+    std::mt19937 g(11);
+
+    bool ok = test_random(g) && test_degenerate() && bench();
+    std::cout << (ok ? "traverse morris: ok" : "traverse morris: FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -21,11 +21,16 @@ namespace eop
     {
         Triple() = default;
 
+        constexpr
         Triple(const T1& f, const T2& s, const T3& t) : first(f), second(s), third(t)
         {
 
         }
 
+        // Implicitly constexpr when the members comparisons are.
+        friend
+        bool operator==(const Triple&, const Triple&) = default;
+
         T1 first;
         T2 second;
         T3 third;
@@ -21,6 +21,7 @@ I will use the standard library for basic concepts and type_traits to avoid to m
 
 */
 
+#include <concepts>
 #include <type_traits>
 #include "mpl.hpp"
 
@@ -81,7 +82,7 @@ namespace eop
 
     template <typename I>
         requires std::is_object_v<std::remove_cvref_t<typename I::distance_type>> 
-    struct distance_type
+    struct distance_type<I>
     {
         using type =  I::distance_type;
     };
@@ -105,7 +106,7 @@ namespace eop
 
     template <typename I>
         requires std::is_object_v<std::remove_cvref_t<typename I::weight_type>> 
-    struct weight_type
+    struct weight_type<I>
     {
         using type =  I::weight_type;
     };
@@ -126,6 +127,15 @@ namespace eop
         using type = int;
     };
 
+    // The quotient of two nonnegative integers of T is representable in T, an int overflows
+    // for 64 bit integers.
+    template <typename T>
+        requires std::integral<T>
+    struct quotient_type<T>
+    {
+        using type = T;
+    };
+
     template <typename T>
     using quotient_type_t = typename quotient_type<T>::type; 
 
@@ -28,6 +28,7 @@ TODO:
 #include <memory>
 #include <cstring>
 #include <cstddef>
+#include <algorithm>
 
 namespace eop
 {
@@ -331,7 +332,63 @@ namespace eop
         constexpr
         size_type capacity() const noexcept 
         {
-            return num_of_elements;
+            return max_capacity;
+        }
+
+
+        // Precondition: i < size().
+        constexpr
+        value_type& operator[](size_type i)
+        {
+            return data[i];
+        }
+
+        // Precondition: i < size().
+        constexpr
+        const value_type& operator[](size_type i) const
+        {
+            return data[i];
+        }
+
+
+        constexpr
+        value_type* raw_data() noexcept
+        {
+            return data.get();
+        }
+
+        constexpr
+        const value_type* raw_data() const noexcept
+        {
+            return data.get();
+        }
+
+
+        // The new elements are value initialized.
+        void resize(size_type new_size) requires default_constructible<T>
+        {
+            if (new_size > max_capacity)
+            {
+                allocate_and_move(new_size);
+            }
+            for (size_type i = num_of_elements; i < new_size; ++i)
+            {
+                data[i] = T{};
+            }
+            num_of_elements = new_size;
+        }
+
+
+        // Precondition: size() > 0.
+        void pop_back()
+        {
+            --num_of_elements;
+        }
+
+
+        void clear() noexcept
+        {
+            num_of_elements = 0;
         }
 
 
@@ -341,7 +398,14 @@ namespace eop
         void emplace_back(Args&& ...args)
         {
             should_reallocate();
-            std::construct_at(&data[num_of_elements++], std::forward<Args>(args)...);
+            if constexpr (std::is_trivially_destructible_v<T>)
+            {
+                std::construct_at(&data[num_of_elements++], std::forward<Args>(args)...);
+            }
+            else // the slots after size() hold default constructed elements.
+            {
+                data[num_of_elements++] = T(std::forward<Args>(args)...);
+            }
         }
 
 
@@ -403,23 +467,27 @@ namespace eop
 
         void copy_from(const Vector& other)
         {
+            if (this == &other)
+            {
+                return;
+            }
             num_of_elements = other.num_of_elements;
-            max_capacity = other.max_capacity;
+            max_capacity = other.num_of_elements;
             data = std::make_unique<T[]>(num_of_elements);
-            std::uninitialized_copy_n(other.data.get(), num_of_elements, data.get());
+            std::copy_n(other.data.get(), num_of_elements, data.get());
         }
 
         void move_from(Vector& other)
         {
-            num_of_elements = other.num_of_elements;
-            max_capacity = other.max_capacity;
+            num_of_elements = std::exchange(other.num_of_elements, 0);
+            max_capacity = std::exchange(other.max_capacity, 0);
             data = std::move(other.data);
         }
 
 
         // Reallocate if necessary.
         // If the type is trivially copyable, just do a memcpy.
-        void should_reallocate() requires std::is_trivially_copyable_v<T>
+        void should_reallocate()
         {
             if (num_of_elements < max_capacity) [[likely]]
             {
@@ -444,19 +512,21 @@ namespace eop
 
 
         // Precondition: new_data has capacity >= size.
+        // The elements of new_data are already constructed by make_unique: they are assigned.
         void move_to(const std::unique_ptr<T[]>& new_data)
         {
             if constexpr (std::is_trivially_copyable_v<T>)
             {
-                std::memcpy(new_data.get(), data.get(), sizeof(T) * num_of_elements);
+                // data is null before the first allocation, memcpy doesn't accept it even for 0 bytes.
+                if (num_of_elements != 0) std::memcpy(new_data.get(), data.get(), sizeof(T) * num_of_elements);
             }
             else if constexpr (movable<T>)
             {
-                std::uninitialized_move_n(data.get(), num_of_elements, new_data.get());
+                std::move(data.get(), data.get() + num_of_elements, new_data.get());
             }
             else // do a copy
             {
-                std::uninitialized_copy_n(data.get(), num_of_elements, new_data.get());
+                std::copy_n(data.get(), num_of_elements, new_data.get());
             }
         }
 
@@ -0,0 +1,314 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+/*
+work_stealing_pool.hpp
+
+PURPOSE: fork-join parallelism on a fixed set of threads.
+
+CLASSES:
+    WorkStealingPool:   worker threads with a deque of tasks each, invoke(f, g) runs f and g in parallel.
+
+FUNCTIONS:
+    default_pool:       the pool of std::thread::hardware_concurrency() threads of the process.
+
+DESCRIPTION:
+invoke(f, g) called by a worker pushes g at the back of its deque, calls f, then joins g: if g
+is still at the back of the deque (nobody stole it) it is popped and called by the same worker,
+else the worker steals and runs other tasks until the thief has finished g. The owner of a deque
+works at the back (last in, first out: the smallest and most recent tasks, hot in the cache), the
+thieves take from the front (the oldest, largest tasks), so a few steals distribute a recursion.
+The joins are nested like the calls: at the join of g, g is at the back of the deque or it has been
+stolen, the tasks are on the stack of the invoke.
+
+invoke called by a thread outside the pool submits the whole call to the pool and waits.
+An exception thrown by f or g is rethrown by invoke, after g has finished.
+
+The deques are protected by a mutex: a task costs a lock and an unlock, the tasks must be coarse
+(parallel_bifurcate.hpp stops forking at a grain depth). The idle workers sleep on a condition
+variable until a task is pushed. A thread outside the pool waits for its call on a condition
+variable of the pool, not of the task: the task is on the stack of the waiter and may be destroyed
+as soon as it is finished, so the worker doesn't touch it after setting it finished.
+
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace eop
+{
+    class WorkStealingPool
+    {
+    public:
+        // Precondition: threads > 0
+        explicit WorkStealingPool(std::size_t threads = default_threads()) : queues(threads)
+        {
+            workers.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i)
+            {
+                queues[i] = std::make_unique<queue>();
+            }
+            for (std::size_t i = 0; i < threads; ++i)
+            {
+                workers.emplace_back([this, i]() { run(i); });
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        ~WorkStealingPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                stop = true;
+            }
+            wake.notify_all();
+            for (std::thread& w : workers) w.join();
+        }
+
+
+        [[nodiscard]]
+        std::size_t number_of_threads() const noexcept
+        {
+            return workers.size();
+        }
+
+        [[nodiscard]]
+        static std::size_t default_threads() noexcept
+        {
+            std::size_t n = std::thread::hardware_concurrency();
+            return n == 0 ? 1 : n;
+        }
+
+
+        // Calls f() and g(), maybe in parallel, and returns when both have returned.
+        template <typename F, typename G>
+        void invoke(F&& f, G&& g)
+        {
+            if (current == nullptr || current->pool != this)
+            {
+                // From outside the pool: the pair is a task of the pool.
+                auto both = [&]() { invoke(f, g); };
+                task t(both);
+                push(injected, t);
+                wait(t);
+                t.rethrow();
+                return;
+            }
+
+            worker& self = *current;
+            task t(g);
+            push(*queues[self.index], t);
+            std::exception_ptr error;
+            try
+            {
+                f();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            if (pop_back(*queues[self.index], t))
+            {
+                execute(t);
+            }
+            else
+            {
+                while (!t.finished())
+                {
+                    task* other = steal(self.index);
+                    if (other != nullptr) execute(*other);
+                    else std::this_thread::yield();
+                }
+            }
+            if (error) std::rethrow_exception(error);
+            t.rethrow();
+        }
+
+    private:
+        // A call waiting in a deque, on the stack of the invoke that pushed it.
+        class task
+        {
+        public:
+            template <typename F>
+            explicit task(F& f)
+                : object(const_cast<void*>(static_cast<const void*>(&f))), call([](void* p) { (*static_cast<F*>(p))(); })
+            {
+
+            }
+
+            void run() noexcept
+            {
+                try
+                {
+                    call(object);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+            }
+
+            // The last access to the task by the thread that ran it.
+            void finish() noexcept
+            {
+                done.store(true, std::memory_order_release);
+            }
+
+            [[nodiscard]]
+            bool finished() const noexcept
+            {
+                return done.load(std::memory_order_acquire);
+            }
+
+            void rethrow() const
+            {
+                if (error) std::rethrow_exception(error);
+            }
+
+        private:
+            void* object;
+            void (*call)(void*);
+            std::exception_ptr error;
+            std::atomic<bool> done = false;
+        };
+
+
+        struct queue
+        {
+            std::mutex mutex;
+            std::deque<task*> tasks;
+        };
+
+
+        struct worker
+        {
+            WorkStealingPool* pool;
+            std::size_t index;
+        };
+
+
+        // The joiner may destroy t as soon as it is finished: the wakeup is on the pool.
+        void execute(task& t) noexcept
+        {
+            t.run();
+            {
+                std::lock_guard<std::mutex> lock(join_mutex);
+                t.finish();
+            }
+            joined.notify_all();
+        }
+
+        void wait(const task& t)
+        {
+            std::unique_lock<std::mutex> lock(join_mutex);
+            joined.wait(lock, [&t]() { return t.finished(); });
+        }
+
+
+        void push(queue& q, task& t)
+        {
+            {
+                std::lock_guard<std::mutex> lock(q.mutex);
+                q.tasks.push_back(&t);
+            }
+            pending.fetch_add(1);
+            // Sequentially consistent with run: either the sleeper sees pending or the pusher sees sleeping.
+            if (sleeping.load() > 0)
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                wake.notify_one();
+            }
+        }
+
+        // Pops t if it's at the back of q.
+        bool pop_back(queue& q, task& t)
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty() || q.tasks.back() != &t) return false;
+            q.tasks.pop_back();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        task* pop_front(queue& q)
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) return nullptr;
+            task* t = q.tasks.front();
+            q.tasks.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return t;
+        }
+
+        // The oldest task of the other workers, starting after i, then of the threads outside the pool.
+        task* steal(std::size_t i)
+        {
+            std::size_t n = queues.size();
+            for (std::size_t k = 1; k < n; ++k)
+            {
+                task* t = pop_front(*queues[(i + k) % n]);
+                if (t != nullptr) return t;
+            }
+            return pop_front(injected);
+        }
+
+
+        void run(std::size_t i)
+        {
+            worker self{this, i};
+            current = &self;
+            while (true)
+            {
+                task* t = steal(i);
+                if (t != nullptr)
+                {
+                    execute(*t);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                sleeping.fetch_add(1);
+                wake.wait(lock, [this]() { return stop || pending.load() > 0; });
+                sleeping.fetch_sub(1);
+                if (stop) break;
+            }
+            current = nullptr;
+        }
+
+
+        static inline thread_local worker* current = nullptr;
+
+        std::vector<std::unique_ptr<queue>> queues;
+        queue injected;
+        std::vector<std::thread> workers;
+
+        std::atomic<std::size_t> pending = 0;
+        std::atomic<std::size_t> sleeping = 0;
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        bool stop = false;
+
+        std::mutex join_mutex;
+        std::condition_variable joined;
+    };
+
+
+    inline
+    WorkStealingPool& default_pool()
+    {
+        static WorkStealingPool pool;
+        return pool;
+    }
+} // namespace eop
+
+
+#endif